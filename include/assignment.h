@@ -0,0 +1,86 @@
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+#include <cstdint>
+#include <vector>
+
+// --- AFFECTATION OPTIMALE (ALGORITHME DES ENCHÈRES) ---
+// Problème : n "personnes" (les incidents) et n "objets" (les véhicules), un gain
+// benefit[i*n + j] si la personne i reçoit l'objet j. On cherche l'affectation
+// (chacun reçoit un objet différent) qui rend la somme des gains maximale.
+//
+// Principe (Bertsekas) : chaque objet a un prix. Une personne sans objet "enchérit"
+// sur l'objet qui lui rapporte le plus (gain - prix) et augmente son prix de l'écart
+// avec son deuxième choix (+ epsilon). L'ancien propriétaire se retrouve sans objet
+// et enchérit à son tour. Avec des gains entiers multipliés par une échelle plus grande
+// que n (ScaleFor) et epsilon = 1 à la fin, le résultat est optimal.
+//
+// Incrémental, à deux niveaux :
+//  - Solve à chaud : les prix ET les affectations du calcul précédent sont gardés (warm start),
+//    seules les personnes dont l'objet n'est plus un bon choix enchérissent. Chaque phase
+//    (epsilon divisé par 8) revérifie quand même toutes les personnes.
+//  - Update : même problème, on sait quelles lignes et colonnes ont changé. On ne regarde que
+//    celles-là, directement à epsilon = 1 : le coût suit le nombre de changements.
+class AuctionSolver {
+public:
+    static const int64_t MIN_SCALE = 1024; // Échelle des gains pour n < 1024
+
+    // Échelle des gains d'un problème n x n : au moins MIN_SCALE, puissance de deux plus grande
+    // que n (l'affectation finale, à epsilon = 1, est alors optimale)
+    static int64_t ScaleFor(int n);
+
+    // benefit : gains (non multipliés) de taille n*n, ligne = personne.
+    // prices : prix de départ des n objets (à l'échelle ScaleFor(n)), mis à jour à la fin.
+    // warm = true : on part des prix donnés et des affectations données dans personObject
+    // (-1 : aucune), avec un epsilon moyen (8 x l'échelle) au lieu du grand epsilon à froid.
+    // personObject[i] = objet reçu par la personne i (en sortie : affectation optimale complète).
+    // En sortie, le plus petit prix vaut 0 (tous décalés d'autant).
+    void Solve(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+               std::vector<int>& personObject, bool warm);
+
+    // Recalcul après un Solve (ou un Update) sur le même problème, dont seuls les gains des
+    // lignes "rows" et des colonnes "columns" ont changé (listes sans doublon). prices et
+    // personObject sont ceux rendus par ce solveur au calcul précédent, sans retouche.
+    // Seules les colonnes changées sont reprisées et seules les personnes touchées (ligne
+    // changée, ou objet dont la colonne a changé et qui n'est plus un bon choix) enchérissent :
+    // le coût suit ce qui a changé, pas n x n.
+    void Update(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                std::vector<int>& personObject, const std::vector<int>& rows, const std::vector<int>& columns);
+
+    long long LastBids() const { return bids; } // Nombre d'enchères du dernier calcul
+
+private:
+    static const int UPDATE_BID_LIMIT = 32; // Update : enchères (x n) à epsilon = 1 avant de repasser par les phases
+    int64_t scale = MIN_SCALE;    // Échelle du dernier calcul
+    std::vector<int> objectOwner; // Personne qui possède l'objet j (-1 : personne)
+    std::vector<int> waiting;     // Personnes sans objet (pile)
+    std::vector<int64_t> personValue; // Update : gain - prix de l'objet de chaque personne gardée
+    std::vector<uint8_t> touched;     // Update : 1 = personne dans "bidders"
+    std::vector<int> bidders;         // Update : personnes revérifiées à chaque phase
+    std::vector<int64_t> columnPrice; // Update : nouveau prix de chaque colonne changée
+    std::vector<uint8_t> columnChanged; // Update : 1 = colonne changée
+    long long bids = 0;
+
+    // Liste courte de chaque personne : ses meilleurs objets au dernier parcours complet de sa
+    // ligne, et la plus grande valeur possible des autres (une enchère coûte alors SHORTLIST
+    // calculs au lieu de n, tant que les prix ne l'ont pas trop changée)
+    static const int SHORTLIST = 4;
+    std::vector<int> shortObjects;    // n x SHORTLIST
+    std::vector<int64_t> shortBenefit; // Leurs gains (x l'échelle), à côté : pas de saut dans la matrice
+    std::vector<int64_t> shortBound;  // Valeur maximale des objets hors de la liste
+    std::vector<uint8_t> shortValid;  // 0 : liste à refaire
+
+    void Prepare(int n);
+    void BestObjects(int i, int n, const std::vector<int64_t>& benefit, const std::vector<int64_t>& prices,
+                     int& best, int64_t& bestValue, int64_t& secondValue);
+
+    void RunPhase(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                  std::vector<int>& personObject, int64_t eps);
+    void LowerPrices(int n, std::vector<int64_t>& prices);
+    void RecheckBidders(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                        std::vector<int>& personObject, int64_t eps);
+    bool RunAuction(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                    std::vector<int>& personObject, int64_t eps, bool track, long long limit);
+};
+
+#endif
@@ -3,8 +3,14 @@
 
 // --- BIBLIOTHÈQUES ---
 // On inclut les outils nécessaires (Raylib pour l'affichage, Maths pour les calculs)
+// Seul le programme fenêtré définit SMARTCITY_WITH_RAYLIB. Le cœur de la simulation
+// (smartcity_core) et le programme "headless" utilisent des types compatibles sans Raylib.
+#ifdef SMARTCITY_WITH_RAYLIB
 #include "raylib.h"
 #include "raymath.h"
+#else
+#include "sim_math.h"
+#endif
 #include <vector>
 #include <cmath>
 #include <string>
@@ -25,6 +31,11 @@ const float LANE_EMERGENCY = 6.0f;      // Voie centrale (prioritaire)
 
 const float TARGET_BLOCK_SIZE = 220.0f; // Taille idéale d'un pâté de maisons
 
+// --- TEMPS DE SIMULATION ---
+const float SIM_DT = 1.0f / 60.0f; // Durée d'un "tick" fixe (les vitesses sont en pixels par tick)
+const int MAX_CIVILIANS = 35;      // Nombre maximum de voitures civiles en même temps
+const int DEFAULT_VEHICLE_CAPACITY = 4096; // Place réservée d'avance pour les véhicules
+
 // --- COULEURS ---
 // Définition de nos propres couleurs pour rendre le code plus lisible
 #define COLOR_GRASS       (Color){ 34, 139, 34, 255 }   // Vert gazon
@@ -39,17 +50,17 @@ const float TARGET_BLOCK_SIZE = 220.0f; // Taille idéale d'un pâté de maisons
 enum GameState { MENU, GAME };
 
 // Directions possibles pour les voitures
-enum Dir { UP, DOWN, LEFT, RIGHT, NONE }; 
+enum Dir : unsigned char { UP, DOWN, LEFT, RIGHT, NONE }; 
 
 // Types d'unités (Voitures ou Bâtiments)
-enum Type { CIVIL, POLICE, AMBULANCE, FIRE };
+enum Type : unsigned char { CIVIL, POLICE, AMBULANCE, FIRE };
 
 // Cycles des feux tricolores (Vert Vertical, Jaune Vertical, etc.)
 enum LightCycle { V_GREEN, V_YELLOW, H_GREEN, H_YELLOW };
 
 // Cerveau des urgences : Que fait le véhicule de secours ?
 // (Repos, Sort du garage, En mission, Éteint le feu, Soigne, Retourne, Rentre au garage)
-enum EmergencyState { IDLE, DEPLOYING, ON_MISSION, EXTINGUISHING, TREATING, RETURNING, DOCKING };
+enum EmergencyState : unsigned char { IDLE, DEPLOYING, ON_MISSION, EXTINGUISHING, TREATING, RETURNING, DOCKING };
 
 // --- STRUCTURES (OBJETS) ---
 
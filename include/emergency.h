@@ -0,0 +1,229 @@
+#ifndef EMERGENCY_H
+#define EMERGENCY_H
+
+#include "config.h"
+#include "vehicle_store.h"
+#include "assignment.h"
+#include <cstdint>
+#include <queue>
+
+class Simulation;
+class StateWriter;
+class StateReader;
+
+// --- INCIDENTS ---
+// Plusieurs incidents de plusieurs types peuvent exister en même temps.
+// Chaque type est pris en charge par un métier de secours (voir ResponderFor).
+enum IncidentType : unsigned char {
+    INCIDENT_FIRE,      // Incendie (dans un pâté de maisons) -> pompiers
+    INCIDENT_ACCIDENT,  // Accident de la route (carrefour)   -> ambulance
+    INCIDENT_CRIME,     // Vol, agression (sur une route)     -> police
+    INCIDENT_TYPE_COUNT
+};
+
+enum IncidentState : unsigned char {
+    INCIDENT_WAITING,   // Signalé, dans la file du répartiteur
+    INCIDENT_ASSIGNED,  // Un véhicule est en route
+    INCIDENT_ON_SCENE,  // Le véhicule est sur place et travaille
+    INCIDENT_RESOLVED   // Terminé : retiré de la table à la fin du pas
+};
+
+const int MAX_OPEN_INCIDENTS = 256; // Au-delà, plus aucun nouvel incident n'est signalé
+
+// Incidents par heure de la ville (multipliés par Simulation::incidentRate, voir load_generator.h) :
+// les anciennes chances de 3, 3 et 2 pour 1000 à chaque pas, à 60 pas par seconde
+const float FIRES_PER_HOUR = 648.0f;
+const float ACCIDENTS_PER_HOUR = 648.0f;
+const float CRIMES_PER_HOUR = 432.0f;
+
+const float CRIME_WORK_TIME = 2.0f; // Temps sur place (s) ; incendie et accident : 3 s
+
+// --- AFFECTATION OPTIMALE : GAINS (en pas de simulation de trajet) ---
+const int REOPTIMIZE_PERIOD = 30;       // Nouveau calcul au moins toutes les 0,5 s (véhicules qui bougent)
+const int64_t SERVE_VALUE = 100000;     // Servir un incident vaut plus que n'importe quel trajet
+const int64_t PRIORITY_VALUE = 3600;    // Un niveau de priorité vaut une minute de trajet en plus
+const int64_t STICKY_VALUE = 120;       // Garder son véhicule actuel (évite les demi-tours pour 2 s gagnées)
+const float UNIT_STEP = 4.0f;           // Distance parcourue par un secours en un pas (vitesse max)
+
+// Le métier qui répond à ce type d'incident
+Type ResponderFor(IncidentType type);
+// Temps de travail sur place (s)
+float WorkTimeFor(IncidentType type);
+// Distance à partir de laquelle le véhicule est "sur place"
+float ArrivalRadiusFor(IncidentType type);
+
+struct Incident {
+    uint32_t id;              // Numéro unique (jamais réutilisé)
+    IncidentType type;
+    IncidentState state;
+    int priority;             // 1 = peut attendre ... 3 = urgent
+    Vector2 pos;              // Lieu de l'incident
+    VehicleHandle unit;       // Véhicule envoyé (INVALID_VEHICLE si aucun)
+    long long reportedTick;   // Pas où l'incident a été signalé
+    long long dispatchedTick; // Pas où un véhicule a été envoyé (-1 : pas encore)
+    long long arrivedTick;    // Pas où le véhicule est arrivé (-1 : pas encore)
+};
+
+// --- TABLE DES INCIDENTS ---
+// Les incidents ouverts gardent leur case (slot) jusqu'à leur fermeture : un véhicule
+// retient la case de son incident (VehicleStore::incident). Les cases libérées sont
+// réutilisées, mais un véhicule reconnaît que ce n'est plus "son" incident grâce à la poignée.
+class IncidentTable {
+public:
+    IncidentTable() : nextId(1), openCount(0) {}
+
+    // Ouvre un incident et renvoie sa case
+    int Open(IncidentType type, Vector2 pos, int priority, long long tick);
+    // Ferme l'incident de la case "slot" (la case pourra resservir)
+    void Close(int slot);
+    void Clear();
+
+    int SlotCount() const { return (int)slots.size(); } // Cases utilisées ou libres
+    int OpenCount() const { return openCount; }
+    bool IsOpen(int slot) const { return slot >= 0 && slot < (int)slots.size() && used[slot]; }
+    Incident& At(int slot) { return slots[slot]; }
+    const Incident& At(int slot) const { return slots[slot]; }
+
+    // Y a-t-il déjà un incident ouvert de ce type à moins de "radius" de pos ?
+    bool OpenNear(IncidentType type, Vector2 pos, float radius) const;
+
+    // L'incident confié au véhicule de la case "vehicle", ou nullptr (aucun, ou fermé depuis).
+    // Appelé pendant la mise à jour des voitures : chaque incident n'a qu'un véhicule,
+    // donc un seul thread y touche.
+    Incident* AssignedTo(const VehicleStore& vehicles, int vehicle);
+
+    // Sauvegarde : toutes les cases (ouvertes ou libres), dans le même ordre
+    void Save(StateWriter& out) const;
+    bool Load(StateReader& in);
+
+private:
+    std::vector<Incident> slots;
+    std::vector<uint8_t> used;   // 1 = case occupée par un incident ouvert
+    std::vector<int> freeSlots;  // Cases libres (pile)
+    uint32_t nextId;
+    int openCount;
+};
+
+// --- RÉPARTITEUR (DISPATCH) ---
+// Les incidents en attente sont rangés dans une file de priorité : le plus urgent d'abord,
+// puis le plus ancien.
+// - Mode optimal (par défaut) : pour chaque métier, on résout l'affectation de TOUS les
+//   véhicules disponibles (qui rentrent, en route vers un incident pas encore atteint, ou
+//   encore au garage) à TOUS les incidents pas encore atteints, en maximisant la somme des
+//   gains (SERVE_VALUE + priorité - temps de trajet estimé). Un véhicule en route peut ainsi
+//   être détourné vers un incident plus urgent ou plus proche. Nouveau calcul à chaque nouvel
+//   incident et au moins toutes les REOPTIMIZE_PERIOD pas ; les prix des enchères, les
+//   affectations en cours et la matrice des gains sont repris d'un calcul à l'autre (incrémental).
+// - Mode glouton (optimize = false) : chaque incident, dans l'ordre de la file, prend le
+//   véhicule libre le plus proche à vol d'oiseau et le garde.
+// Dans les deux cas, un nouveau véhicule ne sort que si son bâtiment a moins de
+// unitsPerStation véhicules dehors.
+class Dispatcher {
+public:
+    int unitsPerStation; // Taille de la flotte de chaque bâtiment (sorties automatiques)
+    bool optimize;       // true = affectation optimale, false = glouton (pour comparer)
+
+    // --- STATISTIQUES ---
+    long long reported;   // Incidents signalés
+    long long dispatched; // Véhicules envoyés (un incident peut être renvoyé si son véhicule disparaît)
+    long long resolved;   // Incidents terminés
+    long long firstDispatches; // Incidents qui ont reçu au moins un véhicule
+    long long waitTicks;  // Somme des attentes "signalé -> premier véhicule envoyé" (en pas)
+    long long redirected; // Véhicules détournés vers un autre incident par l'optimisation
+    long long responded;  // Incidents résolus (avec arrivée d'un véhicule)
+    long long responseTicks; // Somme des temps "signalé -> véhicule sur place" (en pas)
+    long long optimizerRuns;  // Calculs d'affectation
+    long long optimizerBids;  // Enchères au total (coût des calculs)
+    int peakOpen;         // Plus grand nombre d'incidents ouverts en même temps
+
+    Dispatcher();
+
+    void Clear();
+    int QueueLength() const { return (int)queue.size(); }
+    double AverageWaitSeconds(float dt = SIM_DT) const;     // Signalé -> premier envoi
+    double AverageResponseSeconds(float dt = SIM_DT) const; // Signalé -> sur place (ce qui compte pour la ville)
+
+    // Un nouvel incident (case "slot") entre dans la file
+    void Report(Simulation& sim, int slot);
+
+    // Envoie des véhicules vers les incidents en attente (début du pas, un seul thread)
+    void Dispatch(Simulation& sim);
+
+    // Un véhicule vient d'être créé à la main (bouton) : il prend l'incident en attente
+    // le plus urgent de son métier, s'il y en a un.
+    void OfferUnit(Simulation& sim, int vehicle);
+
+    // Fin du pas : ferme les incidents terminés et remet en file ceux dont le véhicule a disparu
+    void Collect(Simulation& sim);
+
+    // Sauvegarde : réglages, statistiques, file d'attente et prix des enchères (calcul "à chaud")
+    void Save(StateWriter& out) const;
+    bool Load(StateReader& in);
+
+private:
+    struct Entry {
+        int priority;
+        long long tick;
+        uint32_t id;
+        int slot;
+        // Le "plus grand" sort en premier : priorité haute, puis signalé le plus tôt
+        bool operator<(const Entry& o) const {
+            if (priority != o.priority) return priority < o.priority;
+            if (tick != o.tick) return tick > o.tick;
+            return id > o.id;
+        }
+    };
+    std::priority_queue<Entry> queue;
+    std::vector<Entry> deferred;                  // Sans véhicule libre ce pas-ci (tampon réutilisé)
+    std::vector<int> returning[4];                // Véhicules qui rentrent, par métier (tampon réutilisé)
+    std::vector<int> fleet;                       // Véhicules de chaque bâtiment (tampon réutilisé)
+    bool dirty;                                   // Nouvel incident ou véhicule libéré depuis le dernier calcul
+
+    // --- AFFECTATION OPTIMALE (tampons réutilisés) ---
+    struct Candidate {
+        int vehicle;  // Case du véhicule, ou -1 pour un véhicule qui sortirait du bâtiment "station"
+        int station;
+        Vector2 pos;  // D'où il part
+        int delay;    // Pas avant de prendre la route (sortie du garage)
+        uint64_t key; // Identifiant stable (pour retrouver son prix au calcul suivant)
+    };
+    struct PriceMemory {
+        std::vector<std::pair<uint64_t, int64_t>> prices; // (clé, prix), triés par clé
+        bool valid = false;
+    };
+    // Matrice des gains du dernier calcul d'un métier : si les incidents et les candidats sont
+    // les mêmes (dans le même ordre), on ne recalcule que les lignes dont le véhicule actuel a
+    // changé et les colonnes des véhicules qui ont bougé, et le solveur du métier ne reprend
+    // que celles-là (AuctionSolver::Update). Sauvegardée : la partie rechargée refait les mêmes calculs.
+    struct BenefitCache {
+        int n = 0;                          // 0 : matrice à refaire entièrement
+        int incidentCount = 0, unitCount = 0;
+        std::vector<uint32_t> rowIds;       // Incident de chaque ligne
+        std::vector<int> rowCurrent;        // Son véhicule actuel (bonus STICKY_VALUE), -1 : aucun
+        std::vector<uint64_t> columnKeys;   // Candidat de chaque colonne
+        std::vector<Vector2> columnPos;
+        std::vector<int> columnDelay;
+        std::vector<int64_t> benefit;
+        std::vector<int> match;             // Affectation rendue par le solveur (lignes fictives comprises)
+        AuctionSolver solver;               // Ses listes courtes suivent cette matrice (pas sauvegardé)
+    };
+    PriceMemory memory[4];              // Prix du dernier calcul, par métier
+    BenefitCache benefitCache[4];       // Gains du dernier calcul, par métier
+    std::vector<int> problemIncidents;  // Cases des incidents du problème
+    std::vector<Candidate> candidates;  // Véhicules du problème
+    std::vector<uint8_t> rowChanged;    // Lignes recalculées en entier (tampon réutilisé)
+    std::vector<int> changedRows, changedColumns; // Ce qui a changé depuis le calcul précédent
+    std::vector<int> columnOf;          // Colonne de chaque véhicule candidat, -1 sinon (tampon réutilisé)
+    std::vector<int64_t> prices;
+    std::vector<uint64_t> objectKeys;
+    std::vector<int> detached;          // Véhicules retirés de leur incident
+
+    void Assign(Simulation& sim, int vehicle, int slot);
+    bool IsWaiting(const Simulation& sim, const Entry& e) const;
+    void CountFleet(const Simulation& sim);
+    void DispatchGreedy(Simulation& sim);
+    void Optimize(Simulation& sim, Type type);
+    void RebuildQueue(const Simulation& sim);
+};
+
+#endif
@@ -3,7 +3,7 @@
 
 // On inclut les fichiers dont on a besoin ici
 #include "config.h"
-#include "vehicle.h"
+#include "sim_thread.h"
 
 // --- VARIABLES PARTAGÉES (GLOBALES) ---
 // Le mot "extern" dit au programme : "Ces variables existent déjà dans un autre fichier (world.cpp),
@@ -11,6 +11,7 @@
 
 extern GameState currentState; // Permet de savoir si on est dans le MENU ou dans le JEU
 extern bool isNight;           // Permet de savoir si c'est la nuit (pour allumer les phares)
+extern Camera2D cityCamera;    // La caméra sur la ville (déplacement et zoom)
 
 // --- FONCTIONS UTILITAIRES ---
 // Outils pour gérer l'interface graphique
@@ -18,7 +19,19 @@ extern bool isNight;           // Permet de savoir si c'est la nuit (pour allume
 // Dessine un bouton rectangulaire et renvoie "VRAI" (true) si le joueur clique dessus
 bool DrawButton(Rectangle rect, Color bgColor, Color textColor, const char* text);
 
-// Dessine une petite carte (radar) pour voir où sont les véhicules en global
-void DrawMiniMap(const std::vector<Car*>& cars);
+// Dessine une petite carte (radar) pour voir où sont les véhicules en global.
+// Le cadre blanc montre la partie visible ; un clic sur la carte y centre la caméra.
+void DrawMiniMap(const SimSnapshot& snap);
+
+// Mesures de performance (touche 'P', à la place de la mini-carte) : durée de chaque étape
+// du pas, compteurs, centiles des pas et des interventions. drawMs = durée du dessin de la ville.
+void DrawProfileOverlay(const SimSnapshot& snap, double drawMs, double drawP99Ms);
+
+// --- CAMÉRA ---
+// Molette = zoom vers la souris, clic droit (ou molette enfoncée) glissé = déplacement,
+// flèches = déplacement, 'R' = retour à la vue de départ. La souris sur la barre latérale est ignorée.
+void UpdateCityCamera();
+void ResetCityCamera();       // Vue de départ : la ville à zoom 1, comme la fenêtre
+Rectangle GetCameraView();    // Partie du monde visible à droite de la barre latérale
 
 #endif
\ No newline at end of file
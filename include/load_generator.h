@@ -0,0 +1,115 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include "random.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class StateWriter;
+class StateReader;
+
+// --- GÉNÉRATEUR DE CHARGE (ÉVÉNEMENTS DISCRETS) ---
+// Décide QUAND arrivent les incendies, les accidents, les vols et les nouveaux civils.
+// Au lieu de tirer une chance à chaque pas pour chaque type, on calcule directement la date
+// de la prochaine arrivée de chaque type et on la range dans une file de priorité : à chaque
+// pas, on ne regarde que le haut de la file (rien à faire tant que la date n'est pas atteinte).
+//
+// Chaque type a un taux (arrivées par heure de la ville) et un mode :
+// - POISSON : arrivées au hasard, écart moyen 1 / taux (comme de vrais appels au 18) ;
+// - RÉGULIER : exactement une arrivée tous les 1 / taux (l'ancienne apparition des civils).
+// Le taux peut suivre une courbe du trafic heure par heure (heures de pointe) : une arrivée
+// de Poisson est alors tirée au taux de la pire heure, puis gardée avec la probabilité
+// taux de l'heure / taux de la pire heure (méthode d'amincissement, "thinning").
+// Même graine + même profil = mêmes dates au bit près (flux de hasard STREAM_ARRIVAL).
+
+enum LoadKind {
+    LOAD_FIRE,
+    LOAD_ACCIDENT,
+    LOAD_CRIME,
+    LOAD_CIVILIAN,
+    LOAD_KIND_COUNT
+};
+
+enum ArrivalMode : uint8_t {
+    ARRIVAL_POISSON,
+    ARRIVAL_REGULAR
+};
+
+struct ArrivalRate {
+    double perHour;      // Arrivées par heure (civils : < 0 = Simulation::spawnRate)
+    ArrivalMode mode;
+    bool followsTraffic; // Multiplié par la courbe du trafic (civils et accidents)
+};
+
+// Profil de charge : taux de chaque type et courbe du trafic sur une journée.
+// Les taux des incidents sont encore multipliés par Simulation::incidentRate.
+struct LoadProfile {
+    ArrivalRate rates[LOAD_KIND_COUNT];
+    float traffic[24]; // Multiplicateur du trafic de chaque heure (1 = normal)
+    float startHour;   // Heure de la ville au pas 0 (l'horloge des courbes)
+};
+
+// Les fréquences habituelles (FIRES_PER_HOUR...), civils au rythme de spawnRate, trafic constant
+LoadProfile DefaultLoadProfile();
+
+// Profil décrit par une liste séparée par des virgules, lue de gauche à droite.
+// Ex : "rush-hour,fires=20" = heures de pointe + 20 incendies par heure.
+//   steady | rush-hour    profil de départ (trafic constant ou pointes à 8 h et 18 h,
+//                         rush-hour commence à 7 h)
+//   fires=N accidents=N crimes=N   incidents par heure
+//   civilians=R           civils qui arrivent par seconde (comme --spawn-rate)
+//   start=H               heure de la ville au départ
+//   poisson | regular     mode d'arrivée de tous les types
+// Renvoie false (et le morceau fautif dans "error") si la description est invalide.
+bool ParseLoadProfile(const char* spec, LoadProfile& profile, std::string& error);
+
+const char* LoadKindName(LoadKind kind);
+
+class LoadGenerator {
+public:
+    LoadProfile profile;
+    long long arrivals[LOAD_KIND_COUNT]; // Événements délivrés depuis le début
+
+    LoadGenerator();
+
+    // Change de profil : toutes les prochaines arrivées seront recalculées au prochain Retune
+    void SetProfile(const LoadProfile& p);
+    // Vide la file et remet les flux de hasard au début
+    void Seed(uint64_t seed);
+
+    // Taux de base de chaque type (arrivées par heure, avant la courbe du trafic), à donner à
+    // chaque pas : un type dont le taux a changé depuis le dernier appel est replanifié à
+    // partir de "now" (secondes de la ville). Quatre comparaisons quand rien ne change.
+    void Retune(double now, const double base[LOAD_KIND_COUNT]);
+
+    // Sort de la file le prochain événement dû au plus tard à "now" (le plus ancien d'abord)
+    // et planifie le suivant du même type. Renvoie false quand plus rien n'est dû.
+    bool Pop(double now, LoadKind& kind);
+
+    // Taux (par heure) du type "kind" à l'instant "time", courbe du trafic comprise
+    double RateAt(LoadKind kind, double time) const;
+    // Heure de la ville (0 à 24) à l'instant "time"
+    double HourAt(double time) const;
+
+    int Pending() const { return (int)queue.size(); }
+
+    void Save(StateWriter& out) const;
+    bool Load(StateReader& in);
+
+private:
+    struct Event {
+        double time;   // Date de l'arrivée (secondes de la ville)
+        LoadKind kind;
+    };
+    std::vector<Event> queue;              // Tas : le plus tôt en haut (au plus une date par type)
+    double base[LOAD_KIND_COUNT];          // Taux de base utilisés pour les dates de la file
+    Random timing[LOAD_KIND_COUNT];        // Hasard des dates (un flux par type)
+
+    static bool Later(const Event& a, const Event& b); // Ordre du tas
+    void Schedule(LoadKind kind, double from);
+    void Unschedule(LoadKind kind);
+    double Peak(LoadKind kind) const;      // Taux de la pire heure
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// --- FICHIER PROJETÉ EN MÉMOIRE (MMAP) ---
+// Le fichier est vu comme un simple tableau d'octets en lecture seule : rien n'est lu
+// d'avance, le système charge les pages au moment où on les touche. Sert à relire les
+// traces (trace.h) et les scénarios (scenario.h), même très gros, sans les recopier.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile(); // Ferme le fichier si besoin
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Renvoie false (et un message dans Error()) si le fichier est absent ou ne se projette pas.
+    // Un fichier vide s'ouvre (Size() = 0, Data() = nullptr).
+    bool Open(const char* path);
+    void Close();
+
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+    const std::string& Error() const { return error; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    void* mapping;     // Projection (Windows : poignée du "file mapping")
+    intptr_t file;     // Fichier ouvert (POSIX : descripteur, Windows : HANDLE), -1 si aucun
+    std::string error;
+};
+
+#endif
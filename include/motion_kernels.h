@@ -0,0 +1,55 @@
+#ifndef MOTION_KERNELS_H
+#define MOTION_KERNELS_H
+
+#include "config.h"
+#include <cstdint>
+
+// --- NOYAUX DE CALCUL PAR PAQUETS (SIMD) ---
+// Les calculs simples faits sur chaque voiture (vitesse, avance, maintien de la voie,
+// test capteur / carrosserie) sont les mêmes pour toutes : au lieu de les faire une voiture
+// à la fois, on en traite 4 (SSE2) ou 8 (AVX2) d'un coup sur les tableaux contigus du stockage.
+// Par défaut on prend SSE2 : sur un pas complet (benchmark sim_step/N/K), AVX2 s'est montré
+// plus lent que SSE2 malgré un mouvement plus rapide seul. SetKernelLevel pour forcer un niveau.
+// Les trois versions font les mêmes opérations dans le même ordre (pas de FMA) :
+// le résultat est identique au bit près, la partie rejoue la même chose sur toutes les machines.
+
+enum KernelLevel {
+    KERNEL_SCALAR, // Une voiture à la fois (toutes les machines)
+    KERNEL_SSE2,   // 4 voitures à la fois (tous les processeurs x86-64)
+    KERNEL_AVX2    // 8 voitures à la fois
+};
+
+// Ce que le processeur sait faire, et le niveau pris au lancement (jamais au-dessus)
+KernelLevel BestKernelLevel();
+KernelLevel DefaultKernelLevel();
+KernelLevel ActiveKernelLevel();
+// Choisit les noyaux (jamais au-dessus de BestKernelLevel) et renvoie le niveau retenu.
+// À appeler avant de lancer la simulation (pas pendant un pas).
+KernelLevel SetKernelLevel(KernelLevel level);
+const char* KernelLevelName(KernelLevel level);
+// "scalar", "sse2" ou "avx2" ; renvoie false si le nom est inconnu
+bool ParseKernelLevel(const char* name, KernelLevel& level);
+
+// Ce que la décision (PlanVehicle) demande au mouvement, voiture par voiture
+enum MotionFlag : uint8_t {
+    MOTION_SKIP = 1       // Ne bouge pas ce pas (intervention, garage, voiture inactive)
+};
+
+// Mouvement de "count" voitures qui se suivent dans les tableaux :
+//   vitesse  : desired < 0 -> freinage (Lerp vers 0 à 0.3, arrêt sous 0.05),
+//              sinon Lerp vers desired à 0.05 ;
+//   position : avance de la nouvelle vitesse selon dir, puis aimantation (Lerp à 0.15)
+//              vers "lane" sur l'axe en travers (x pour UP / DOWN, y sinon).
+// Les voitures MOTION_SKIP ne changent pas. outside[k] = 1 si la voiture k finit hors de "city".
+void IntegrateMotion(Vector2* pos, float* speed, const Dir* dir, const float* desired, const float* lane,
+                     const uint8_t* flags, int count, Rectangle city, uint8_t* outside);
+
+// Capteur contre plusieurs voitures : le bit k du résultat vaut 1 si le rectangle de la
+// voiture ids[k] (GetCarRect(pos[ids[k]], dir[ids[k]])) touche "sensor". count <= SENSOR_BATCH.
+// En dessous de SENSOR_SIMD_MIN voitures, le test est fait une voiture à la fois quel que soit
+// le niveau choisi (mesuré avec le benchmark overlap_sensor/C/K).
+const int SENSOR_BATCH = 32;
+const int SENSOR_SIMD_MIN = 6;
+uint32_t OverlapSensor(Rectangle sensor, const Vector2* pos, const Dir* dir, const int* ids, int count);
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+
+// --- MESURES DE PERFORMANCE (PROFILER) ---
+// Chronomètres par étape du pas de simulation, compteurs (tests de collision, voitures
+// qui se rangent, freinages d'urgence) et histogrammes des durées (pas, trajets des
+// secours, temps sur place). Coût : deux lectures d'horloge par étape et par pas,
+// aucune allocation, aucune opération atomique dans la boucle des voitures.
+
+// Étapes chronométrées (dans l'ordre de Simulation::Step)
+enum ProfilePhase {
+    PHASE_LIGHTS,     // Feux des carrefours
+    PHASE_INCIDENTS,  // Génération des incidents
+    PHASE_DISPATCH,   // Répartiteur (affectation des secours)
+    PHASE_SPAWN,      // Apparition des civils
+    PHASE_GRID,       // Grille spatiale et zones où laisser passer
+    PHASE_ROUTES,     // Itinéraires A* des secours
+    PHASE_CARS,       // UpdateVehicle de toutes les voitures (collisions comprises)
+    PHASE_CLEANUP,    // Suppression des voitures inactives, fermeture des incidents
+    PHASE_PUBLISH,    // Photo pour l'affichage (programme fenêtré) et copie pour la trace (--record)
+    PHASE_COUNT
+};
+
+// Compteurs (somme sur toutes les voitures)
+enum ProfileCounter {
+    COUNTER_COLLISION_TESTS, // Rectangles comparés par l'anti-collision
+    COUNTER_YIELDS,          // Voitures rangées pour laisser passer un secours (par pas)
+    COUNTER_HARD_STOPS,      // Freinages d'urgence (par pas)
+    COUNTER_COUNT
+};
+
+const char* ProfilePhaseName(ProfilePhase phase);
+const char* ProfileCounterName(ProfileCounter counter);
+
+// Compteurs d'un paquet de voitures : chaque tâche a les siens, additionnés après la boucle.
+// Une ligne de cache chacun : deux threads n'écrivent jamais sur la même ligne.
+struct alignas(64) CarCounters {
+    long long values[COUNTER_COUNT] = {};
+};
+
+// --- HISTOGRAMME DE DURÉES ---
+// Cases de largeur logarithmique : SUB_BUCKETS cases par doublement (précision ~19 %),
+// à partir de "smallest" secondes. Les valeurs plus petites vont dans la première case,
+// les plus grandes dans la dernière.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKETS = 4;
+    static const int BUCKETS = 128; // 32 doublements : de 1 µs à plus d'une heure
+
+    explicit LatencyHistogram(double smallest = 1e-6);
+
+    void Record(double seconds);
+    void Clear();
+
+    long long Count() const { return count; }
+    double Mean() const { return count ? sum / count : 0.0; }
+    double Max() const { return max; }
+    // Valeur sous laquelle se trouve la fraction "p" (0..1) des mesures (haut de la case)
+    double Percentile(double p) const;
+
+    int BucketCount() const { return BUCKETS; }
+    long long BucketAt(int k) const { return buckets[k]; }
+    double BucketLow(int k) const;  // Bornes de la case k (secondes)
+    double BucketHigh(int k) const;
+
+private:
+    double smallest;
+    long long buckets[BUCKETS];
+    long long count;
+    double sum;
+    double max;
+};
+
+// --- TOTAUX DEPUIS LE DÉBUT ---
+// Copiables tels quels : l'écart entre deux copies donne les chiffres d'un intervalle.
+struct ProfileTotals {
+    long long ticks = 0;
+    double seconds[PHASE_COUNT] = {};
+    long long counts[COUNTER_COUNT] = {};
+};
+
+// --- RÉSUMÉ POUR L'AFFICHAGE ---
+// Moyennes glissantes (les dernières secondes) et quelques centiles : taille fixe,
+// recopié dans chaque photo sans allocation.
+struct ProfileSummary {
+    double phaseMs[PHASE_COUNT] = {};        // ms par pas
+    double counterPerTick[COUNTER_COUNT] = {};
+    double tickMs = 0;                        // Pas complet (moyenne glissante)
+    double tickP50Ms = 0, tickP99Ms = 0, tickMaxMs = 0;
+    double travelP50 = 0, travelP90 = 0;      // Envoi -> arrivée (s)
+    double extinguishP50 = 0;                 // Temps sur place des pompiers (s)
+    double treatP50 = 0;                      // Temps sur place ambulance et police (s)
+    long long responses = 0;                  // Arrivées mesurées
+};
+
+class Profiler {
+public:
+    bool enabled; // false = plus aucune lecture d'horloge (les compteurs restent)
+
+    // Histogrammes (secondes)
+    LatencyHistogram tickTime;       // Durée réelle d'un pas complet
+    LatencyHistogram travelTime;     // Incident : véhicule envoyé -> sur place (temps simulé)
+    LatencyHistogram extinguishTime; // Pompiers : sur place -> feu éteint (EXTINGUISHING)
+    LatencyHistogram treatTime;      // Ambulance, police : sur place -> terminé (TREATING)
+
+    Profiler();
+
+    void Clear();
+
+    // Début et fin d'un pas (chronomètre du pas complet, moyennes glissantes)
+    void BeginTick();
+    void EndTick();
+
+    // Ajoute la durée d'une étape (en secondes) au pas en cours
+    void AddPhase(ProfilePhase phase, double seconds) { current.seconds[phase] += seconds; }
+    void AddCounters(const CarCounters& c);
+
+    const ProfileTotals& Totals() const { return totals; }
+    void FillSummary(ProfileSummary& summary) const;
+
+    static double Now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    ProfileTotals totals;   // Depuis le début
+    ProfileTotals current;  // Pas en cours (versé dans les totaux et remis à zéro par EndTick)
+    double tickStart;
+    double recentPhase[PHASE_COUNT];     // Moyennes glissantes (secondes par pas)
+    double recentCounter[COUNTER_COUNT];
+    double recentTick;
+};
+
+// --- CHRONOMÈTRE D'UNE ÉTAPE ---
+// { ProfileScope scope(profiler, PHASE_CARS); ... } : la durée du bloc est ajoutée à l'étape.
+class ProfileScope {
+public:
+    ProfileScope(Profiler& p, ProfilePhase ph) : profiler(p), phase(ph), start(p.enabled ? Profiler::Now() : 0) {}
+    ~ProfileScope() { if (profiler.enabled) profiler.AddPhase(phase, Profiler::Now() - start); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler& profiler;
+    ProfilePhase phase;
+    double start;
+};
+
+#endif
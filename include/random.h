@@ -0,0 +1,57 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// --- FLUX DE HASARD INDÉPENDANTS ---
+// Chaque usage du hasard a son propre flux : tirer un nombre de plus pour les feux
+// ne décale pas les apparitions de voitures, et inversement.
+enum RandomStream : uint32_t {
+    STREAM_SPAWN = 1,     // Apparition des civils (route, sens)
+    STREAM_FIRE,          // Incendies (lieu)
+    STREAM_ACCIDENT,      // Accidents (lieu, gravité)
+    STREAM_VEHICLE_TURN,  // Choix de direction aux intersections (un flux par voiture)
+    STREAM_CRIME,         // Vols et agressions (lieu, gravité)
+    STREAM_ARRIVAL        // Dates des arrivées du générateur de charge (un flux par type)
+};
+
+// Hasard "à compteur" : le nombre ne dépend QUE de (graine, flux, compteur).
+// Pas d'état partagé, donc on peut l'appeler depuis n'importe quel thread
+// dans n'importe quel ordre et obtenir toujours le même résultat.
+uint32_t RandomHash(uint64_t seed, uint64_t stream, uint64_t counter);
+
+// Graine au hasard (pour le jeu, quand aucune graine n'est donnée)
+uint64_t RandomSeedFromDevice();
+
+// --- GÉNÉRATEUR DE HASARD DE LA SIMULATION ---
+// Remplace GetRandomValue() de Raylib pour que le cœur de la simulation
+// puisse tourner sans Raylib. Chaque générateur lit un flux (graine, flux)
+// en avançant son compteur : deux générateurs avec la même graine et le même
+// flux tirent exactement les mêmes nombres.
+class Random {
+public:
+    Random();
+    Random(uint64_t seed, uint64_t stream);
+
+    // Même comportement que GetRandomValue(min, max) : min et max sont inclus
+    int Range(int min, int max);
+
+    // Nombre brut sur 32 bits
+    unsigned int Next();
+
+    // Nombre à virgule dans ]0, 1[ (jamais 0 ni 1 : on peut en prendre le logarithme)
+    double Uniform();
+
+    // Repart du début du flux (compteur à zéro)
+    void Seed(uint64_t seed, uint64_t stream);
+
+    uint64_t Counter() const { return counter; } // Nombre de tirages déjà faits
+    void SetCounter(uint64_t c) { counter = c; } // Reprend le flux à ce tirage (chargement d'une sauvegarde)
+
+private:
+    uint64_t seed;
+    uint64_t stream;
+    uint64_t counter;
+};
+
+#endif
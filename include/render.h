@@ -0,0 +1,49 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "config.h"
+#include "sim_thread.h"
+
+// --- AFFICHAGE DE LA VILLE (RAYLIB) ---
+// Tout ce qui dessine la ville est ici, séparé de la simulation.
+// Ce fichier n'est compilé que dans le programme fenêtré.
+
+// Outil graphique : Dessine une ligne pointillée (le marquage au sol jaune/blanc)
+void DrawDashedLine(Vector2 start, Vector2 end, float thick, Color color);
+
+// --- NIVEAUX DE DÉTAIL (LOD) ---
+// Plus on s'éloigne (zoom petit), moins on dessine de détails :
+// une voiture de 26 pixels devient un point, puis une simple tache de densité.
+enum DetailLevel {
+    DETAIL_FULL,    // Tout : phares, ombre, feux stop, gyrophares
+    DETAIL_SIMPLE,  // Carrosserie seule (ni phares ni sirènes)
+    DETAIL_POINT,   // Un point de couleur par voiture
+    DETAIL_DENSITY  // Plus de voitures : une tache par case, plus foncée s'il y a du monde
+};
+
+// Niveau de détail à utiliser pour un zoom de caméra donné
+DetailLevel DetailForZoom(float zoom);
+
+// Dessine les feux tricolores des croisements visibles (couche par-dessus le fond).
+// Chaque croisement a sa propre phase ("phases", rangée par numéro de nœud du graphe routier).
+// "view" est la partie du monde à l'écran : les croisements en dehors sont sautés.
+void DrawTrafficLights(const std::vector<LightCycle>& phases, bool isNight, Rectangle view, DetailLevel detail);
+
+// Dessine la partie visible de la ville : fond en cache, feux, incidents et voitures,
+// d'après la dernière photo publiée par le thread de simulation.
+// À appeler entre BeginMode2D et EndMode2D. "view" = rectangle du monde visible, "zoom" = zoom de la caméra,
+// "alpha" = position entre les deux derniers pas (0 = prevPos, 1 = pos) pour un mouvement fluide.
+// Seul ce qui touche "view" est dessiné : le coût dépend de l'écran, pas de la taille de la ville.
+void DrawCity(const SimSnapshot& snap, bool isNight, Rectangle view, float zoom, float alpha = 1.0f);
+
+// L'AFFICHAGE D'UNE VOITURE : rectangle coloré, phares, gyrophares... selon le niveau de détail
+void DrawVehicle(const SimSnapshot& snap, int i, bool isNight, DetailLevel detail = DETAIL_FULL, float alpha = 1.0f);
+
+// --- FOND STATIQUE EN CACHE ---
+// Herbe, routes, filtre de nuit, marquages et bâtiments ne changent qu'avec la carte
+// (RecalculateGrid) ou le mode nuit : ils sont dessinés une seule fois dans une texture,
+// puis recopiés à chaque image.
+void InvalidateCityCache(); // Force le prochain DrawCity à refaire le fond
+void UnloadCityCache();     // Libère la texture (à appeler avant CloseWindow)
+
+#endif
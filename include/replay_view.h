@@ -0,0 +1,15 @@
+#ifndef REPLAY_VIEW_H
+#define REPLAY_VIEW_H
+
+// --- RELECTURE D'UNE TRACE (REPLAY) ---
+// Rejoue une trace enregistrée avec --record (voir trace.h) dans la fenêtre, avec les mêmes
+// dessins que le jeu (ville, voitures, mini-carte). Aucune simulation ne tourne : on lit
+// l'état de chaque pas dans le fichier, et on peut sauter n'importe où dans la partie.
+// Commandes : [ESPACE] lecture/pause, [1-4] vitesse x1/x10/x100/x1000, [PAGE HAUT/BAS] ±10 s,
+// [DÉBUT]/[FIN] début/fin, clic sur la barre de temps pour y aller, [N] nuit, caméra comme en jeu.
+// Une partie jouée sur la carte d'un scénario se relit avec le même fichier ("scenarioPath",
+// sinon nullptr : ville procédurale de la taille enregistrée).
+// La fenêtre doit déjà être ouverte. Renvoie le code de sortie du programme.
+int RunReplay(const char* path, const char* scenarioPath);
+
+#endif
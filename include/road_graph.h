@@ -0,0 +1,105 @@
+#ifndef ROAD_GRAPH_H
+#define ROAD_GRAPH_H
+
+#include "config.h"
+#include <cstdint>
+
+// --- GRAPHE DU RÉSEAU ROUTIER ---
+// Chaque carrefour (croisement d'une route verticale et d'une route horizontale) est un nœud.
+// Chaque tronçon de route entre deux carrefours voisins est une arête (dans les deux sens).
+// Construit par RecalculateGrid à partir de vRoads / hRoads (sans les tronçons fermés).
+// Les voisins sont rangés à la suite dans un seul tableau (format "CSR") :
+// les arêtes du nœud n sont les cases edgeStart[n] à edgeStart[n+1]-1.
+class RoadGraph {
+public:
+    RoadGraph();
+
+    // Reconstruit le graphe (xs = positions des routes verticales, ys = des horizontales).
+    // closed = tronçons fermés, une case par carrefour (voir closedSegments) ; vide = tout ouvert.
+    void Build(const std::vector<float>& xs, const std::vector<float>& ys,
+               const std::vector<uint8_t>& closed = std::vector<uint8_t>());
+
+    int NodeCount() const { return cols * rows; }
+    int Cols() const { return cols; }
+    int Rows() const { return rows; }
+
+    // Numéro du carrefour (colonne, ligne) et inversement
+    int NodeAt(int col, int row) const { return row * cols + col; }
+    int NodeCol(int node) const { return node % cols; }
+    int NodeRow(int node) const { return node / cols; }
+    Vector2 NodePos(int node) const { return nodePos[node]; }
+
+    // Carrefour le plus proche d'un point (-1 si le graphe est vide)
+    int NearestNode(Vector2 p) const;
+
+    // Prochain carrefour que l'on rencontrera en roulant dans la direction "d"
+    // (celui où l'on est, si on est à moins de "radius" de son centre, sauf si
+    // "leaving" : la voiture a déjà choisi sa sortie de ce carrefour)
+    int NextNodeAhead(Vector2 p, Dir d, float radius, bool leaving = false) const;
+
+    // Peut-on quitter le carrefour "node" dans la direction "d" ? (faux seulement vers un
+    // tronçon fermé : au bord de la grille, la route continue jusqu'à la sortie de la ville)
+    bool IsOpen(int node, Dir d) const { return d != NONE && (exits[node] >> d) & 1; }
+
+    // Direction à prendre pour aller d'un carrefour à un carrefour voisin
+    Dir DirectionTo(int from, int to) const;
+
+    // Numéro de l'arête "from -> to" (-1 si les deux carrefours ne sont pas voisins)
+    int FindEdge(int from, int to) const;
+
+    // Arête sur laquelle roule une voiture en position "p" dans la direction "d"
+    // (-1 si elle est hors de la grille des carrefours, ex: au bord de la carte)
+    int EdgeAt(Vector2 p, Dir d) const;
+
+    // Arêtes sortantes du nœud "node" : edgeTo[k] et edgeLength[k] pour k dans [EdgeBegin, EdgeEnd)
+    int EdgeBegin(int node) const { return edgeStart[node]; }
+    int EdgeEnd(int node) const { return edgeStart[node + 1]; }
+    std::vector<int> edgeTo;         // Carrefour au bout de l'arête
+    std::vector<float> edgeLength;   // Longueur du tronçon (pixels)
+
+private:
+    int cols, rows;
+    std::vector<Vector2> nodePos;  // Position de chaque carrefour
+    std::vector<int> edgeStart;    // Début des arêtes de chaque nœud (NodeCount()+1 cases)
+    std::vector<uint8_t> exits;    // Sorties ouvertes de chaque nœud (un bit par Dir)
+};
+
+extern RoadGraph roadGraph; // Le réseau routier de la ville actuelle
+
+// --- CALCUL D'ITINÉRAIRE (A*) ---
+// Cherche le plus court chemin entre deux carrefours.
+// Toute la mémoire de travail (liste ouverte, coûts, parents) est gardée d'une
+// recherche à l'autre : après la première recherche sur une carte, FindRoute
+// ne fait plus aucune allocation. Les tableaux sont "remis à zéro" en O(1)
+// grâce à un numéro de recherche (stamp) au lieu d'être effacés.
+class RoutePlanner {
+public:
+    RoutePlanner();
+
+    // Remplit "route" avec les carrefours à traverser, de "from" (inclus) à "to" (inclus).
+    // Renvoie false si aucun chemin n'existe (route est alors vide).
+    // edgeCost = coût de chaque arête (nullptr = longueur en pixels) ;
+    // costPerPixel = coût minimum d'un pixel, pour que l'estimation ne surestime jamais.
+    bool FindRoute(const RoadGraph& graph, int from, int to, std::vector<int>& route,
+                   const std::vector<float>* edgeCost = nullptr, float costPerPixel = 1.0f);
+
+    int LastExpanded() const { return expanded; } // Nœuds explorés par la dernière recherche
+
+private:
+    struct OpenEntry {
+        float f;  // Coût déjà parcouru + estimation du reste
+        int node;
+        bool operator<(const OpenEntry& o) const { return f > o.f; } // Tas "plus petit d'abord"
+    };
+    std::vector<OpenEntry> open;     // Liste ouverte (tas binaire), place réservée
+    std::vector<float> gScore;       // Meilleur coût connu depuis le départ
+    std::vector<int> cameFrom;       // Nœud précédent sur le meilleur chemin
+    std::vector<uint32_t> seenStamp;   // == stamp : gScore/cameFrom valables pour cette recherche
+    std::vector<uint32_t> closedStamp; // == stamp : nœud déjà terminé
+    uint32_t stamp;
+    int expanded;
+
+    void Prepare(const RoadGraph& graph); // Ajuste la taille (seulement si la carte a changé)
+};
+
+#endif
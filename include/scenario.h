@@ -0,0 +1,61 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include "config.h"
+#include <string>
+
+class Simulation;
+
+// --- SCÉNARIO (CARTE D'UN VRAI QUARTIER) ---
+// RecalculateGrid construit toujours la même ville : routes également espacées, un seul
+// hôpital, une caserne et un commissariat dans les coins. Un fichier de scénario décrit
+// à la place un quartier réel : routes à n'importe quel écart, limites de vitesse, rues
+// coupées (impasses), autant de bâtiments de secours que voulu et la demande de trafic.
+//
+// Format texte, une commande par ligne, "#" jusqu'à la fin de la ligne = commentaire.
+// Positions en pixels depuis le coin haut-gauche de la ville (la barre latérale est ajoutée
+// à gauche), vitesses en pixels par pas comme les véhicules (civils : 1.4, secours : 4).
+//
+//   scenario 1                       version du format (première commande)
+//   world LARGEUR HAUTEUR            taille de la ville
+//   vroad X [LIMITE]                 route verticale (X croissants)
+//   hroad Y [LIMITE]                 route horizontale (Y croissants)
+//   closed v COLONNE LIGNE           route verticale n° COLONNE coupée entre les routes
+//                                    horizontales LIGNE et LIGNE+1 (numéros à partir de 0)
+//   closed h LIGNE COLONNE           route horizontale n° LIGNE coupée entre les routes
+//                                    verticales COLONNE et COLONNE+1
+//   station fire|ambulance|police X Y [NOM]   bâtiment de secours centré en (X, Y)
+//   demand civilians N               civils présents au départ
+//   demand max-civilians N           plafond de civils
+//   demand spawn-rate R              civils qui arrivent par seconde
+//   demand interior P                part des civils qui naissent à l'intérieur (0 à 1)
+//   demand incidents R               fréquence des incidents (1 = normale)
+//
+// Le fichier est projeté en mémoire (mapped_file.h) et lu en deux passages sans rien
+// recopier : le premier vérifie tout et compte les routes, le second remplit des tableaux
+// réservés une seule fois à la bonne taille (aucune allocation par route ou par tronçon).
+// En cas d'erreur, la ville actuelle n'est pas touchée.
+
+const int SCENARIO_VERSION = 1;
+
+// Demande de trafic du scénario (valeur négative = absente du fichier)
+struct ScenarioDemand {
+    int civilians = -1;
+    int maxCivilians = -1;
+    float spawnRate = -1.0f;
+    float interiorSpawn = -1.0f;
+    float incidentRate = -1.0f;
+};
+
+// Remplace la ville actuelle (routes, limites, tronçons fermés, bâtiments) par celle du
+// fichier, comme RecalculateGrid. Renvoie false (et "error" avec le numéro de ligne) si le
+// fichier est illisible : la ville n'a alors pas changé.
+bool LoadScenario(const char* path, ScenarioDemand& demand, std::string& error);
+
+// Applique les réglages du trafic présents dans le fichier (arrivées, part des civils qui
+// naissent à l'intérieur, fréquence des incidents). Les nombres de civils (civilians,
+// max-civilians) restent à l'appelant : la place des véhicules se réserve avant de créer
+// la simulation, puis PopulateCivilians remplit la ville.
+void ApplyScenarioDemand(const ScenarioDemand& demand, Simulation& sim);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SIM_MATH_H
+#define SIM_MATH_H
+
+// --- TYPES ET MATHS SANS RAYLIB ---
+// Le cœur de la simulation doit pouvoir tourner sur un serveur sans écran.
+// On redéfinit donc ici les quelques types Raylib dont il a besoin (même forme en mémoire,
+// même nom) ainsi que les petites fonctions de raymath qu'il utilise.
+// Ce fichier n'est utilisé QUE quand SMARTCITY_WITH_RAYLIB n'est pas défini (voir config.h).
+
+#include <cmath>
+
+// Vecteur 2D (identique à celui de Raylib)
+typedef struct Vector2 {
+    float x;
+    float y;
+} Vector2;
+
+// Rectangle (identique à celui de Raylib)
+typedef struct Rectangle {
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+
+// Couleur RGBA (identique à celle de Raylib) : gardée pour les bâtiments
+typedef struct Color {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+
+// Les quelques couleurs Raylib utilisées par le monde (mêmes valeurs que Raylib)
+#define WHITE (Color){ 255, 255, 255, 255 }
+#define RED   (Color){ 230, 41, 55, 255 }
+#define BLUE  (Color){ 0, 121, 241, 255 }
+
+// --- FONCTIONS DE RAYMATH ---
+inline float Lerp(float start, float end, float amount) { return start + amount * (end - start); }
+
+inline Vector2 Vector2Add(Vector2 a, Vector2 b) { return { a.x + b.x, a.y + b.y }; }
+inline Vector2 Vector2Subtract(Vector2 a, Vector2 b) { return { a.x - b.x, a.y - b.y }; }
+inline Vector2 Vector2Scale(Vector2 v, float s) { return { v.x * s, v.y * s }; }
+inline float Vector2Length(Vector2 v) { return sqrtf(v.x * v.x + v.y * v.y); }
+inline float Vector2Distance(Vector2 a, Vector2 b) { return Vector2Length(Vector2Subtract(a, b)); }
+
+inline Vector2 Vector2Normalize(Vector2 v) {
+    float length = Vector2Length(v);
+    if (length > 0) return Vector2Scale(v, 1.0f / length);
+    return v;
+}
+
+// --- COLLISIONS (comme Raylib) ---
+inline bool CheckCollisionRecs(Rectangle a, Rectangle b) {
+    return (a.x < (b.x + b.width) && (a.x + a.width) > b.x) &&
+           (a.y < (b.y + b.height) && (a.y + a.height) > b.y);
+}
+
+inline bool CheckCollisionPointRec(Vector2 p, Rectangle r) {
+    return (p.x >= r.x) && (p.x < (r.x + r.width)) && (p.y >= r.y) && (p.y < (r.y + r.height));
+}
+
+#endif
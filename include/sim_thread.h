@@ -0,0 +1,127 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "config.h"
+#include "simulation.h"
+#include "triple_buffer.h"
+#include <atomic>
+#include <thread>
+
+// --- PHOTO DE LA SIMULATION (SNAPSHOT) ---
+// Tout ce dont l'affichage a besoin, copié à la fin d'un pas de simulation.
+// Une fois publiée, une photo n'est plus jamais modifiée : le thread d'affichage
+// la lit tranquillement pendant que la simulation calcule les pas suivants.
+struct SimSnapshot {
+    long long tick = 0;          // Numéro du pas photographié
+    int speed = 1;               // Vitesse demandée (1, 10, 100... ou SPEED_MAX)
+    double ticksPerSecond = 0;   // Vitesse réelle mesurée (pas de simulation par seconde)
+    double publishedAt = 0;      // Heure de la publication (SimThread::Now, en secondes)
+    double tickPeriod = 0;       // Durée réelle d'un pas à cette vitesse (en secondes)
+    bool isNight = false;        // Mode nuit (changé par commande, comme le reste)
+    SignalMode signalMode = SIGNAL_FIXED;
+    std::vector<LightCycle> phases; // Phase du feu de chaque carrefour (numéro de nœud du graphe)
+    double averageDelay = 0;        // Attente moyenne aux carrefours (s par voiture)
+
+    // Incidents ouverts (dans l'ordre de la table)
+    struct IncidentView {
+        IncidentType type;
+        IncidentState state;
+        int priority;
+        Vector2 pos;
+        int unitSlot; // Case (dans cette photo) du véhicule envoyé, -1 si aucun
+    };
+    std::vector<IncidentView> incidents;
+    int waitingIncidents = 0; // Incidents encore sans véhicule
+
+    ProfileSummary profile; // Mesures de performance (moyennes glissantes et centiles)
+
+    // Voitures : les colonnes du stockage utiles au dessin (la voiture i = case i)
+    std::vector<Vector2> pos;
+    std::vector<Vector2> prevPos;    // Position au pas précédent (interpolation)
+    std::vector<Dir> dir;
+    std::vector<Type> type;
+    std::vector<EmergencyState> emState;
+    std::vector<uint8_t> active;
+    std::vector<uint8_t> isYielding;
+    std::vector<uint8_t> isBraking;  // Feux stop allumés (vitesse < 80% de la vitesse max)
+
+    int Size() const { return (int)pos.size(); }
+
+    // Recopie l'état de "sim" (réutilise la mémoire déjà réservée : pas d'allocation en jeu)
+    void CaptureFrom(const Simulation& sim, bool night);
+};
+
+// --- COMMANDES DE L'INTERFACE ---
+// Les boutons et touches ne touchent jamais la simulation directement :
+// ils envoient une commande, appliquée par le thread de simulation au début du pas suivant.
+enum SimCommandType { CMD_SPAWN, CMD_TOGGLE_NIGHT, CMD_SET_SPEED, CMD_SET_SIGNAL_MODE, CMD_SAVE_STATE };
+
+struct SimCommand {
+    SimCommandType type;
+    Type vehicle; // Pour CMD_SPAWN : le véhicule à faire sortir
+    int value = 0; // CMD_SET_SPEED : 1, 10, 100 (x temps réel) ou SPEED_MAX ; CMD_SET_SIGNAL_MODE : un SignalMode
+};
+
+// Sauvegarde rapide (CMD_SAVE_STATE) : écrite entre deux pas, relue avec "--load smartcity.state"
+const char* const QUICK_SAVE_PATH = "smartcity.state";
+
+// Vitesse "maximum" : les pas s'enchaînent sans jamais attendre
+const int SPEED_MAX = 0;
+
+// --- THREAD DE SIMULATION ---
+// La simulation tourne sur son propre thread avec un pas de temps FIXE (SIM_DT) :
+// le temps réel écoulé (multiplié par la vitesse choisie) remplit un "accumulateur",
+// et on fait autant de pas SIM_DT qu'il en contient. Le comportement de la ville ne
+// dépend donc jamais de la vitesse de l'affichage. En accéléré (x10, x100), on fait
+// plusieurs pas par image ; en SPEED_MAX, on ne s'arrête plus que pour publier.
+// Après chaque paquet de pas, elle publie une photo dans un triple tampon ;
+// l'affichage prend la plus récente quand il est prêt à dessiner.
+// Tant que le thread tourne, seul lui a le droit de toucher à "sim".
+class SimThread {
+public:
+    // Plus de MAX_CATCH_UP images de retard (machine trop lente pour la vitesse demandée) :
+    // on abandonne le retard au lieu d'enchaîner les pas sans fin pour le rattraper.
+    static const int MAX_CATCH_UP = 5;
+    // En SPEED_MAX, une photo toutes les PUBLISH_PERIOD secondes (l'affichage n'en voit pas plus)
+    static constexpr double PUBLISH_PERIOD = 1.0 / 60.0;
+
+    explicit SimThread(Simulation& sim);
+    ~SimThread(); // Arrête le thread s'il tourne encore
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    void Start();
+    void Stop();
+
+    // Envoie une commande à la simulation (depuis le thread d'affichage).
+    // Renvoie false si la file est pleine.
+    bool Send(const SimCommand& command) { return commands.Push(command); }
+
+    // Photo la plus récente (depuis le thread d'affichage). Elle reste valable
+    // et inchangée jusqu'au prochain appel à Latest().
+    const SimSnapshot& Latest();
+
+    // Où en est l'affichage entre l'avant-dernier pas (0) et le dernier (1) de la photo :
+    // la voiture est dessinée entre prevPos et pos, pour un mouvement fluide.
+    static float InterpolationAlpha(const SimSnapshot& snap);
+
+    // Horloge commune aux deux threads (secondes, croissante)
+    static double Now();
+
+private:
+    Simulation& sim;
+    bool night;                   // État du mode nuit (appartient au thread de simulation)
+    int speed;                    // Vitesse demandée (appartient au thread de simulation)
+    double ticksPerSecond;        // Vitesse réelle mesurée
+    TripleBuffer<SimSnapshot> snapshots;
+    CommandQueue<SimCommand, 64> commands;
+    std::thread worker;
+    std::atomic<bool> running;
+
+    void Loop();
+    void ApplyCommands();
+    void Publish(); // Photo de l'état actuel, rendue visible à l'affichage
+};
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "config.h"
+#include "random.h"
+#include "vehicle.h"
+#include "spatial_hash.h"
+#include "yield_field.h"
+#include "thread_pool.h"
+#include "road_graph.h"
+#include "travel_times.h"
+#include "traffic_system.h"
+#include "emergency.h"
+#include "profiler.h"
+#include "spawn_index.h"
+#include "load_generator.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class TraceRecorder;
+class StateWriter;
+class StateReader;
+
+// L'ancienne apparition : une chance sur 81 à chaque pas, soit 60/81 voitures par seconde
+const float DEFAULT_SPAWN_RATE = 60.0f / 81.0f;
+
+// --- LA SIMULATION (SANS AFFICHAGE) ---
+// Cet objet contient tout ce qui "vit" dans la ville : les voitures, les feux des carrefours
+// et les incidents avec leur répartiteur. Il n'utilise jamais Raylib, ce qui permet de
+// le faire tourner sur un serveur sans écran, aussi vite que le processeur le permet.
+// Le programme fenêtré (main.cpp) et le programme headless (headless.cpp) s'en servent tous les deux.
+class Simulation {
+public:
+    // --- VÉHICULES ---
+    VehicleStore vehicles;  // Toutes les voitures en jeu (tableaux contigus, place réservée d'avance)
+    int maxCivilians;       // Plafond de l'apparition automatique (MAX_CIVILIANS par défaut)
+    // Part des civils qui naissent à l'intérieur de la ville (milieu d'un tronçon) plutôt
+    // qu'aux entrées sur les bords. 0 par défaut (petite ville : tout le monde arrive du bord) ;
+    // dans une grande ville, les bords sont trop loin pour remplir le centre.
+    float interiorSpawnShare;
+    float spawnRate;        // Civils qui arrivent par seconde (tant que < maxCivilians), voir loadGenerator
+    SpawnIndex spawnPlaces; // Places d'apparition libres (bords et milieux de tronçons)
+    long long spawned;      // Civils apparus automatiquement
+    long long spawnRefused; // Apparitions demandées sans place libre (ou stockage plein)
+
+    // --- GRILLE SPATIALE ---
+    SpatialHash grid;     // Voitures rangées par case, reconstruite à chaque pas
+    bool useSpatialHash;  // "false" = ancien test contre toutes les voitures (pour comparer)
+    YieldField yieldField; // Zones où les civils doivent se ranger (secours en mission)
+
+    // --- MISE À JOUR EN DOUBLE TAMPON (MULTI-THREAD) ---
+    // En mode double tampon, chaque voiture lit une copie figée de l'état des AUTRES voitures
+    // au début du pas (tampon de lecture) et n'écrit que dans sa propre case du stockage.
+    // Le résultat ne dépend donc ni de l'ordre des voitures ni du nombre de threads.
+    bool doubleBuffered;
+    std::vector<Vector2> frontPos;      // Tampon de lecture : positions au début du pas
+    std::vector<Dir> frontDir;          // Tampon de lecture : directions au début du pas
+    std::vector<uint8_t> frontActive;   // Tampon de lecture : voitures actives au début du pas
+
+    // --- DÉCISIONS DU PAS (PlanVehicle -> MoveVehicles) ---
+    // Une case par voiture, comme le stockage : le mouvement est ensuite fait par paquets (SIMD)
+    std::vector<float> planSpeed;   // Vitesse voulue (< 0 : freinage rapide)
+    std::vector<float> planLane;    // Centre de la voie visée, sur l'axe en travers
+    std::vector<uint8_t> planFlags; // MOTION_SKIP (motion_kernels.h)
+
+    // --- ITINÉRAIRES DES SECOURS ---
+    bool useRouting; // "false" = ancienne navigation "au jugé" (pour comparer)
+    bool useTravelTimes;     // "false" = itinéraires au plus court en distance (sans embouteillages)
+    TravelTimes travelTimes; // Temps de parcours mesurés de chaque tronçon
+    long long routesPlanned;  // Recherches A* effectuées (nouvelles destinations et réparations)
+    long long routesRepaired; // Itinéraires réparés (tronçon devenu plus lent ou plus rapide)
+
+    // --- TEMPS DE RÉPONSE (envoi -> arrivée sur l'incident) ---
+    std::atomic<int> arrivals;              // Nombre de secours arrivés sur un incident
+    std::atomic<long long> arrivalTicks;    // Somme de leurs temps de trajet (en pas)
+    double AverageResponseSeconds(float dt = SIM_DT) const;
+
+    // --- FEUX TRICOLORES ---
+    SignalSystem signals; // Un contrôleur par carrefour (cycle fixe, adaptatif ou onde verte)
+
+    // --- INCIDENTS ---
+    IncidentTable incidents; // Tous les incidents en cours (autant qu'on veut en même temps)
+    Dispatcher dispatcher;   // Envoie les secours vers les incidents, par priorité
+    float incidentRate;      // Multiplie la fréquence des incidents (1 = normal, 10 = ville en crise)
+
+    // --- GÉNÉRATEUR DE CHARGE ---
+    // Dates des incendies, accidents, vols et arrivées de civils (file de priorité, voir
+    // load_generator.h). Le profil se choisit avant de lancer la partie (SetProfile).
+    LoadGenerator loadGenerator;
+
+    // --- MESURES DE PERFORMANCE ---
+    Profiler profiler; // Durée de chaque étape du pas, compteurs, histogrammes (profiler.h)
+
+    // --- ENREGISTREMENT ---
+    TraceRecorder* recorder; // Trace des trajectoires, copiée à la fin de chaque pas (nullptr : aucune)
+
+    // --- TEMPS ---
+    long long tick; // Nombre de pas de simulation déjà effectués
+
+    // --- HASARD ---
+    // Un flux indépendant par usage, tous dérivés de la même graine.
+    // Même graine = même partie au bit près, quel que soit le nombre de threads.
+    uint64_t seed;       // Graine de la partie
+    Random spawnRng;     // Apparition des civils
+    Random fireRng;      // Incendies
+    Random accidentRng;  // Accidents
+    Random crimeRng;     // Vols et agressions
+
+    // vehicleCapacity = nombre maximum de véhicules (toute la place est réservée ici)
+    explicit Simulation(int vehicleCapacity = DEFAULT_VEHICLE_CAPACITY);
+
+    // Une simulation est grosse : on interdit les copies par accident
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // Supprime toutes les voitures et remet les feux et incidents à zéro
+    // (les flux de hasard repartent du début : la partie se rejoue à l'identique)
+    void Reset();
+
+    // Choisit la graine et remet tous les flux de hasard au début
+    void SetSeed(uint64_t newSeed);
+
+    // Nombre au hasard de la voiture "slot" pour le pas en cours. Chaque voiture a son
+    // propre flux (lié à sa poignée), avancé par le numéro du pas : aucun état partagé.
+    uint32_t VehicleRandom(int slot) const;
+
+    // Avance la simulation d'un pas de temps fixe "dt" (en secondes)
+    void Step(float dt);
+
+    // Avance la simulation de "ticks" pas d'affilée (mode batch)
+    void Run(int ticks, float dt = SIM_DT);
+
+    // Crée un véhicule du type demandé (bouton de la barre latérale, apparition automatique...)
+    // Renvoie "false" si la voiture n'a pas pu être placée.
+    bool Spawn(Type type);
+
+    // Remplit directement les voies avec "count" civils espacés régulièrement
+    // (tests de charge et benchmarks). Renvoie le nombre de voitures vraiment placées.
+    int PopulateCivilians(int count);
+
+    // Nombre de threads pour la mise à jour des voitures (plus de 1 = mode double tampon)
+    void SetThreadCount(int threads);
+    int ThreadCount() const { return pool->ThreadCount(); }
+
+    // --- SAUVEGARDE (voir state_file.h) ---
+    // Écrit tout l'état, ville comprise, dans "path". Renvoie false (et le message dans "error") si échec.
+    bool SaveState(const char* path, std::string& error) const;
+    // Remplace la ville et tout l'état par ceux du fichier : la partie continue exactement comme
+    // après la sauvegarde (les mesures du profiler repartent de zéro). La place réservée pour les
+    // véhicules est agrandie si besoin. Tout le fichier est vérifié avant de rien changer : en cas
+    // d'échec (fichier illisible ou abîmé), la ville et la partie restent celles d'avant l'appel.
+    bool LoadState(const char* path, std::string& error);
+
+    // Empreinte de l'état (voitures, feux, incidents) : deux simulations identiques
+    // au bit près ont la même empreinte. Sert à vérifier le déterminisme.
+    uint64_t StateChecksum() const;
+
+private:
+    std::unique_ptr<ThreadPool> pool; // Threads de mise à jour (1 = pas de thread en plus)
+    RoutePlanner planner;             // Mémoire de travail de A* (réutilisée)
+    std::vector<CarCounters> taskCounters; // Compteurs de chaque tâche du pas (tampon réutilisé)
+    int civilianArrivals;             // Civils arrivés pendant le pas, pas encore placés
+
+    // Tout l'état (en-tête, ville, simulation) dans le format de SaveState. CheckState lit le
+    // fichier entier et vérifie ses sections sans rien changer (première passe de LoadState).
+    void WriteState(StateWriter& out) const;
+    bool CheckState(StateReader& in) const;
+    bool ReadState(StateReader& in);
+
+    void UpdateLights(float dt);  // Avance les feux et mesure les attentes aux carrefours
+    void GenerateEvents(float dt); // Arrivées dues pendant le pas : incidents signalés, civils comptés
+    void SpawnCivilians();        // Place les civils arrivés pendant le pas
+    void PlanRoutes();            // Itinéraires des secours dont la destination a changé
+    void UpdateCars(float dt);    // IA + mouvement + ménage des voitures inactives
+};
+
+#endif
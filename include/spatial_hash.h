@@ -0,0 +1,86 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "config.h"
+#include <cstdint>
+
+class VehicleStore;
+
+// --- GRILLE SPATIALE (SPATIAL HASH) ---
+// On découpe le monde en cases carrées de TARGET_BLOCK_SIZE pixels.
+// Chaque voiture est rangée dans la case qui contient son centre.
+// Pour savoir qui touche un rectangle (ex: le capteur d'une voiture), on ne regarde
+// que les cases que ce rectangle recouvre, au lieu de tester TOUTES les voitures.
+// La grille est reconstruite une fois par pas de simulation (tri par comptage, O(n)) :
+// on ne remet à zéro que les cases occupées au pas précédent, le coût ne dépend donc
+// pas de la taille de la carte (une grande ville presque vide reste rapide).
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = TARGET_BLOCK_SIZE);
+
+    // Marge ajoutée autour de chaque recherche : une voiture peut bouger (ou prendre un virage)
+    // après la reconstruction de la grille, pendant le même pas de simulation.
+    static constexpr float QUERY_MARGIN = 40.0f;
+
+    // Range toutes les voitures actives dans leur case (à appeler une fois par pas)
+    void Build(const VehicleStore& vehicles);
+    // Même chose à partir de simples tableaux (ex : la photo de la simulation pour le dessin)
+    void Build(const Vector2* pos, const uint8_t* active, int count);
+
+    // Appelle visit(i) pour chaque voiture (numéro de case i) rangée dans une case touchée par "area"
+    template <typename Visitor>
+    void Query(Rectangle area, Visitor&& visit) const {
+        if (cols == 0) return;
+        int minCx, minCy, maxCx, maxCy;
+        CellRange(area, minCx, minCy, maxCx, maxCy);
+        for (int cy = minCy; cy <= maxCy; cy++) {
+            for (int cx = minCx; cx <= maxCx; cx++) {
+                int cell = cy * cols + cx;
+                int first = cellStart[cell];
+                for (int k = first; k < first + cellCars[cell]; k++) visit(entries[k]);
+            }
+        }
+    }
+
+    // Appelle visit(bounds, count) pour chaque case touchée par "area" :
+    // son rectangle dans le monde et son nombre de voitures (carte de densité vue de loin)
+    template <typename Visitor>
+    void QueryCells(Rectangle area, Visitor&& visit) const {
+        if (cols == 0) return;
+        int minCx, minCy, maxCx, maxCy;
+        CellRange(area, minCx, minCy, maxCx, maxCy);
+        for (int cy = minCy; cy <= maxCy; cy++) {
+            for (int cx = minCx; cx <= maxCx; cx++) {
+                int cell = cy * cols + cx;
+                Rectangle bounds = { originX + cx * cellSize, originY + cy * cellSize, cellSize, cellSize };
+                visit(bounds, cellCars[cell]);
+            }
+        }
+    }
+
+    // --- PARCOURS PAR RÉGION (mise à jour multi-thread) ---
+    // Les voitures sont rangées case par case, les cases ligne par ligne :
+    // des numéros de case qui se suivent = une bande de la carte.
+    int CellCount() const { return cols * rows; }
+    int EntryCount() const { return (int)entries.size(); }     // Nombre de voitures rangées
+    int EntryAt(int k) const { return entries[k]; }            // Numéro de la voiture de l'entrée k
+
+private:
+    float cellSize;
+    float originX, originY; // Coin haut-gauche de la grille (le monde + une marge hors écran)
+    int cols, rows;
+
+    // Tableaux d'une case par case de la carte, alloués quand la taille de la grille change.
+    // Seules les cases occupées ont un début valable ; les autres ont 0 voiture.
+    std::vector<int> cellStart;  // Début de chaque case dans "entries" (cases occupées)
+    std::vector<int> cellCars;  // Nombre de voitures de chaque case (0 partout ailleurs)
+    std::vector<int> occupied;   // Cases occupées, dans l'ordre des numéros (remises à zéro au pas suivant)
+    std::vector<int> entries;    // Les numéros des voitures, triés case par case
+    std::vector<int> carCell;    // Case de chaque voiture (tampon réutilisé)
+
+    int CellX(float x) const;
+    int CellY(float y) const;
+    void CellRange(Rectangle area, int& minCx, int& minCy, int& maxCx, int& maxCy) const;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SPAWN_INDEX_H
+#define SPAWN_INDEX_H
+
+#include "config.h"
+#include "random.h"
+#include <cstdint>
+
+class VehicleStore;
+
+// --- PLACES D'APPARITION DES CIVILS ---
+// Une "place" = une voie où une voiture peut naître :
+// - aux bords : chaque bout de route, une voie entrante (juste hors de la ville) ;
+// - à l'intérieur : le milieu de chaque tronçon, dans chaque sens (grande ville),
+//   sauf sur les tronçons fermés (closedSegments).
+// Une place est occupée si une voiture roule dans cette voie, dans le même sens,
+// à moins de SPAWN_CLEARANCE de la place. Les places occupées sont marquées en un
+// seul passage sur les voitures (seulement aux pas où une apparition est demandée) ;
+// ensuite chaque apparition choisit une place libre directement, sans tester les autres
+// voitures : elle réussit tant qu'il reste une place libre.
+class SpawnIndex {
+public:
+    static constexpr float SPAWN_CLEARANCE = 70.0f; // Distance libre devant et derrière la place
+    static constexpr float EDGE_DISTANCE = 90.0f;   // Les places des bords sont à 90 px hors de la ville
+
+    struct Place {
+        Vector2 pos;
+        Dir dir;
+    };
+
+    SpawnIndex();
+
+    // Les occupations seront recalculées à la prochaine demande (voitures ajoutées à la main...)
+    void Invalidate() { refreshedTick = -1; }
+
+    // Prend une place libre (au bord, ou à l'intérieur si "interior") et la marque occupée.
+    // Renvoie -1 si toutes les places de ce genre sont occupées.
+    int Take(const VehicleStore& vehicles, long long tick, bool interior, Random& rng);
+
+    const Place& At(int place) const { return places[place]; }
+    int EdgeCount() const { return edgeCount; }
+    int PlaceCount() const { return (int)places.size(); }
+    int FreeEdgeCount() const { return (int)freeEdges.size(); }
+
+private:
+    std::vector<Place> places;       // Bords d'abord (edgeCount), puis les milieux de tronçons
+    int edgeCount;
+    int builtVersion;                // worldVersion des places (la ville a-t-elle changé ?)
+    long long refreshedTick;         // Pas du dernier marquage (-1 : à refaire)
+    uint32_t stamp;                  // Numéro du marquage en cours
+    std::vector<uint32_t> busy;      // busy[place] == stamp : place occupée
+    std::vector<uint8_t> closed;     // Place sur un tronçon fermé (jamais d'apparition)
+    std::vector<int> freeEdges;      // Places des bords libres (tirage en O(1))
+
+    void BuildPlaces();
+    void Refresh(const VehicleStore& vehicles);
+    void Mark(int place) { busy[place] = stamp; }
+    void MarkCar(Vector2 pos, Dir dir);
+};
+
+#endif
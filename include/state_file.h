@@ -0,0 +1,144 @@
+#ifndef STATE_FILE_H
+#define STATE_FILE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// --- SAUVEGARDE DE L'ÉTAT COMPLET (FICHIER BINAIRE) ---
+// Pour repartir d'une ville déjà chargée sans refaire la montée en charge, on écrit tout
+// l'état de la simulation dans un fichier : ville (routes, bâtiments), véhicules, feux,
+// temps de parcours, incidents, répartiteur et compteurs des flux de hasard.
+// Recharger puis continuer donne exactement la même partie que sans interruption.
+//
+// Format : "SCSTATE1", version, puis des sections (étiquette de 4 lettres + contenu).
+// Les colonnes du stockage des véhicules sont écrites telles quelles (nombre + octets) :
+// au chargement, elles sont lues d'un seul bloc directement dans les tableaux déjà réservés.
+// Le fichier n'est relu que par le même programme (même machine, même compilation) :
+// les nombres sont écrits dans le format de la machine.
+
+const uint32_t STATE_VERSION = 4; // 2 : limites de vitesse et tronçons fermés, 3 : générateur de charge,
+                                  // 4 : matrices des gains du répartiteur
+
+// Écriture : chaque classe de la simulation a sa méthode Save(StateWriter&)
+class StateWriter {
+public:
+    explicit StateWriter(FILE* f) : file(f), failed(false) {}
+
+    void Bytes(const void* p, size_t n) {
+        if (n > 0 && fwrite(p, 1, n, file) != n) failed = true;
+    }
+    template <typename T> void Value(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "valeur copiable octet par octet");
+        Bytes(&v, sizeof(T));
+    }
+    // Les "count" premières cases d'un tableau (nombre puis octets)
+    template <typename T> void Column(const std::vector<T>& v, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "colonne copiable octet par octet");
+        Value<uint64_t>(count);
+        Bytes(v.data(), count * sizeof(T));
+    }
+    template <typename T> void Vector(const std::vector<T>& v) { Column(v, v.size()); }
+    void Text(const std::string& s) {
+        Value<uint64_t>(s.size());
+        Bytes(s.data(), s.size());
+    }
+    void Section(const char* tag) { Bytes(tag, 4); }
+
+    bool Ok() const { return !failed; }
+
+private:
+    FILE* file;
+    bool failed;
+};
+
+// Lecture : chaque classe a sa méthode Load(StateReader&). À la première erreur (fichier
+// trop court, étiquette inattendue, taille impossible), toutes les lectures suivantes
+// échouent et Error() dit ce qui s'est passé.
+class StateReader {
+public:
+    StateReader(FILE* f, uint64_t fileSize) : file(f), remaining(fileSize) {}
+
+    bool Bytes(void* p, size_t n) {
+        if (!error.empty()) return false;
+        if (n > remaining || (n > 0 && fread(p, 1, n, file) != n)) return Fail("fichier trop court");
+        remaining -= n;
+        return true;
+    }
+    template <typename T> bool Value(T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "valeur copiable octet par octet");
+        return Bytes(&v, sizeof(T));
+    }
+    // Colonne écrite par StateWriter::Column, lue directement dans "v" (déjà assez grand)
+    template <typename T> bool Column(std::vector<T>& v, size_t count) {
+        uint64_t n = 0;
+        if (!Value(n)) return false;
+        if (n != count || n > v.size()) return Fail("colonne de taille inattendue");
+        return Bytes(v.data(), count * sizeof(T));
+    }
+    // Colonne vérifiée (taille annoncée = count) puis sautée : vérification d'une sauvegarde
+    // avant de la charger (voir Simulation::LoadState), sans rien recopier
+    template <typename T> bool SkipColumn(const std::vector<T>&, size_t count) {
+        uint64_t n = 0;
+        if (!Value(n)) return false;
+        if (n != count) return Fail("colonne de taille inattendue");
+        return Skip((uint64_t)count * sizeof(T));
+    }
+    bool Skip(uint64_t n) {
+        if (!error.empty()) return false;
+        if (n > remaining) return Fail("fichier trop court");
+        remaining -= n;
+        // fseek prend un long (32 bits sous Windows) : on avance par morceaux
+        while (n > 0) {
+            long step = (long)std::min<uint64_t>(n, 1u << 30);
+            if (fseek(file, step, SEEK_CUR) != 0) return Fail("fichier trop court");
+            n -= (uint64_t)step;
+        }
+        return true;
+    }
+    // Tableau écrit par StateWriter::Vector ("v" prend la taille lue)
+    template <typename T> bool Vector(std::vector<T>& v) {
+        uint64_t n = 0;
+        if (!Count(n, sizeof(T))) return false;
+        v.resize((size_t)n);
+        return Bytes(v.data(), (size_t)n * sizeof(T));
+    }
+    bool Text(std::string& s) {
+        uint64_t n = 0;
+        if (!Count(n, 1)) return false;
+        s.resize((size_t)n);
+        return Bytes(&s[0], (size_t)n);
+    }
+    // Nombre d'éléments de "itemSize" octets : impossible s'il dépasse la fin du fichier
+    bool Count(uint64_t& n, size_t itemSize) {
+        if (!Value(n)) return false;
+        if (itemSize > 0 && n > remaining / itemSize) return Fail("taille impossible");
+        return true;
+    }
+    bool Section(const char* tag) {
+        char read[4];
+        if (!Bytes(read, 4)) return false;
+        for (int k = 0; k < 4; k++) {
+            if (read[k] != tag[k]) return Fail((std::string("section ") + std::string(tag, 4) + " attendue").c_str());
+        }
+        return true;
+    }
+
+    bool Fail(const char* why) {
+        if (error.empty()) error = why;
+        return false;
+    }
+    bool Ok() const { return error.empty(); }
+    const std::string& Error() const { return error; }
+    uint64_t Remaining() const { return remaining; }
+
+private:
+    FILE* file;
+    uint64_t remaining; // Octets encore à lire
+    std::string error;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// --- RÉSERVOIR DE THREADS AVEC VOL DE TRAVAIL ("WORK STEALING") ---
+// Les threads sont créés une seule fois et attendent du travail.
+// ParallelFor découpe les tâches [0, taskCount) en un bloc contigu par thread
+// (des régions voisines de la carte restent ensemble). Un thread qui a fini son bloc
+// "vole" la moitié du bloc restant d'un autre thread, jusqu'à ce qu'il n'y ait plus rien.
+// Le thread qui appelle ParallelFor travaille aussi (c'est le thread numéro 0).
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int ThreadCount() const { return (int)queues.size(); }
+
+    // Exécute task(t) pour chaque t de [0, taskCount) et attend que tout soit fini.
+    // L'ordre d'exécution n'est PAS garanti : chaque tâche doit être indépendante.
+    void ParallelFor(int taskCount, const std::function<void(int)>& task);
+
+private:
+    // Bloc de tâches d'un thread : [début, fin) rangés dans un seul entier 64 bits
+    // pour pouvoir le modifier d'un coup (compare_exchange) sans verrou.
+    struct alignas(64) Queue {
+        std::atomic<uint64_t> range;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queueStorage;
+    std::vector<Queue*> queues;
+
+    // Synchronisation du début et de la fin de chaque ParallelFor
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::condition_variable allDone;
+    uint64_t jobId;          // Augmente à chaque nouveau travail
+    int finishedWorkers;     // Threads (hors appelant) qui ont terminé le travail en cours
+    bool stopping;
+    const std::function<void(int)>* currentTask;
+
+    void WorkerLoop(int id);
+    void RunTasks(int id);                 // Vide son bloc puis vole les autres
+    bool PopFront(int id, int& task);      // Prend la prochaine tâche de son propre bloc
+    bool StealHalf(int thief);             // Vole la moitié du bloc d'un autre thread
+};
+
+#endif
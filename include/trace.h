@@ -0,0 +1,201 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "config.h"
+#include "vehicle_store.h"
+#include "emergency.h"
+#include "mapped_file.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class Simulation;
+struct SimSnapshot;
+
+// --- ENREGISTREMENT DES TRAJECTOIRES (TRACE BINAIRE) ---
+// Pour analyser une partie après coup (pourquoi ce camion de pompiers a mis 40 s,
+// où les civils ont pilé...), on enregistre à chaque pas l'état de chaque véhicule
+// (position, direction, vitesse, état de secours, se range ou non), les changements
+// des feux et les événements des incidents.
+//
+// Format du fichier (petit-boutiste) :
+//   en-tête (40 octets) : "SCTRACE1", version, période des images clés, SIM_DT, taille du monde, graine
+//   puis une image par pas : [genre (1 octet)] [pas (varint)] [taille (varint)] [contenu]
+//   - image clé (tous les keyframeEvery pas) : état complet, lisible seule
+//   - image delta : seulement les écarts avec le pas précédent (entiers variables "varint",
+//     positions au 1/16 de pixel) : environ 6 octets par voiture qui roule.
+// Contenu d'une image : mode des feux, phases (delta : seulement les carrefours qui changent),
+// véhicules dans l'ordre du stockage (un véhicule absent a disparu), événements des incidents
+// (ouvert, changé, fermé). La ville n'est pas enregistrée : RecalculateGrid(largeur, hauteur)
+// la reconstruit à l'identique.
+// Une image coupée en fin de fichier (programme arrêté brutalement) est ignorée à la lecture.
+
+const uint32_t TRACE_VERSION = 1;
+const float TRACE_POS_SCALE = 16.0f;     // Positions enregistrées au 1/16 de pixel
+const float TRACE_SPEED_SCALE = 1024.0f; // Vitesses au 1/1024 de pixel par pas
+const int TRACE_DEFAULT_KEYFRAME = 600;  // Une image clé toutes les 10 s de la ville
+
+// --- ÉTAT D'UN PAS (COPIE BRUTE) ---
+// Ce que le thread de simulation recopie (sans rien calculer) pour le thread d'écriture.
+struct TraceFrame {
+    long long tick = 0;
+    int signalMode = 0;
+    std::vector<VehicleHandle> handle;
+    std::vector<Type> type;
+    std::vector<Vector2> pos;
+    std::vector<Dir> dir;
+    std::vector<float> speed;
+    std::vector<float> maxSpeed;
+    std::vector<EmergencyState> emState;
+    std::vector<uint8_t> isYielding;
+    std::vector<LightCycle> phases;
+    std::vector<Incident> incidents; // Incidents ouverts
+
+    void CaptureFrom(const Simulation& sim);
+};
+
+// --- ENREGISTREUR ---
+// Le thread de simulation appelle Record() à la fin de chaque pas (Simulation::recorder) :
+// une simple copie des colonnes dans une image libre du réservoir. Le codage (écarts,
+// varints) et l'écriture sur disque se font sur un thread à part. Si le disque ne suit pas,
+// Record() attend qu'une image se libère : on ne perd jamais de pas.
+class TraceRecorder {
+public:
+    static const int POOL_SIZE = 16; // Images d'avance entre la simulation et l'écriture
+
+    TraceRecorder();
+    ~TraceRecorder(); // Termine l'écriture si besoin
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // Crée le fichier, démarre le thread d'écriture et enregistre l'état actuel de "sim"
+    // (première image clé). Renvoie false si le fichier ne s'ouvre pas.
+    bool Open(const char* path, const Simulation& sim, int keyframeEvery = TRACE_DEFAULT_KEYFRAME);
+    // Écrit les images en attente et ferme le fichier
+    void Close();
+    bool IsOpen() const { return file != nullptr; }
+
+    // Copie de l'état du pas qui vient de se terminer (thread de simulation).
+    // Un pas déjà enregistré (Reset de la simulation) est ignoré : il faut une nouvelle trace.
+    void Record(const Simulation& sim);
+
+    long long FramesWritten() const { return framesWritten; }
+    long long BytesWritten() const { return bytesWritten; }
+    double WaitSeconds() const { return waitSeconds; } // Temps passé par la simulation à attendre l'écriture
+
+private:
+    FILE* file;
+    int keyframeEvery;
+    long long recordedTick; // Dernier pas copié (thread de simulation)
+    double waitSeconds;
+
+    // --- RÉSERVOIR D'IMAGES (simulation <-> écriture) ---
+    TraceFrame pool[POOL_SIZE];
+    std::mutex lock;
+    std::condition_variable frameReady; // Une image attend d'être écrite (ou fin de l'écriture)
+    std::condition_variable frameFree;  // Une image est de nouveau libre
+    std::vector<int> freeFrames;        // Images libres
+    std::deque<int> pending;            // Images à écrire, dans l'ordre
+    bool stopping;
+    std::thread writer;
+    long long framesWritten;            // Lus après Close() seulement
+    long long bytesWritten;
+
+    // --- ÉTAT DU CODEUR (thread d'écriture seulement) ---
+    struct LastVehicle { uint32_t generation; int32_t x, y, speed; };
+    struct LastIncident { uint32_t id; IncidentState state; VehicleHandle unit; };
+    std::vector<LastVehicle> lastVehicle;    // Dernier état écrit, par numéro de poignée
+    std::vector<long long> lastSeen;         // Pas où la poignée a été écrite pour la dernière fois
+    std::vector<LightCycle> lastPhases;
+    std::vector<LastIncident> lastIncidents; // Triés par numéro d'incident
+    std::vector<const Incident*> sorted;     // Incidents de l'image, triés par numéro (tampon réutilisé)
+    long long firstTick;
+    long long lastTick;                      // -1 : rien d'écrit
+    std::vector<uint8_t> bytes;              // Image en cours de codage (tampon réutilisé)
+    std::vector<uint8_t> events;             // Événements des incidents de l'image (tampon réutilisé)
+
+    void WriterLoop();
+    void Encode(const TraceFrame& f, bool key);
+};
+
+// --- LECTEUR (REPLAY) ---
+// Le fichier est projeté en mémoire (mmap) : rien n'est lu d'avance. À l'ouverture, un seul
+// passage repère le début de chaque image. Pour aller à un pas quelconque, on part de
+// l'image clé précédente et on applique au plus keyframeEvery deltas ; en lecture normale,
+// on avance simplement d'image en image. Aucune simulation n'est refaite.
+class TraceReader {
+public:
+    TraceReader();
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    // Renvoie false (et un message dans Error()) si le fichier est absent ou n'est pas une trace
+    bool Open(const char* path);
+    void Close();
+    const std::string& Error() const { return error; }
+
+    // Monde et partie enregistrés (pour reconstruire la même ville avec RecalculateGrid)
+    int WorldWidth() const { return worldW; }
+    int WorldHeight() const { return worldH; }
+    uint64_t Seed() const { return seed; }
+    int KeyframeEvery() const { return keyframeEvery; }
+    long long FrameCount() const { return (long long)frameOffsets.size(); }
+    long long FirstTick() const { return frameTicks.empty() ? 0 : frameTicks.front(); }
+    long long LastTick() const { return frameTicks.empty() ? 0 : frameTicks.back(); }
+    long long KeyframeCount() const { return keyframes; }
+    size_t FileSize() const { return size; }
+    bool Truncated() const { return truncated; } // Fin du fichier coupée (image incomplète ignorée)
+
+    // Remplit "snap" avec l'état du pas "tick" (ramené entre FirstTick et LastTick ; s'il manque
+    // des pas, le dernier enregistré avant). Renvoie false si le fichier est abîmé.
+    bool Seek(long long tick, SimSnapshot& snap);
+    long long CurrentTick() const { return current < 0 ? -1 : frameTicks[current]; }
+
+private:
+    MappedFile mapped;
+    const uint8_t* data; // = mapped.Data()
+    size_t size;
+    std::string error;
+
+    int worldW, worldH;
+    uint64_t seed;
+    int keyframeEvery;
+    long long keyframes;
+    bool truncated;
+    std::vector<size_t> frameOffsets;   // Début de chaque image
+    std::vector<long long> frameTicks;  // Pas de chaque image (croissants)
+    std::vector<int> keyframeOf;        // Image clé à partir de laquelle décoder chaque image
+
+    // --- ÉTAT DÉCODÉ ---
+    struct Vehicle {
+        uint32_t index, generation;
+        Type type;
+        int32_t x, y, speed;
+        uint8_t packed; // dir (3 bits) | emState (3 bits) | se range | freine
+    };
+    int current;                        // Image décodée (-1 : aucune)
+    std::vector<Vehicle> vehicles;      // Dans l'ordre du stockage
+    std::vector<Vehicle> byHandle;      // Dernier état décodé, par numéro de poignée
+    std::vector<int> slotOfHandle;      // Case dans "vehicles" (pour les incidents)
+    std::vector<LightCycle> phases;
+    std::vector<Incident> incidents;    // Ouverts, triés par numéro
+    int signalMode;
+
+    bool IndexFrames();
+    bool DecodeFrame(int frame);
+    void Fill(SimSnapshot& snap);
+};
+
+// Empreinte de ce qu'une trace garde d'une photo (positions au 1/16 de pixel, directions,
+// états, feux, incidents) : la photo de la simulation et celle relue dans la trace au même
+// pas ont la même empreinte. Sert à vérifier l'enregistrement et la relecture.
+uint64_t TraceChecksum(const SimSnapshot& snap);
+
+#endif
@@ -2,21 +2,98 @@
 #define TRAFFIC_SYSTEM_H
 
 #include "config.h"
+#include <cstdint>
 
-// --- VARIABLES GLOBALES (EXTERNES) ---
-// Le mot "extern" signifie que ces boîtes de mémoire existent réellement ailleurs (dans world.cpp),
-// mais ce fichier a besoin de connaître leur existence pour vérifier s'il y a une urgence.
+class RoadGraph;
+class VehicleStore;
+class StateWriter;
+class StateReader;
 
-extern bool fireActive;      // Est-ce qu'il y a un incendie en cours ?
-extern Vector2 firePos;      // Si oui, à quel endroit précis (X, Y) ?
+// --- FEUX TRICOLORES ---
+// Les incendies et accidents appartiennent maintenant à la Simulation (simulation.h).
+// Ici on garde seulement les règles des feux, sans aucun dessin (voir render.h).
 
-extern bool accidentActive;  // Est-ce qu'il y a un accident de voiture ?
-extern Vector2 accidentPos;  // Si oui, où ça ?
+const float LIGHT_PHASE_DURATION = 3.0f; // Durée d'une phase de feu en cycle fixe (en secondes)
+
+// --- MODES DE COMMANDE DES FEUX ---
+enum SignalMode {
+    SIGNAL_FIXED,      // Cycle fixe, tous les carrefours en même temps (comportement d'origine)
+    SIGNAL_ACTUATED,   // Chaque carrefour prolonge ou écourte son vert selon les files d'attente
+    SIGNAL_GREEN_WAVE  // Cycle fixe décalé d'un carrefour à l'autre : "onde verte" vers la droite et vers le bas
+};
+
+const float SIGNAL_YELLOW = 1.5f;        // Jaune (dégagement du carrefour) des modes adaptatif et onde verte
+const float ACTUATED_MIN_GREEN = 2.0f;   // Vert minimum avant de pouvoir changer
+const float ACTUATED_MAX_GREEN = 12.0f;  // Au-delà, on cède la place si l'autre sens attend
+const float WAVE_GREEN = 4.0f;           // Vert de chaque sens en onde verte
+const float WAVE_SPEED = 84.0f;          // Vitesse de l'onde (pixels/s) : un civil à pleine vitesse
+const float DETECTOR_RANGE = 120.0f;     // Zone de détection avant le carrefour (pixels)
+const float STOPPED_SPEED = 0.3f;        // En dessous (pixels par pas), une voiture attend
 
 // --- FONCTIONS ---
 
-// Cette fonction dessine les feux tricolores (rouge/vert) à un croisement précis.
-// Elle a besoin de savoir où c'est (x, y), quel feu est vert (cycle), et s'il fait nuit.
-void DrawIntersectionLights(float x, float y, LightCycle cycle, bool isNight);
+// Renvoie la phase suivante du cycle (Vert Vertical -> Jaune Vertical -> Vert Horizontal -> ...)
+LightCycle NextLightCycle(LightCycle cycle);
+
+// --- CONTRÔLEURS DES CARREFOURS ---
+// Chaque carrefour (nœud du graphe routier) a son propre feu.
+// - Cycle fixe et onde verte : la phase ne dépend que de l'heure (et du décalage du carrefour),
+//   elle se calcule directement sans rien mettre à jour.
+// - Adaptatif : chaque carrefour garde sa phase. Il n'est examiné que s'il a des voitures
+//   dans sa zone de détection ou s'il est au jaune : une grande ville vide ne coûte rien.
+// Le retard (temps passé arrêté en approche) et le nombre d'arrivées sont comptés par carrefour.
+class SignalSystem {
+public:
+    SignalSystem();
+
+    // Un contrôleur par carrefour, tous au vert vertical (après un changement de carte)
+    void Reset(const RoadGraph& graph);
+
+    // Change de mode (les statistiques continuent)
+    void SetMode(SignalMode newMode);
+    SignalMode Mode() const { return mode; }
+
+    // Un pas : mesure des files d'attente et des retards (civils seulement), puis avance des feux.
+    // Range aussi dans vehicles.signalNode le carrefour vers lequel roule chaque civil.
+    void Update(float dt, VehicleStore& vehicles, const RoadGraph& graph);
+
+    // Phase du feu du carrefour "node" (-1 ou hors carte : vert vertical)
+    LightCycle PhaseAt(int node) const;
+
+    // Phase de tous les carrefours (pour la photo de l'affichage)
+    void FillPhases(std::vector<LightCycle>& phases) const;
+
+    // --- STATISTIQUES ---
+    double AverageDelay(int node) const; // Attente moyenne (s) par voiture arrivée à ce carrefour
+    double AverageDelay() const;         // Pareil sur toute la ville
+    long long Arrivals(int node) const { return arrivals[node]; }
+    long long TotalArrivals() const { return totalArrivals; }
+    int NodeCount() const { return (int)arrivals.size(); }
+    void ResetStats();
+
+    // Sauvegarde : mode, horloge, phases, files d'attente et statistiques
+    void Save(StateWriter& out) const;
+    bool Load(StateReader& in);
+
+private:
+    SignalMode mode;
+    double clock;                  // Temps écoulé (s) depuis Reset
+
+    // Mode adaptatif
+    std::vector<LightCycle> phase;    // Phase actuelle
+    std::vector<double> phaseStart;   // Heure du début de la phase
+    std::vector<uint16_t> demand[2];  // Voitures dans la zone de détection (0 = vertical, 1 = horizontal)
+    std::vector<uint16_t> queue[2];   // Parmi elles, celles qui sont arrêtées (file d'attente)
+    std::vector<int> touched;         // Carrefours avec de la demande ce pas-ci
+    std::vector<int> yellow;          // Carrefours au jaune (à faire passer au vert)
+
+    std::vector<float> offset;        // Décalage de l'onde verte (s)
+    std::vector<double> delay;        // Somme des attentes (s)
+    std::vector<long long> arrivals;  // Voitures arrivées dans la zone du carrefour
+    double totalDelay;
+    long long totalArrivals;
+
+    void UpdateActuated(int node);
+};
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,68 @@
+#ifndef TRAVEL_TIMES_H
+#define TRAVEL_TIMES_H
+
+#include "config.h"
+#include <cstdint>
+
+class RoadGraph;
+class VehicleStore;
+class StateWriter;
+class StateReader;
+
+// --- TEMPS DE PARCOURS DES TRONÇONS (EMBOUTEILLAGES) ---
+// Pour chaque tronçon (arête du graphe routier, dans un sens), on estime le temps
+// qu'il faut pour le traverser, d'après la vitesse réelle des voitures qui y roulent.
+// L'estimation est lissée (moyenne exponentielle) pour ne pas réagir au moindre coup de frein.
+// Les secours calculent leur itinéraire avec ces temps : ils évitent les rues bouchées.
+// Quand le temps d'un tronçon change de plus de CHANGE_THRESHOLD depuis la dernière
+// annonce, il est ajouté à la liste des tronçons modifiés : seuls les itinéraires
+// qui passent par ces tronçons seront réparés (voir Simulation::PlanRoutes).
+class TravelTimes {
+public:
+    static constexpr int SAMPLE_PERIOD = 30;          // Pas de simulation entre deux mesures
+    static constexpr float SMOOTHING = 0.3f;          // Poids d'une nouvelle mesure dans la moyenne
+    static constexpr float CHANGE_THRESHOLD = 0.25f;  // Variation relative qui déclenche une réparation
+    static constexpr float FREE_SPEED = 4.0f;         // Vitesse des secours rue vide (pixels par pas)
+    static constexpr float MIN_FLOW = 0.1f;           // Fluidité minimum retenue (rue complètement bouchée)
+    // Les civils se rangent devant une sirène : un bouchon ne ralentit qu'en partie les secours
+    static constexpr float CONGESTION_WEIGHT = 0.25f;
+    // Écart relatif au temps "rue vide" en dessous duquel un tronçon est considéré comme revenu au calme
+    static constexpr float SETTLED = 0.01f;
+
+    TravelTimes();
+
+    // Remet tous les tronçons au temps "rue vide" (après un changement de carte)
+    void Reset(const RoadGraph& graph);
+
+    // Mesure la vitesse des voitures sur chaque tronçon et met à jour les estimations.
+    // Renvoie true si au moins un tronçon a changé de plus que le seuil.
+    // Seuls les tronçons "actifs" (des voitures y roulent, ou leur estimation n'est pas
+    // encore revenue au temps rue vide) sont recalculés : le coût dépend du nombre de
+    // voitures, pas de la taille de la ville.
+    bool Sample(const VehicleStore& vehicles, const RoadGraph& graph);
+
+    // Temps estimé pour traverser chaque arête (en pas de simulation)
+    const std::vector<float>& Times() const { return smoothed; }
+
+    // Le tronçon "edge" a-t-il changé de plus que le seuil lors de la dernière mesure ?
+    bool Changed(int edge) const { return changedRound[edge] == round; }
+    int ChangedCount() const { return changedCount; }
+
+    // Sauvegarde : estimations, mesures en cours et tronçons actifs
+    void Save(StateWriter& out) const;
+    bool Load(StateReader& in);
+
+private:
+    std::vector<float> freeTime;     // Temps rue vide (longueur / FREE_SPEED)
+    std::vector<float> smoothed;     // Estimation lissée
+    std::vector<float> announced;    // Valeur au moment de la dernière annonce de changement
+    std::vector<float> flowSum;      // Somme des (vitesse / vitesse max) mesurées
+    std::vector<int> flowCount;      // Nombre de voitures mesurées
+    std::vector<uint32_t> changedRound;
+    std::vector<int> activeEdges;    // Tronçons à recalculer à la prochaine mesure
+    std::vector<uint8_t> isActive;   // Le tronçon est-il déjà dans activeEdges ?
+    uint32_t round;
+    int changedCount;
+};
+
+#endif
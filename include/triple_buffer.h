@@ -0,0 +1,88 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+// --- TRIPLE TAMPON SANS VERROU ---
+// Un thread écrit (la simulation), un autre lit (l'affichage), sans jamais s'attendre.
+// Trois exemplaires de T :
+//  - "écriture" : celui que l'écrivain remplit,
+//  - "milieu"   : le dernier exemplaire terminé, en attente d'être lu,
+//  - "lecture"  : celui que le lecteur est en train d'utiliser.
+// Publish() échange écriture et milieu, Consume() échange milieu et lecture :
+// chacun ne touche jamais l'exemplaire de l'autre. Si l'écrivain va plus vite,
+// les exemplaires non lus sont simplement remplacés par des plus récents.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : write(0), middle(1), read(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // --- CÔTÉ ÉCRIVAIN ---
+    T& WriteBuffer() { return slots[write]; }
+
+    // L'exemplaire d'écriture est terminé : il devient le plus récent à lire
+    void Publish() {
+        int old = middle.exchange(write | FRESH, std::memory_order_acq_rel);
+        write = old & INDEX;
+    }
+
+    // --- CÔTÉ LECTEUR ---
+    // Récupère l'exemplaire le plus récent s'il y en a un nouveau (sinon on garde l'ancien).
+    // Renvoie true si l'exemplaire de lecture a changé.
+    bool Consume() {
+        if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+        int old = middle.exchange(read, std::memory_order_acq_rel);
+        read = old & INDEX;
+        return true;
+    }
+
+    const T& ReadBuffer() const { return slots[read]; }
+
+    // Accès direct aux trois exemplaires (préparation avant de démarrer les threads)
+    T& Slot(int k) { return slots[k]; }
+
+private:
+    static const int INDEX = 3; // Les 2 bits du numéro d'exemplaire
+    static const int FRESH = 4; // Le milieu contient un exemplaire pas encore lu
+
+    T slots[3];
+    int write;               // Utilisé seulement par l'écrivain
+    std::atomic<int> middle; // Partagé : numéro du milieu + drapeau FRESH
+    int read;                // Utilisé seulement par le lecteur
+};
+
+// --- FILE DE COMMANDES SANS VERROU (UN ÉCRIVAIN, UN LECTEUR) ---
+// Anneau de taille fixe : l'interface pousse, la simulation retire.
+// Push() renvoie false si la file est pleine (la commande est alors perdue).
+template <typename T, size_t Capacity>
+class CommandQueue {
+public:
+    CommandQueue() : head(0), tail(0) {}
+
+    bool Push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false; // Pleine
+        items[t % Capacity] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false; // Vide
+        item = items[h % Capacity];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T items[Capacity];
+    std::atomic<size_t> head; // Prochaine case à lire (lecteur)
+    std::atomic<size_t> tail; // Prochaine case à écrire (écrivain)
+};
+
+#endif
@@ -2,53 +2,57 @@
 #define VEHICLE_H
 
 #include "config.h"
+#include "vehicle_store.h"
+#include "profiler.h"
 
-// La classe "Car" est le plan de construction pour toutes nos voitures.
-// Elle contient tout ce qu'une voiture sait (variables) et tout ce qu'elle sait faire (fonctions).
-class Car {
-public:
-    // --- POSITION ET MOUVEMENT ---
-    Vector2 pos;        // Position actuelle (X, Y) sur l'écran
-    Dir dir;            // Direction vers laquelle elle regarde (Haut, Bas, Gauche, Droite)
-    Type type;          // Son métier : CIVIL, POLICE, AMBULANCE ou POMPIER
-    float speed;        // Vitesse actuelle
-    float maxSpeed;     // Vitesse maximum autorisée pour ce véhicule
-    bool active;        // Si "false", la voiture est sortie de l'écran et doit être supprimée
-
-    // --- NAVIGATION (GPS) ---
-    Vector2 target;     // La destination précise où elle essaie d'aller
-    bool hasTarget;     // Est-ce qu'elle a une destination définie ? (Vrai/Faux)
-    float stuckTimer;   // Chrono pour détecter si la voiture est coincée dans un mur ou un bouchon
-    float turnCooldown; // Petit délai pour l'empêcher de changer de direction trop vite (éviter qu'elle tremble)
-    float actionTimer;  // Compte le temps d'une intervention (ex: temps pour éteindre un feu)
-
-    // --- GESTION DES URGENCES ---
-    EmergencyState emState; // État du cerveau (Au repos, En route, Sur place, Rentre à la base...)
-    Vector2 homeCenter;     // Le centre de son bâtiment de base (Commissariat, Hôpital...)
-    Vector2 homeEntry;      // Le point précis où elle doit entrer pour se garer
-    
-    bool isYielding;        // Vrai si c'est une voiture civile qui se range sur le côté pour laisser passer les secours
-
-    // --- FONCTIONS (ACTIONS) ---
-
-    // Constructeur : C'est la fonction appelée quand on crée une nouvelle voiture ("new Car")
-    Car(Type t, const std::vector<Car*>& existingCars);
-
-    // Renvoie le rectangle physique de la voiture (utile pour savoir si on touche quelque chose)
-    Rectangle GetRect() const;
-
-    // Outil de calcul (statique) pour obtenir un rectangle sans avoir besoin de l'objet voiture complet
-    static Rectangle GetRectInternal(Vector2 p, Dir d);
-
-    // Renvoie la zone devant la voiture (ses "yeux") pour détecter les obstacles ou feux rouges
-    Rectangle GetSensor() const;
-
-    // LE CERVEAU : C'est ici que tout se décide (avancer, freiner, tourner...)
-    // Appelée 60 fois par seconde.
-    void Update(LightCycle cycle, const std::vector<Car*>& cars, bool isNight);
-
-    // L'AFFICHAGE : C'est ici qu'on dessine le rectangle coloré et les phares
-    void Draw(bool isNight);
-};
-
-#endif
\ No newline at end of file
+class Simulation; // Déclarée dans simulation.h (on a seulement besoin de son nom ici)
+
+// --- LES VOITURES ---
+// Les données de toutes les voitures sont rangées dans un VehicleStore (vehicle_store.h).
+// Une voiture est désignée par son numéro de case "i" dans ce stockage.
+// Ce fichier contient tout ce qu'une voiture sait faire (fonctions).
+
+// --- APPARITION ---
+
+// C'est ici qu'une voiture naît.
+// Si c'est une voiture de SECOURS, elle apparaît dans son garage.
+// Si c'est une voiture CIVILE, elle apparaît sur une voie libre au hasard, au bord de la ville
+// (ou dedans, voir interiorSpawnShare), choisie par Simulation::spawnPlaces.
+// Renvoie son numéro de case, ou -1 si elle n'a pas pu être placée (aucune voie libre, stockage plein).
+int SpawnVehicle(Simulation& sim, Type t);
+
+// Fait sortir un véhicule de secours du bâtiment "station" (sans mission : il sort devant
+// le garage, puis rentre si le répartiteur ne lui donne rien). Renvoie -1 si le stockage est plein.
+int SpawnUnit(Simulation& sim, const Building& station);
+
+// Apparition directe : pose la voiture à un endroit précis sans chercher de place
+// (remplissage de la ville pour les tests de charge). Renvoie -1 si le stockage est plein.
+int PlaceVehicle(Simulation& sim, Type t, Vector2 p, Dir d);
+
+// --- GÉOMÉTRIE ---
+
+// Renvoie le rectangle physique d'une voiture (plus longue que large) selon sa direction
+Rectangle GetCarRect(Vector2 p, Dir d);
+
+// Renvoie la zone devant la voiture (ses "yeux") pour détecter les obstacles ou feux rouges
+Rectangle GetCarSensor(Vector2 p, Dir d, float speed, Type type);
+
+// --- COMPORTEMENT ---
+
+// LE CERVEAU : C'est ici que tout se décide (avancer, freiner, tourner...) pour la voiture "i".
+// Appelée à chaque pas de simulation (dt = durée du pas en secondes).
+// "counters" : compteurs du paquet de voitures en cours (tests de collision, freinages...)
+// = PlanVehicle puis MoveVehicles sur cette seule voiture.
+void UpdateVehicle(Simulation& sim, int i, float dt, CarCounters& counters);
+
+// La même chose en deux temps, pour faire bouger les voitures par paquets (motion_kernels.h) :
+// 1. PlanVehicle décide (mission, virage, vitesse voulue, voie) et range la décision dans
+//    Simulation::planSpeed / planLane / planFlags, sans encore bouger la voiture ;
+// 2. MoveVehicles applique les décisions des voitures [first, first + count) :
+//    vitesse, avance, maintien de la voie, sortie de la ville.
+void PlanVehicle(Simulation& sim, int i, float dt, CarCounters& counters);
+void MoveVehicles(Simulation& sim, int first, int count);
+
+// L'AFFICHAGE (DrawVehicle) est dans render.h : seul le programme fenêtré dessine.
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef VEHICLE_STORE_H
+#define VEHICLE_STORE_H
+
+#include "config.h"
+#include <cstdint>
+
+class StateWriter;
+class StateReader;
+
+// --- POIGNÉE STABLE VERS UN VÉHICULE ---
+// Le numéro de case (slot) d'une voiture change quand une autre voiture est supprimée
+// (on bouche le trou avec la dernière). Pour garder une référence durable vers un
+// véhicule de secours, on utilise une poignée : elle reste valable tant que le véhicule existe.
+struct VehicleHandle {
+    uint32_t index;      // Numéro dans la table des poignées
+    uint32_t generation; // Numéro de "vie" : change quand la poignée est réutilisée
+};
+
+const VehicleHandle INVALID_VEHICLE = { 0xFFFFFFFFu, 0 };
+
+// --- STOCKAGE DES VÉHICULES (STRUCTURE DE TABLEAUX) ---
+// Au lieu d'une liste de pointeurs vers des objets "Car" éparpillés en mémoire,
+// chaque information a son propre tableau contigu : tous les "pos" à la suite,
+// tous les "speed" à la suite, etc. La voiture numéro i est la case i de chaque tableau.
+// - Les parcours (mise à jour, dessin, mini-carte) lisent la mémoire dans l'ordre.
+// - Toute la place est réservée au départ (Reserve) : aucune allocation pendant le jeu.
+// - Suppression en O(1) : la dernière voiture vient boucher le trou ("swap-remove").
+class VehicleStore {
+public:
+    // --- POSITION ET MOUVEMENT ---
+    std::vector<Vector2> pos;          // Position actuelle (X, Y)
+    std::vector<Vector2> prevPos;      // Position au début du pas (l'affichage glisse de l'une à l'autre)
+    std::vector<Dir> dir;              // Direction vers laquelle elle regarde
+    std::vector<Type> type;            // Son métier : CIVIL, POLICE, AMBULANCE ou POMPIER
+    std::vector<float> speed;          // Vitesse actuelle
+    std::vector<float> maxSpeed;       // Vitesse maximum autorisée pour ce véhicule
+    std::vector<uint8_t> active;       // Si 0, la voiture doit être supprimée à la fin du pas
+
+    // --- NAVIGATION (GPS) ---
+    std::vector<Vector2> target;       // La destination précise où elle essaie d'aller
+    std::vector<uint8_t> hasTarget;    // Est-ce qu'elle a une destination définie ?
+    std::vector<float> stuckTimer;     // Chrono pour détecter si la voiture est coincée
+    std::vector<float> turnCooldown;   // Petit délai entre deux virages (éviter qu'elle tremble)
+    std::vector<float> actionTimer;    // Temps d'une intervention (ex: éteindre un feu)
+
+    // --- GESTION DES URGENCES ---
+    std::vector<EmergencyState> emState; // État du cerveau (Au repos, En route, Sur place...)
+    std::vector<Vector2> homeCenter;     // Le centre de son bâtiment de base
+    std::vector<Vector2> homeEntry;      // Le point précis où elle doit entrer pour se garer
+    std::vector<long long> dispatchTick; // Pas de simulation où le secours a été envoyé
+    std::vector<int> incident;           // Case de l'incident confié (IncidentTable), -1 si aucun
+
+    // --- ITINÉRAIRE (SECOURS) ---
+    // Liste des carrefours à traverser, calculée par A* (voir road_graph.h).
+    // Quand une voiture change de case, on échange les listes : pas de copie ni d'allocation.
+    std::vector<std::vector<int>> route; // Carrefours de l'itinéraire, dans l'ordre
+    std::vector<int> routeStep;          // Numéro du prochain carrefour à atteindre dans "route"
+    std::vector<Vector2> routeGoal;      // Destination pour laquelle l'itinéraire a été calculé
+    std::vector<uint8_t> hasRoute;       // 0 = pas d'itinéraire valable (à recalculer)
+
+    std::vector<uint8_t> isYielding;     // Civil qui se range pour laisser passer les secours
+    std::vector<int> signalNode;         // Carrefour vers lequel roule le civil (-1 : aucun), voir SignalSystem
+
+    VehicleStore();
+
+    // Réserve la place pour "capacity" véhicules (tous les tableaux d'un coup)
+    void Reserve(int capacity);
+
+    int Size() const { return count; }        // Nombre de véhicules vivants (cases 0 à Size()-1)
+    int Capacity() const { return capacity; } // Nombre maximum de véhicules
+
+    // Ajoute un véhicule à la fin avec les valeurs de départ de son type.
+    // Renvoie son numéro de case, ou -1 si le stockage est plein.
+    int Add(Type t);
+
+    // Supprime le véhicule de la case "slot" (la dernière voiture prend sa place)
+    void RemoveAt(int slot);
+
+    // Supprime tous les véhicules marqués inactifs (à appeler hors des boucles de mise à jour)
+    // Renvoie le nombre de véhicules supprimés.
+    int RemoveInactive();
+
+    // Vide complètement le stockage (la place réservée est gardée)
+    void Clear();
+
+    // Poignée stable du véhicule de la case "slot"
+    VehicleHandle HandleAt(int slot) const;
+
+    // Case actuelle d'un véhicule, ou -1 s'il n'existe plus
+    int SlotOf(VehicleHandle handle) const;
+
+    // Sauvegarde : les colonnes des Size() véhicules et la table des poignées.
+    // Load() lit chaque colonne d'un bloc dans la place réservée (agrandie si besoin).
+    // Check() fait les mêmes vérifications sans rien changer (les colonnes sont sautées).
+    void Save(StateWriter& out) const;
+    bool Load(StateReader& in);
+    bool Check(StateReader& in) const;
+
+private:
+    int count;
+    int capacity;
+
+    // Table des poignées : case <-> poignée
+    std::vector<uint32_t> handleOfSlot; // case -> numéro de poignée
+    std::vector<uint32_t> slotOfHandle; // numéro de poignée -> case
+    std::vector<uint32_t> generations;  // numéro de poignée -> génération actuelle
+    std::vector<uint32_t> freeHandles;  // Poignées libres (utilisées comme une pile)
+
+    // Copie toutes les colonnes de la case "from" vers la case "to"
+    void MoveSlot(int from, int to);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define WORLD_H
 
 #include "config.h"
+#include "random.h"
 
 // --- VARIABLES PARTAGÉES (GLOBALES) ---
 // Le mot "extern" est une étiquette qui dit au programme :
@@ -12,22 +13,134 @@ extern std::vector<float> vRoads;       // La liste des positions (X) de toutes
 extern std::vector<float> hRoads;       // La liste des positions (Y) de toutes les routes horizontales
 extern std::vector<Building> buildings; // La liste de tous les bâtiments posés sur la carte
 
+// Limite de vitesse de chaque route, en pixels par pas comme maxSpeed (0 = pas de limite).
+// Même taille que vRoads / hRoads. Seuls les civils la respectent (les secours ont la priorité).
+extern std::vector<float> vRoadLimits;
+extern std::vector<float> hRoadLimits;
+
+// Tronçons fermés (impasses, rues coupées) : une case par carrefour, dans l'ordre du graphe
+// routier (ligne * nombre de routes verticales + colonne). CLOSED_DOWN : le tronçon vers le
+// carrefour du dessous est fermé ; CLOSED_RIGHT : celui vers le carrefour de droite.
+// Vide = tout est ouvert (ville construite par RecalculateGrid).
+enum ClosedSegment : uint8_t { CLOSED_DOWN = 1, CLOSED_RIGHT = 2 };
+extern std::vector<uint8_t> closedSegments;
+
+// Lieux possibles d'un incendie : les coins des pâtés de maisons, hors bâtiments de secours.
+// Calculés une fois à chaque construction de la ville (BuildFireSites) : le générateur de
+// charge tire directement un lieu dans cette table.
+extern std::vector<Vector2> fireSites;
+
+// --- INDEX DES ROUTES (recherche en temps constant) ---
+// Reconstruit par RecalculateGrid. Sur une grille régulière (routes également espacées),
+// la route la plus proche se calcule directement par une division : O(1), quel que soit
+// le nombre de routes. Si l'espacement n'est pas régulier, on passe par une recherche
+// dichotomique (O(log n)). Le résultat est toujours le même que le parcours de GetSnapAxis.
+class RoadAxisIndex {
+public:
+    RoadAxisIndex();
+
+    // Prépare l'index pour une liste de routes triée (vRoads ou hRoads)
+    void Build(const std::vector<float>& roads);
+
+    // Numéro de la route la plus proche de "val" (-1 s'il n'y a aucune route).
+    // En cas d'égalité parfaite, la première route gagne (comme GetSnapAxis).
+    int Nearest(float val) const;
+
+    // Position de la route la plus proche ("val" s'il n'y a aucune route)
+    float Snap(float val) const;
+
+    // Tronçon sur lequel se trouve "val" : nombre de routes avant lui.
+    // 0 = avant la première route, k = entre la route k-1 et la route k, Count() = après la dernière.
+    int Segment(float val) const;
+
+    int Count() const { return (int)axes.size(); }
+    bool IsUniform() const { return uniform; }
+
+private:
+    std::vector<float> axes; // Copie des positions des routes (triées)
+    bool uniform;            // Espacement régulier ? (calcul direct)
+    float first;             // Position de la première route
+    float invSpacing;        // 1 / espacement entre deux routes
+
+    int Estimate(float val) const; // Dernière route avant "val", à une route près
+};
+
+extern RoadAxisIndex vRoadIndex; // Index des routes verticales (positions X)
+extern RoadAxisIndex hRoadIndex; // Index des routes horizontales (positions Y)
+
+extern float worldWidth;  // Largeur du monde (la fenêtre en mode graphique, fixe en mode headless)
+extern float worldHeight; // Hauteur du monde
+extern int worldVersion;  // Augmente à chaque RecalculateGrid (le dessin en cache sait qu'il doit se refaire)
+
 // --- FONCTIONS (OUTILS) ---
 
 // Outil mathématique : Trouve la route la plus proche d'une position donnée.
 // Ça sert à "aimanter" les voitures pour qu'elles restent bien au milieu de leur voie.
+// (Parcours de toute la liste : pour vRoads/hRoads, utiliser plutôt vRoadIndex/hRoadIndex)
 float GetSnapAxis(float val, const std::vector<float>& axes);
 
-// Outil graphique : Dessine une ligne pointillée (le marquage au sol jaune/blanc)
-void DrawDashedLine(Vector2 start, Vector2 end, float thick, Color color);
+// --- OÙ SUIS-JE SUR LA GRILLE ? ---
+struct RoadLocation {
+    int col;             // Route verticale la plus proche (numéro dans vRoads)
+    int row;             // Route horizontale la plus proche (numéro dans hRoads)
+    Vector2 roads;       // Position de ces deux routes (X de la verticale, Y de l'horizontale)
+    bool atIntersection; // Vrai si on est à moins de "radius" du croisement des deux
+};
+
+// Route verticale et horizontale les plus proches, et intersection éventuelle (O(1))
+RoadLocation LocateOnRoads(Vector2 pos, float radius);
+
+// Limite de vitesse de la route suivie en roulant dans la direction "d" (0 = pas de limite)
+float RoadSpeedLimit(const RoadLocation& here, Dir d);
+
+// Vrai si "pos" est sur un tronçon fermé d'une route verticale ("vertical") ou horizontale
+bool OnClosedSegment(Vector2 pos, bool vertical);
 
 // LA FONCTION MAJEURE : C'est l'architecte.
 // Elle efface tout et reconstruit la ville, les routes et les bâtiments.
-// On l'utilise au lancement du jeu ou quand on change la taille de la fenêtre.
-void RecalculateGrid();
+// (w, h) = taille du monde, barre latérale comprise : autant de pâtés de maisons
+// que la place le permet (ex : la taille de la fenêtre au lancement du jeu).
+void RecalculateGrid(int w, int h);
+
+// Construit une ville de "cols" x "rows" pâtés de maisons de TARGET_BLOCK_SIZE pixels,
+// en coordonnées du monde : la taille ne dépend plus de la fenêtre (la caméra montre
+// ensuite la partie voulue). Ex : BuildCity(200, 200) pour une très grande ville.
+void BuildCity(int cols, int rows);
+
+// Bâtiment de secours (hôpital, caserne, police) centré en "center", avec sa sortie
+// sur la route la plus proche. Les index des routes doivent déjà être à jour.
+Building MakeStation(Type type, Vector2 center, const char* label);
+
+// Fin commune de toute construction de la ville (RecalculateGrid, scénario, sauvegarde) :
+// une fois vRoads, hRoads, leurs limites et closedSegments remplis, reconstruit les index
+// des routes et le graphe routier, et change worldVersion (le dessin en cache se refait).
+void RebuildRoadNetwork();
+
+// Remplit fireSites d'après les routes et les bâtiments actuels (fin de RecalculateGrid,
+// du chargement d'un scénario ou d'une sauvegarde)
+void BuildFireSites();
+
+// --- SAUVEGARDE DE LA VILLE ---
+// Taille du monde, routes (limites et tronçons fermés compris) et bâtiments. LoadWorld remplace la ville actuelle (comme
+// RecalculateGrid : index des routes, graphe routier, worldVersion) ; à n'appeler que
+// quand personne ne dessine ni ne simule. CheckWorld lit et vérifie la section sans rien changer.
+class StateWriter;
+class StateReader;
+void SaveWorld(StateWriter& out);
+bool LoadWorld(StateReader& in);
+bool CheckWorld(StateReader& in);
+
+// Zone occupée par la ville : de la fin de la barre latérale (x = SIDEBAR_WIDTH)
+// jusqu'à (worldWidth, worldHeight). Les voitures qui en sortent trop loin disparaissent.
+Rectangle CityBounds();
 
 // Outil de hasard : Trouve un point aléatoire sur une route.
 // C'est utilisé pour décider où va se déclencher le prochain incendie ou accident.
-Vector2 GetRandomRoadTarget();
+Vector2 GetRandomRoadTarget(Random& rng);
+
+// Outil de hasard : Point de départ au milieu d'un tronçon (entre deux carrefours),
+// sur la bonne voie pour le sens "dir" tiré au hasard. Sert à faire naître des civils
+// à l'intérieur d'une grande ville, et pas seulement sur ses bords.
+Vector2 GetRandomRoadOrigin(Random& rng, Dir& dir);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef YIELD_FIELD_H
+#define YIELD_FIELD_H
+
+#include "config.h"
+#include <cstdint>
+
+class VehicleStore;
+
+// --- CHAMP DE PROXIMITÉ DES SECOURS ("YIELD FIELD") ---
+// Une fois par pas de simulation, on range les véhicules de secours EN MISSION dans de
+// grandes cases de la taille de YIELD_RADIUS (liste triée par case).
+// Ensuite, chaque civil ne regarde que les secours des 3 x 3 cases autour de lui
+// (en général aucun ou un seul) et mesure la vraie distance, au lieu de parcourir
+// toutes les voitures. Le coût de construction dépend seulement du nombre de secours
+// en mission (tri de quelques éléments), jamais du nombre de civils ni de la taille de la ville.
+class YieldField {
+public:
+    static constexpr float YIELD_RADIUS = 250.0f; // Distance à laquelle un civil se range
+    static constexpr float CELL_SIZE = YIELD_RADIUS; // Taille d'une case : un disque touche au plus 3 x 3 cases
+
+    YieldField();
+
+    // Range les secours actifs en mission par case (à appeler une fois par pas)
+    void Build(const VehicleStore& vehicles);
+
+    // Vrai si la position "p" est à moins de YIELD_RADIUS d'un véhicule de secours en mission
+    bool Contains(Vector2 p) const;
+
+private:
+    struct Unit {
+        uint64_t cell; // Case du secours (voir Key)
+        Vector2 pos;   // Position au début du pas
+    };
+    std::vector<Unit> units; // Secours en mission, triés par case (place gardée d'un pas à l'autre)
+    Rectangle reach;         // Rectangle qui contient tous les disques (rejet rapide)
+
+    static uint64_t Key(int cx, int cy);
+};
+
+#endif
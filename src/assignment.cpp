@@ -0,0 +1,257 @@
+/**
+ * AFFECTATION OPTIMALE
+ * Algorithme des enchères pour répartir les véhicules de secours entre les incidents
+ * (voir assignment.h). Aucune allocation une fois les tampons à la bonne taille.
+ */
+
+#include "../include/assignment.h"
+#include <algorithm>
+#include <limits>
+
+int64_t AuctionSolver::ScaleFor(int n) {
+    int64_t s = MIN_SCALE;
+    while (s <= n) s *= 2;
+    return s;
+}
+
+// Tampons à la taille du problème ; les listes courtes sont gardées si n n'a pas changé
+void AuctionSolver::Prepare(int n) {
+    scale = ScaleFor(n);
+    if ((int)shortValid.size() != n) shortValid.assign(n, 0);
+    shortObjects.resize((size_t)n * SHORTLIST);
+    shortBenefit.resize((size_t)n * SHORTLIST);
+    shortBound.resize(n);
+}
+
+void AuctionSolver::Solve(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                          std::vector<int>& personObject, bool warm) {
+    bids = 0;
+    if (!warm) personObject.assign(n, -1);
+    personObject.resize(n, -1);
+    if (n == 0) return;
+    prices.resize(n, 0);
+    Prepare(n);
+    // Les gains ont changé depuis le dernier calcul : aucune liste courte n'est valable
+    shortValid.assign(n, 0);
+
+    // Epsilon de départ : à froid, grand (les prix montent vite), puis divisé par 8 à chaque phase.
+    // À chaud, les prix sont déjà presque bons : on repart d'un epsilon moyen (8 x l'échelle),
+    // assez grand pour éviter les "guerres de prix" entre deux incidents qui veulent le même véhicule.
+    int64_t eps = 8 * scale;
+    if (!warm) {
+        int64_t lo = benefit[0], hi = benefit[0];
+        for (int64_t b : benefit) { lo = std::min(lo, b); hi = std::max(hi, b); }
+        eps = std::max<int64_t>(1, (hi - lo) * scale / 8);
+    }
+    while (true) {
+        RunPhase(n, benefit, prices, personObject, eps);
+        if (eps == 1) break;
+        eps = std::max<int64_t>(1, eps / 8);
+    }
+    LowerPrices(n, prices);
+}
+
+// Le calcul précédent s'est fini à epsilon = 1 : toute personne gardée a un objet à moins de 1
+// de son meilleur choix. Après le changement, c'est encore vrai pour celles dont la ligne et
+// l'objet n'ont pas changé, à condition qu'aucune colonne changée ne leur rapporte plus que leur
+// objet : le prix d'une colonne changée est fixé juste assez haut pour cela. Il ne reste qu'à
+// revérifier les lignes changées et les propriétaires des colonnes changées, directement à
+// epsilon = 1 : d'habitude quelques enchères suffisent.
+void AuctionSolver::Update(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                           std::vector<int>& personObject, const std::vector<int>& rows, const std::vector<int>& columns) {
+    bids = 0;
+    if (n == 0) return;
+    Prepare(n);
+    objectOwner.assign(n, -1);
+    touched.assign(n, 0);
+    bidders.clear();
+    for (int i = 0; i < n; i++) {
+        if (personObject[i] >= 0) objectOwner[personObject[i]] = i;
+        else { touched[i] = 1; bidders.push_back(i); }
+    }
+    for (int r : rows) {
+        shortValid[r] = 0;
+        if (!touched[r]) { touched[r] = 1; bidders.push_back(r); }
+    }
+    for (int c : columns) {
+        int owner = objectOwner[c];
+        if (owner >= 0 && !touched[owner]) { touched[owner] = 1; bidders.push_back(owner); }
+    }
+    personValue.resize(n);
+    for (int i = 0; i < n; i++) {
+        if (!touched[i]) personValue[i] = benefit[(size_t)i * n + personObject[i]] * scale - prices[personObject[i]];
+    }
+
+    // Prix des colonnes changées : aucune personne gardée ne doit y gagner plus qu'avec son objet.
+    // Les listes courtes restent valables : la borne des objets hors liste monte si besoin.
+    // (Parcours ligne par ligne : la matrice est lue dans l'ordre de la mémoire.)
+    int changed = (int)columns.size();
+    if (changed > 0) {
+        columnPrice.assign(changed, std::numeric_limits<int64_t>::min());
+        for (int i = 0; i < n; i++) {
+            if (touched[i]) continue;
+            const int64_t* row = &benefit[(size_t)i * n];
+            for (int k = 0; k < changed; k++) columnPrice[k] = std::max(columnPrice[k], row[columns[k]] * scale - personValue[i]);
+        }
+        for (int k = 0; k < changed; k++) {
+            if (columnPrice[k] != std::numeric_limits<int64_t>::min()) prices[columns[k]] = columnPrice[k];
+        }
+        columnChanged.assign(n, 0);
+        for (int c : columns) columnChanged[c] = 1;
+        int listSize = std::min(n, SHORTLIST);
+        for (int i = 0; i < n; i++) {
+            if (!shortValid[i]) continue;
+            const int64_t* row = &benefit[(size_t)i * n];
+            int64_t bound = shortBound[i];
+            for (int c : columns) bound = std::max(bound, row[c] * scale - prices[c]);
+            shortBound[i] = bound;
+            const int* list = &shortObjects[(size_t)i * SHORTLIST];
+            int64_t* listBenefit = &shortBenefit[(size_t)i * SHORTLIST];
+            for (int k = 0; k < listSize; k++) {
+                if (columnChanged[list[k]]) listBenefit[k] = row[list[k]] * scale;
+            }
+        }
+    }
+
+    // Si deux personnes se disputent un objet, son prix monte de 1 en 1 ("guerre de prix") : au-delà
+    // de UPDATE_BID_LIMIT x n enchères, on repart comme Solve (epsilon à 8 x l'échelle, divisé par 8
+    // à chaque phase), en ne revérifiant toujours que les personnes qui ont enchéri pendant ce calcul.
+    RecheckBidders(n, benefit, prices, personObject, 1);
+    if (!RunAuction(n, benefit, prices, personObject, 1, true, (long long)UPDATE_BID_LIMIT * n)) {
+        for (int64_t eps = 8 * scale;; eps = std::max<int64_t>(1, eps / 8)) {
+            RecheckBidders(n, benefit, prices, personObject, eps);
+            RunAuction(n, benefit, prices, personObject, eps, true, std::numeric_limits<long long>::max());
+            if (eps == 1) break;
+        }
+    }
+    LowerPrices(n, prices);
+}
+
+// Update : les personnes de la liste gardent leur objet s'il est encore à moins d'epsilon du
+// meilleur choix, les autres (et celles qui attendaient déjà) enchérissent
+void AuctionSolver::RecheckBidders(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                                   std::vector<int>& personObject, int64_t eps) {
+    int best;
+    int64_t bestValue, secondValue;
+    waiting.clear();
+    for (size_t k = bidders.size(); k-- > 0;) {
+        int i = bidders[k];
+        int j = personObject[i];
+        if (j < 0) { waiting.push_back(i); continue; }
+        BestObjects(i, n, benefit, prices, best, bestValue, secondValue);
+        if (benefit[(size_t)i * n + j] * scale - prices[j] >= bestValue - eps) continue;
+        objectOwner[j] = -1;
+        personObject[i] = -1;
+        waiting.push_back(i);
+    }
+}
+
+// Prix ramenés au plus petit, pour qu'ils ne grimpent pas sans fin d'un calcul à l'autre :
+// toutes les valeurs montent d'autant, les bornes des listes courtes aussi
+void AuctionSolver::LowerPrices(int n, std::vector<int64_t>& prices) {
+    int64_t lowest = *std::min_element(prices.begin(), prices.begin() + n);
+    if (lowest == 0) return;
+    for (int j = 0; j < n; j++) prices[j] -= lowest;
+    for (int i = 0; i < n; i++) {
+        if (shortValid[i] && shortBound[i] != std::numeric_limits<int64_t>::min()) shortBound[i] += lowest;
+    }
+}
+
+// Meilleur objet de la personne i (gain - prix), et valeur du deuxième meilleur.
+// D'abord avec sa liste courte : les prix ne font que monter pendant un calcul, donc un objet
+// hors de la liste vaut au plus shortBound[i]. Si le meilleur de la liste dépasse strictement
+// cette borne et le deuxième l'atteint, c'est exactement le résultat du parcours complet.
+// Sinon on parcourt toute la ligne et on refait la liste (les SHORTLIST meilleurs objets).
+void AuctionSolver::BestObjects(int i, int n, const std::vector<int64_t>& benefit, const std::vector<int64_t>& prices,
+                                int& best, int64_t& bestValue, int64_t& secondValue) {
+    const int64_t* row = &benefit[(size_t)i * n];
+    int* list = &shortObjects[(size_t)i * SHORTLIST];
+    int64_t* listBenefit = &shortBenefit[(size_t)i * SHORTLIST];
+    int listSize = std::min(n, SHORTLIST);
+    if (shortValid[i]) {
+        best = -1;
+        bestValue = std::numeric_limits<int64_t>::min();
+        secondValue = bestValue;
+        for (int k = 0; k < listSize; k++) {
+            int j = list[k];
+            int64_t value = listBenefit[k] - prices[j];
+            if (value > bestValue || (value == bestValue && j < best)) {
+                secondValue = bestValue; bestValue = value; best = j;
+            } else if (value > secondValue) secondValue = value;
+        }
+        if (n == 1) secondValue = bestValue;
+        if (bestValue > shortBound[i] && secondValue >= shortBound[i]) return;
+    }
+
+    // Parcours complet : les SHORTLIST + 1 meilleures valeurs, triées (à valeur égale, le plus petit j d'abord)
+    int topObject[SHORTLIST + 1] = {};
+    int64_t topValue[SHORTLIST + 1] = {};
+    int count = 0;
+    int keep = std::min(n, SHORTLIST + 1);
+    for (int j = 0; j < n; j++) {
+        int64_t value = row[j] * scale - prices[j];
+        if (count == keep && value <= topValue[keep - 1]) continue;
+        int k = (count < keep) ? count++ : keep - 1;
+        while (k > 0 && topValue[k - 1] < value) { topValue[k] = topValue[k - 1]; topObject[k] = topObject[k - 1]; k--; }
+        topValue[k] = value;
+        topObject[k] = j;
+    }
+    best = topObject[0];
+    bestValue = topValue[0];
+    secondValue = (n == 1) ? bestValue : topValue[1]; // Un seul objet : on le prend au prix + epsilon
+    for (int k = 0; k < listSize; k++) { list[k] = topObject[k]; listBenefit[k] = row[topObject[k]] * scale; }
+    shortBound[i] = (n > SHORTLIST) ? topValue[SHORTLIST] : std::numeric_limits<int64_t>::min();
+    shortValid[i] = 1;
+}
+
+void AuctionSolver::RunPhase(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                             std::vector<int>& personObject, int64_t eps) {
+    // On garde les affectations encore "epsilon-bonnes" (l'objet vaut au moins le meilleur
+    // choix - epsilon aux prix actuels) : elles le restent pendant la phase, car le prix d'un
+    // objet ne monte que lorsqu'il change de propriétaire. Les autres personnes enchérissent.
+    objectOwner.assign(n, -1);
+    waiting.clear();
+    int best;
+    int64_t bestValue, secondValue;
+    for (int i = n - 1; i >= 0; i--) {
+        int j = personObject[i];
+        if (j >= 0 && j < n && objectOwner[j] < 0) {
+            BestObjects(i, n, benefit, prices, best, bestValue, secondValue);
+            if (benefit[(size_t)i * n + j] * scale - prices[j] >= bestValue - eps) { objectOwner[j] = i; continue; }
+        }
+        personObject[i] = -1;
+        waiting.push_back(i);
+    }
+    RunAuction(n, benefit, prices, personObject, eps, false, std::numeric_limits<long long>::max());
+}
+
+// Enchères des personnes en attente jusqu'à ce que chacune ait un objet (true), ou jusqu'à
+// "limit" enchères (false : il reste des personnes dans "waiting").
+// track = true (Update) : les personnes délogées s'ajoutent à la liste des enchérisseurs.
+bool AuctionSolver::RunAuction(int n, const std::vector<int64_t>& benefit, std::vector<int64_t>& prices,
+                               std::vector<int>& personObject, int64_t eps, bool track, long long limit) {
+    int best;
+    int64_t bestValue, secondValue;
+    long long start = bids;
+    while (!waiting.empty()) {
+        if (bids - start >= limit) return false;
+        int i = waiting.back();
+        waiting.pop_back();
+
+        // Meilleur objet (gain - prix) et valeur du deuxième meilleur
+        BestObjects(i, n, benefit, prices, best, bestValue, secondValue);
+
+        // Enchère : le prix monte juste assez pour que l'objet reste le meilleur choix
+        prices[best] += bestValue - secondValue + eps;
+        int previous = objectOwner[best];
+        if (previous >= 0) {
+            personObject[previous] = -1;
+            waiting.push_back(previous);
+            if (track && !touched[previous]) { touched[previous] = 1; bidders.push_back(previous); }
+        }
+        objectOwner[best] = i;
+        personObject[i] = best;
+        bids++;
+    }
+    return true;
+}
@@ -0,0 +1,429 @@
+/**
+ * MICRO-BENCHMARKS (smartcity_bench)
+ * Mesure le débit des fonctions chaudes de la simulation, toujours avec les mêmes
+ * graines et les mêmes villes, et écrit le résultat en JSON : on peut comparer deux
+ * versions du programme et repérer une régression de performance.
+ *
+ * Utilisation : smartcity_bench [--filter TEXTE] [--quick] [--min-time S] [--repetitions N]
+ *                               [--seed S] [--out FICHIER]
+ *
+ * Benchmarks (le paramètre est dans le nom, ex : "update_vehicles/10000") :
+ *   update_vehicles/N   UpdateVehicle sur N voitures (100 ... 100000), une passe = une itération
+ *   spawn_civilian/N    SpawnVehicle(CIVIL) dans une ville qui contient déjà N voitures, premier
+ *                       du pas (avec le marquage des places occupées, O(N))
+ *   spawn_burst/N       64 apparitions dans le même pas (coût par voiture une fois le pas marqué)
+ *   snap_axis/R         GetSnapAxis (parcours de la liste) sur R routes
+ *   snap_index/R        RoadAxisIndex::Snap (recherche directe) sur R routes, pour comparer
+ *   recalculate_grid/B  RecalculateGrid d'une ville de B x B pâtés de maisons
+ *   sim_step/N/T        Un pas complet de Simulation::Step, N voitures, T threads
+ *   sim_step/N/K        Le même pas sur 1 thread avec les noyaux K (choix du niveau par défaut)
+ *   integrate_motion/N/K   IntegrateMotion sur N voitures avec les noyaux K (scalar, sse2, avx2)
+ *   overlap_sensor/C/K     OverlapSensor : un capteur contre C voitures avec les noyaux K
+ * Avant de les mesurer, chaque version SIMD est comparée à la version scalaire (écart sur stderr).
+ */
+
+#include "../include/config.h"
+#include "../include/world.h"
+#include "../include/simulation.h"
+#include "../include/vehicle.h"
+#include "../include/motion_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- MESURE ---
+// Une fonction de benchmark fait "iterations" fois son travail et renvoie le temps (s)
+// qu'elle a mesuré elle-même : la préparation (ville, voitures) n'est pas comptée.
+typedef std::function<double(long long iterations)> BenchBody;
+
+struct BenchResult {
+    std::string name;
+    long long itemsPerIteration; // Éléments traités par itération (voitures, appels...)
+    long long iterations;        // Itérations d'une répétition
+    double bestNs;               // Meilleure répétition (ns par itération)
+    double meanNs;               // Moyenne des répétitions
+    double worstNs;
+};
+
+struct BenchOptions {
+    double minTime = 0.3;   // Durée minimale d'une répétition (s)
+    int repetitions = 5;
+    uint64_t seed = 42;
+    bool quick = false;     // Moins de tailles et des répétitions plus courtes (intégration continue)
+    const char* filter = nullptr;
+};
+
+static double Seconds(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+}
+
+// Nombre d'itérations augmenté jusqu'à remplir minTime, puis "repetitions" mesures
+static BenchResult Measure(const BenchOptions& opt, const std::string& name, long long items, const BenchBody& body) {
+    long long iterations = 1;
+    double elapsed = body(iterations);
+    while (elapsed < opt.minTime && iterations < (1LL << 30)) {
+        // On vise directement la bonne durée (au plus x10 d'un coup)
+        double factor = (elapsed > 0) ? std::min(10.0, opt.minTime * 1.2 / elapsed) : 10.0;
+        iterations = std::max(iterations + 1, (long long)(iterations * factor));
+        elapsed = body(iterations);
+    }
+
+    BenchResult r = { name, items, iterations, 1e300, 0, 0 };
+    for (int k = 0; k < opt.repetitions; k++) {
+        double ns = body(iterations) * 1e9 / iterations;
+        r.bestNs = std::min(r.bestNs, ns);
+        r.worstNs = std::max(r.worstNs, ns);
+        r.meanNs += ns / opt.repetitions;
+    }
+    fprintf(stderr, "%-28s %12.1f ns/iter %14.0f elements/s\n", name.c_str(), r.bestNs, items * 1e9 / r.bestNs);
+    return r;
+}
+
+// Ville à densité constante (~7 voitures par pâté de maisons, comme les autres benchmarks)
+static int BlocksFor(int cars) {
+    return std::max(2, (int)ceilf(sqrtf(cars / 7.0f)));
+}
+
+// --- BENCHMARKS ---
+
+// UpdateVehicle sur toutes les voitures. La grille et le champ "laisser passer" sont
+// reconstruits avant chaque passe (hors chrono), comme dans Simulation::UpdateCars.
+// Les voitures sorties de la ville pendant une passe sont supprimées ; pour que chaque passe
+// traite bien N voitures (le nombre affiché), on remet alors les voitures du départ.
+static BenchBody UpdateVehicles(const BenchOptions& opt, int cars, std::unique_ptr<Simulation>& sim) {
+    BuildCity(BlocksFor(cars), BlocksFor(cars));
+    sim.reset(new Simulation(cars + DEFAULT_VEHICLE_CAPACITY));
+    sim->SetSeed(opt.seed);
+    sim->PopulateCivilians(cars);
+    Simulation* s = sim.get();
+    std::shared_ptr<const VehicleStore> initial = std::make_shared<VehicleStore>(s->vehicles);
+    return [s, initial](long long iterations) {
+        double total = 0;
+        CarCounters counters;
+        for (long long it = 0; it < iterations; it++) {
+            s->grid.Build(s->vehicles);
+            s->yieldField.Build(s->vehicles);
+            int n = s->vehicles.Size();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < n; i++) UpdateVehicle(*s, i, SIM_DT, counters);
+            total += Seconds(start, std::chrono::steady_clock::now());
+            if (s->vehicles.RemoveInactive() > 0) s->vehicles = *initial; // Copie dans la place déjà réservée
+            s->tick++;
+        }
+        return total;
+    };
+}
+
+// Apparitions de civils ("burst" par pas), puis suppression des voitures créées
+// (hors chrono) : la ville garde N voitures. Chaque itération est un nouveau pas,
+// donc la première apparition refait le marquage des places occupées.
+static BenchBody SpawnCivilian(const BenchOptions& opt, int cars, int burst, std::unique_ptr<Simulation>& sim) {
+    BuildCity(BlocksFor(cars), BlocksFor(cars));
+    sim.reset(new Simulation(cars + burst + DEFAULT_VEHICLE_CAPACITY));
+    sim->SetSeed(opt.seed);
+    sim->interiorSpawnShare = 0.5f;
+    sim->PopulateCivilians(cars);
+    Simulation* s = sim.get();
+    return [s, cars, burst](long long iterations) {
+        double total = 0;
+        for (long long it = 0; it < iterations; it++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < burst; k++) SpawnVehicle(*s, CIVIL);
+            total += Seconds(start, std::chrono::steady_clock::now());
+            while (s->vehicles.Size() > cars) s->vehicles.RemoveAt(s->vehicles.Size() - 1);
+            s->tick++;
+        }
+        return total;
+    };
+}
+
+// Positions à chercher : tirées une fois pour toutes (même graine = mêmes requêtes)
+static std::vector<float> SnapQueries(const BenchOptions& opt, const std::vector<float>& roads) {
+    Random rng(opt.seed, 1);
+    std::vector<float> queries(4096);
+    float span = roads.back() + roads.front();
+    for (float& q : queries) q = span * rng.Range(0, 1000000) / 1000000.0f;
+    return queries;
+}
+
+static volatile float snapSink; // Empêche le compilateur de supprimer les appels
+
+static BenchBody SnapAxis(const BenchOptions& opt, int roadCount, bool indexed) {
+    BuildCity(roadCount, 2);
+    std::vector<float> queries = SnapQueries(opt, vRoads);
+    return [queries, indexed](long long iterations) {
+        float sum = 0;
+        size_t q = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long long it = 0; it < iterations; it++) {
+            sum += indexed ? vRoadIndex.Snap(queries[q]) : GetSnapAxis(queries[q], vRoads);
+            q = (q + 1) & (queries.size() - 1);
+        }
+        double elapsed = Seconds(start, std::chrono::steady_clock::now());
+        snapSink = sum;
+        return elapsed;
+    };
+}
+
+static BenchBody RecalculateCity(int blocks) {
+    return [blocks](long long iterations) {
+        int w = SIDEBAR_WIDTH + (int)(blocks * TARGET_BLOCK_SIZE);
+        int h = (int)(blocks * TARGET_BLOCK_SIZE);
+        auto start = std::chrono::steady_clock::now();
+        for (long long it = 0; it < iterations; it++) RecalculateGrid(w, h);
+        return Seconds(start, std::chrono::steady_clock::now());
+    };
+}
+
+// Pas complet (feux, incidents, répartiteur, apparitions, voitures...) avec le mode
+// double tampon pour que 1 et T threads fassent exactement le même calcul
+static BenchBody SimStep(const BenchOptions& opt, int cars, int threads, std::unique_ptr<Simulation>& sim) {
+    BuildCity(BlocksFor(cars), BlocksFor(cars));
+    sim.reset(new Simulation(cars + DEFAULT_VEHICLE_CAPACITY));
+    sim->SetSeed(opt.seed);
+    sim->interiorSpawnShare = 0.5f;
+    sim->doubleBuffered = true;
+    sim->SetThreadCount(threads);
+    sim->maxCivilians = sim->PopulateCivilians(cars);
+    Simulation* s = sim.get();
+    return [s](long long iterations) {
+        auto start = std::chrono::steady_clock::now();
+        s->Run((int)iterations, SIM_DT);
+        return Seconds(start, std::chrono::steady_clock::now());
+    };
+}
+
+// --- NOYAUX SIMD (motion_kernels.h) ---
+// Voitures au hasard (toujours les mêmes pour une graine) : positions, vitesses, directions,
+// décisions, et une voiture sur 16 qui ne bouge pas (MOTION_SKIP)
+struct MotionData {
+    std::vector<Vector2> pos;
+    std::vector<float> speed, desired, lane;
+    std::vector<Dir> dir;
+    std::vector<uint8_t> flags, outside;
+};
+
+static MotionData RandomMotion(uint64_t seed, int cars) {
+    Random rng(seed, 0x4B45524EULL); // Flux propre au benchmark
+    MotionData m;
+    m.pos.resize(cars); m.speed.resize(cars); m.desired.resize(cars); m.lane.resize(cars);
+    m.dir.resize(cars); m.flags.resize(cars); m.outside.resize(cars);
+    for (int k = 0; k < cars; k++) {
+        m.pos[k] = { (float)rng.Range(-50, 2050), (float)rng.Range(-50, 2050) };
+        m.speed[k] = rng.Range(0, 400) / 100.0f;
+        m.desired[k] = (rng.Range(0, 3) == 0) ? -1.0f : rng.Range(0, 500) / 100.0f;
+        m.dir[k] = (Dir)rng.Range(UP, NONE);
+        m.lane[k] = ((m.dir[k] == UP || m.dir[k] == DOWN) ? m.pos[k].x : m.pos[k].y) + rng.Range(-20, 20);
+        m.flags[k] = (rng.Range(0, 15) == 0) ? MOTION_SKIP : 0;
+    }
+    return m;
+}
+
+static const Rectangle BENCH_CITY = { 0, 0, 2000, 2000 };
+
+// Plus grand écart entre le noyau "level" et le noyau scalaire (positions, vitesses, sorties,
+// capteurs) sur quelques pas : 0 attendu, les versions font les mêmes calculs
+static double KernelDifference(uint64_t seed, KernelLevel level) {
+    const int cars = 4099; // Pas un multiple de 8 : la fin scalaire est testée aussi
+    MotionData ref = RandomMotion(seed, cars), simd = ref;
+    double worst = 0;
+    for (int step = 0; step < 8; step++) {
+        SetKernelLevel(KERNEL_SCALAR);
+        IntegrateMotion(ref.pos.data(), ref.speed.data(), ref.dir.data(), ref.desired.data(), ref.lane.data(),
+                        ref.flags.data(), cars, BENCH_CITY, ref.outside.data());
+        SetKernelLevel(level);
+        IntegrateMotion(simd.pos.data(), simd.speed.data(), simd.dir.data(), simd.desired.data(), simd.lane.data(),
+                        simd.flags.data(), cars, BENCH_CITY, simd.outside.data());
+    }
+    for (int k = 0; k < cars; k++) {
+        worst = std::max(worst, (double)fabsf(ref.pos[k].x - simd.pos[k].x));
+        worst = std::max(worst, (double)fabsf(ref.pos[k].y - simd.pos[k].y));
+        worst = std::max(worst, (double)fabsf(ref.speed[k] - simd.speed[k]));
+        if (ref.outside[k] != simd.outside[k]) worst = std::max(worst, 1.0);
+    }
+    // Capteurs : 1000 capteurs contre des paquets de 1 à 32 voitures
+    Random rng(seed, 0x53454E53ULL);
+    int ids[SENSOR_BATCH];
+    for (int q = 0; q < 1000; q++) {
+        Rectangle sensor = { (float)rng.Range(0, 2000), (float)rng.Range(0, 2000), (float)rng.Range(8, 200), (float)rng.Range(8, 200) };
+        int count = rng.Range(1, SENSOR_BATCH);
+        for (int k = 0; k < count; k++) ids[k] = rng.Range(0, cars - 1);
+        SetKernelLevel(KERNEL_SCALAR);
+        uint32_t expected = OverlapSensor(sensor, ref.pos.data(), ref.dir.data(), ids, count);
+        SetKernelLevel(level);
+        if (OverlapSensor(sensor, ref.pos.data(), ref.dir.data(), ids, count) != expected) worst = std::max(worst, 1.0);
+    }
+    return worst;
+}
+
+static BenchBody IntegrateKernel(const BenchOptions& opt, int cars) {
+    std::shared_ptr<MotionData> m = std::make_shared<MotionData>(RandomMotion(opt.seed, cars));
+    return [m, cars](long long iterations) {
+        auto start = std::chrono::steady_clock::now();
+        for (long long it = 0; it < iterations; it++) {
+            IntegrateMotion(m->pos.data(), m->speed.data(), m->dir.data(), m->desired.data(), m->lane.data(),
+                            m->flags.data(), cars, BENCH_CITY, m->outside.data());
+        }
+        return Seconds(start, std::chrono::steady_clock::now());
+    };
+}
+
+static volatile uint32_t overlapSink; // Empêche le compilateur de supprimer les appels
+
+// Une itération = 1024 capteurs, chacun contre "count" voitures prises au hasard
+static BenchBody OverlapKernel(const BenchOptions& opt, int count) {
+    const int queries = 1024;
+    std::shared_ptr<MotionData> m = std::make_shared<MotionData>(RandomMotion(opt.seed, 10000));
+    std::shared_ptr<std::vector<Rectangle>> sensors = std::make_shared<std::vector<Rectangle>>(queries);
+    std::shared_ptr<std::vector<int>> ids = std::make_shared<std::vector<int>>(queries * count);
+    Random rng(opt.seed, 0x53454E53ULL);
+    for (int q = 0; q < queries; q++) {
+        (*sensors)[q] = { (float)rng.Range(0, 2000), (float)rng.Range(0, 2000), 14.0f, (float)rng.Range(70, 200) };
+        for (int k = 0; k < count; k++) (*ids)[q * count + k] = rng.Range(0, 9999);
+    }
+    return [m, sensors, ids, count](long long iterations) {
+        uint32_t sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (long long it = 0; it < iterations; it++) {
+            for (int q = 0; q < queries; q++) {
+                sum += OverlapSensor((*sensors)[q], m->pos.data(), m->dir.data(), ids->data() + q * count, count);
+            }
+        }
+        double seconds = Seconds(start, std::chrono::steady_clock::now());
+        overlapSink = sum;
+        return seconds;
+    };
+}
+
+// --- JSON ---
+static void WriteJson(FILE* f, const BenchOptions& opt, const std::vector<BenchResult>& results) {
+    fprintf(f, "{\n");
+    fprintf(f, "  \"context\": {\n");
+    fprintf(f, "    \"seed\": %llu,\n", (unsigned long long)opt.seed);
+    fprintf(f, "    \"min_time_s\": %.3f,\n", opt.minTime);
+    fprintf(f, "    \"repetitions\": %d,\n", opt.repetitions);
+    fprintf(f, "    \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(f, "    \"kernels\": \"%s\",\n", KernelLevelName(DefaultKernelLevel()));
+    fprintf(f, "    \"kernels_available\": \"%s\",\n", KernelLevelName(BestKernelLevel()));
+#ifdef NDEBUG
+    fprintf(f, "    \"build\": \"release\",\n");
+#else
+    fprintf(f, "    \"build\": \"debug\",\n");
+#endif
+#ifdef __VERSION__
+    fprintf(f, "    \"compiler\": \"%s\"\n", __VERSION__);
+#else
+    fprintf(f, "    \"compiler\": \"unknown\"\n");
+#endif
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"benchmarks\": [\n");
+    for (size_t k = 0; k < results.size(); k++) {
+        const BenchResult& r = results[k];
+        fprintf(f, "    { \"name\": \"%s\", \"iterations\": %lld, \"items_per_iteration\": %lld, "
+                   "\"ns_per_iteration\": %.3f, \"ns_per_iteration_mean\": %.3f, \"ns_per_iteration_worst\": %.3f, "
+                   "\"items_per_second\": %.1f }%s\n",
+                r.name.c_str(), r.iterations, r.itemsPerIteration, r.bestNs, r.meanNs, r.worstNs,
+                r.itemsPerIteration * 1e9 / r.bestNs, (k + 1 < results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    const char* out = nullptr;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(argv[i], "--filter") == 0 && hasValue) opt.filter = argv[++i];
+        else if (strcmp(argv[i], "--quick") == 0) { opt.quick = true; opt.minTime = 0.05; opt.repetitions = 3; }
+        else if (strcmp(argv[i], "--min-time") == 0 && hasValue) opt.minTime = atof(argv[++i]);
+        else if (strcmp(argv[i], "--repetitions") == 0 && hasValue) opt.repetitions = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue) opt.seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--out") == 0 && hasValue) out = argv[++i];
+        else {
+            printf("Usage: %s [--filter TEXTE] [--quick] [--min-time S] [--repetitions N] [--seed S] [--out FICHIER]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    std::unique_ptr<Simulation> sim; // Simulation du benchmark en cours (libérée au suivant)
+    auto run = [&](const std::string& name, long long items, const std::function<BenchBody()>& setup) {
+        if (opt.filter && name.find(opt.filter) == std::string::npos) return;
+        BenchBody body = setup();
+        results.push_back(Measure(opt, name, items, body));
+        sim.reset();
+    };
+
+    std::vector<int> carCounts = { 100, 1000, 10000, 100000 };
+    std::vector<int> spawnCounts = { 100, 1000, 10000 };
+    std::vector<int> roadCounts = { 10, 100, 1000 };
+    std::vector<int> cityBlocks = { 5, 50, 200 };
+    std::vector<int> stepCars = { 1000, 10000, 100000 };
+    if (opt.quick) {
+        carCounts = { 100, 10000 };
+        spawnCounts = { 1000 };
+        roadCounts = { 10, 1000 };
+        cityBlocks = { 5, 50 };
+        stepCars = { 10000 };
+    }
+    int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int n : carCounts) {
+        run("update_vehicles/" + std::to_string(n), n, [&]() { return UpdateVehicles(opt, n, sim); });
+    }
+    for (int n : spawnCounts) {
+        run("spawn_civilian/" + std::to_string(n), 1, [&]() { return SpawnCivilian(opt, n, 1, sim); });
+        run("spawn_burst/" + std::to_string(n), 64, [&]() { return SpawnCivilian(opt, n, 64, sim); });
+    }
+    for (int r : roadCounts) {
+        run("snap_axis/" + std::to_string(r), 1, [&]() { return SnapAxis(opt, r, false); });
+        run("snap_index/" + std::to_string(r), 1, [&]() { return SnapAxis(opt, r, true); });
+    }
+    for (int b : cityBlocks) {
+        run("recalculate_grid/" + std::to_string(b), 1, [&]() { return RecalculateCity(b); });
+    }
+    for (int n : stepCars) {
+        run("sim_step/" + std::to_string(n) + "/1", n, [&]() { return SimStep(opt, n, 1, sim); });
+        if (maxThreads > 1) {
+            run("sim_step/" + std::to_string(n) + "/" + std::to_string(maxThreads), n,
+                [&]() { return SimStep(opt, n, maxThreads, sim); });
+        }
+    }
+
+    // Noyaux SIMD : chaque version disponible, d'abord comparée à la version scalaire
+    std::vector<int> kernelCars = opt.quick ? std::vector<int>{ 10000 } : std::vector<int>{ 1000, 10000, 100000 };
+    std::vector<int> overlapCounts = { 4, 8, 32 };
+    for (int l = KERNEL_SCALAR; l <= BestKernelLevel(); l++) {
+        KernelLevel level = (KernelLevel)l;
+        std::string suffix = std::string("/") + KernelLevelName(level);
+        if (level != KERNEL_SCALAR) {
+            fprintf(stderr, "Noyaux %s : ecart max avec le scalaire %g\n", KernelLevelName(level), KernelDifference(opt.seed, level));
+        }
+        SetKernelLevel(level);
+        for (int n : kernelCars) {
+            run("integrate_motion/" + std::to_string(n) + suffix, n, [&]() { return IntegrateKernel(opt, n); });
+        }
+        for (int c : overlapCounts) {
+            run("overlap_sensor/" + std::to_string(c) + suffix, 1024LL * c, [&]() { return OverlapKernel(opt, c); });
+        }
+        for (int n : stepCars) {
+            run("sim_step/" + std::to_string(n) + suffix, n, [&]() { return SimStep(opt, n, 1, sim); });
+        }
+    }
+    SetKernelLevel(DefaultKernelLevel());
+
+    // Résultat : JSON sur la sortie standard (ou dans --out), le suivi lisible sur stderr
+    FILE* f = out ? fopen(out, "w") : stdout;
+    if (!f) { fprintf(stderr, "Impossible d'ecrire %s\n", out); return 1; }
+    WriteJson(f, opt, results);
+    if (out) fclose(f);
+    return 0;
+}
@@ -0,0 +1,587 @@
+/**
+ * INCIDENTS ET RÉPARTITEUR
+ * Ce fichier tient la liste de tous les incidents en cours (incendies, accidents, vols)
+ * et décide quel véhicule de secours part vers lequel, par ordre de priorité.
+ */
+
+#include "../include/emergency.h"
+#include "../include/simulation.h"
+#include "../include/vehicle.h"
+#include "../include/world.h"
+#include "../include/state_file.h"
+#include <algorithm>
+#include <climits>
+
+Type ResponderFor(IncidentType type) {
+    if (type == INCIDENT_FIRE) return FIRE;
+    if (type == INCIDENT_ACCIDENT) return AMBULANCE;
+    return POLICE;
+}
+
+float WorkTimeFor(IncidentType type) {
+    if (type == INCIDENT_CRIME) return CRIME_WORK_TIME;
+    return 3.0f; // On arrose / on soigne pendant 3 secondes
+}
+
+float ArrivalRadiusFor(IncidentType type) {
+    // Le camion de pompiers arrose depuis la route, le feu est dans le pâté de maisons
+    return (type == INCIDENT_FIRE) ? 70.0f : 30.0f;
+}
+
+// --- TABLE DES INCIDENTS ---
+
+int IncidentTable::Open(IncidentType type, Vector2 pos, int priority, long long tick) {
+    int slot;
+    if (!freeSlots.empty()) { slot = freeSlots.back(); freeSlots.pop_back(); }
+    else { slot = (int)slots.size(); slots.emplace_back(); used.push_back(0); }
+
+    Incident& inc = slots[slot];
+    inc.id = nextId++;
+    inc.type = type;
+    inc.state = INCIDENT_WAITING;
+    inc.priority = priority;
+    inc.pos = pos;
+    inc.unit = INVALID_VEHICLE;
+    inc.reportedTick = tick;
+    inc.dispatchedTick = -1;
+    inc.arrivedTick = -1;
+    used[slot] = 1;
+    openCount++;
+    return slot;
+}
+
+void IncidentTable::Close(int slot) {
+    if (!IsOpen(slot)) return;
+    used[slot] = 0;
+    slots[slot].unit = INVALID_VEHICLE; // Plus aucun véhicule ne le reconnaît comme le sien
+    freeSlots.push_back(slot);
+    openCount--;
+}
+
+void IncidentTable::Clear() {
+    slots.clear();
+    used.clear();
+    freeSlots.clear();
+    nextId = 1;
+    openCount = 0;
+}
+
+bool IncidentTable::OpenNear(IncidentType type, Vector2 pos, float radius) const {
+    for (int k = 0; k < (int)slots.size(); k++) {
+        if (used[k] && slots[k].type == type && Vector2Distance(slots[k].pos, pos) < radius) return true;
+    }
+    return false;
+}
+
+Incident* IncidentTable::AssignedTo(const VehicleStore& vehicles, int vehicle) {
+    int slot = vehicles.incident[vehicle];
+    if (!IsOpen(slot)) return nullptr;
+    VehicleHandle h = vehicles.HandleAt(vehicle);
+    Incident& inc = slots[slot];
+    // La case a pu être fermée puis réutilisée : seule la poignée dit si c'est bien notre incident
+    if (inc.unit.index != h.index || inc.unit.generation != h.generation) return nullptr;
+    return &inc;
+}
+
+// --- RÉPARTITEUR ---
+
+Dispatcher::Dispatcher() : unitsPerStation(5), optimize(true) {
+    Clear();
+}
+
+void Dispatcher::Clear() {
+    queue = std::priority_queue<Entry>();
+    reported = 0;
+    dispatched = 0;
+    resolved = 0;
+    firstDispatches = 0;
+    waitTicks = 0;
+    redirected = 0;
+    responded = 0;
+    responseTicks = 0;
+    optimizerRuns = 0;
+    optimizerBids = 0;
+    peakOpen = 0;
+    dirty = false;
+    for (PriceMemory& m : memory) { m.prices.clear(); m.valid = false; }
+    for (BenefitCache& b : benefitCache) { b.n = 0; b.match.clear(); }
+}
+
+double Dispatcher::AverageWaitSeconds(float dt) const {
+    return firstDispatches ? (double)waitTicks / firstDispatches * dt : 0.0;
+}
+
+double Dispatcher::AverageResponseSeconds(float dt) const {
+    return responded ? (double)responseTicks / responded * dt : 0.0;
+}
+
+void Dispatcher::Report(Simulation& sim, int slot) {
+    const Incident& inc = sim.incidents.At(slot);
+    queue.push({ inc.priority, inc.reportedTick, inc.id, slot });
+    reported++;
+    dirty = true;
+    if (sim.incidents.OpenCount() > peakOpen) peakOpen = sim.incidents.OpenCount();
+}
+
+// L'entrée de la file correspond-elle encore à un incident qui attend ?
+bool Dispatcher::IsWaiting(const Simulation& sim, const Entry& e) const {
+    if (!sim.incidents.IsOpen(e.slot)) return false;
+    const Incident& inc = sim.incidents.At(e.slot);
+    return inc.id == e.id && inc.state == INCIDENT_WAITING;
+}
+
+void Dispatcher::Assign(Simulation& sim, int vehicle, int slot) {
+    VehicleStore& v = sim.vehicles;
+    Incident& inc = sim.incidents.At(slot);
+    if (inc.dispatchedTick < 0) { firstDispatches++; waitTicks += sim.tick - inc.reportedTick; }
+    inc.state = INCIDENT_ASSIGNED;
+    inc.unit = v.HandleAt(vehicle);
+    inc.dispatchedTick = sim.tick;
+
+    v.incident[vehicle] = slot;
+    v.target[vehicle] = inc.pos;
+    v.hasTarget[vehicle] = 1;
+    v.hasRoute[vehicle] = 0;               // Nouvel itinéraire vers l'incident
+    v.dispatchTick[vehicle] = sim.tick;    // Début du chrono du temps de réponse
+    if (v.emState[vehicle] == RETURNING) v.emState[vehicle] = ON_MISSION; // Demi-tour
+
+    dispatched++;
+}
+
+// Véhicules dehors de chaque bâtiment (un véhicule appartient au bâtiment dont il est sorti)
+void Dispatcher::CountFleet(const Simulation& sim) {
+    const VehicleStore& v = sim.vehicles;
+    fleet.assign(buildings.size(), 0);
+    for (int i = 0; i < v.Size(); i++) {
+        if (v.type[i] == CIVIL || !v.active[i]) continue;
+        for (size_t b = 0; b < buildings.size(); b++) {
+            if (buildings[b].center.x == v.homeCenter[i].x && buildings[b].center.y == v.homeCenter[i].y) { fleet[b]++; break; }
+        }
+    }
+}
+
+void Dispatcher::Dispatch(Simulation& sim) {
+    if (!optimize) { DispatchGreedy(sim); return; }
+
+    // Rien de neuf et pas encore l'heure du recalcul périodique : on garde les affectations
+    if (!dirty && sim.tick % REOPTIMIZE_PERIOD != 0) return;
+    if (sim.incidents.OpenCount() == 0) { dirty = false; return; }
+    dirty = false;
+
+    CountFleet(sim);
+    Optimize(sim, FIRE);
+    Optimize(sim, AMBULANCE);
+    Optimize(sim, POLICE);
+    RebuildQueue(sim);
+}
+
+// --- RÉPARTITION GLOUTONNE ---
+void Dispatcher::DispatchGreedy(Simulation& sim) {
+    if (queue.empty()) return;
+    VehicleStore& v = sim.vehicles;
+
+    // 1. Qui est libre ? Les véhicules qui rentrent (sans mission), et la place
+    // restante dans chaque bâtiment
+    for (auto& list : returning) list.clear();
+    for (int i = 0; i < v.Size(); i++) {
+        if (v.type[i] != CIVIL && v.active[i] && v.emState[i] == RETURNING && v.incident[i] < 0) {
+            returning[v.type[i]].push_back(i);
+        }
+    }
+    CountFleet(sim);
+
+    // 2. Les incidents par ordre de priorité : chacun prend le véhicule libre le plus proche
+    bool exhausted[4] = { false, false, false, false }; // Plus rien de libre pour ce métier
+    deferred.clear();
+    while (!queue.empty()) {
+        Entry e = queue.top();
+        queue.pop();
+        if (!IsWaiting(sim, e)) continue; // Déjà pris en charge ou fermé : entrée périmée
+        Vector2 where = sim.incidents.At(e.slot).pos;
+        Type t = ResponderFor(sim.incidents.At(e.slot).type);
+        if (exhausted[t]) { deferred.push_back(e); continue; }
+
+        // a) Le véhicule qui rentre le plus proche (distance à vol d'oiseau)
+        int bestUnit = -1;
+        float bestDist = 0;
+        std::vector<int>& idle = returning[t];
+        for (size_t k = 0; k < idle.size(); k++) {
+            float d = Vector2Distance(v.pos[idle[k]], where);
+            if (bestUnit < 0 || d < bestDist) { bestUnit = (int)k; bestDist = d; }
+        }
+        // b) Ou le bâtiment le plus proche qui a encore de la place
+        int bestStation = -1;
+        for (size_t b = 0; b < buildings.size(); b++) {
+            if (buildings[b].type != t || fleet[b] >= unitsPerStation) continue;
+            float d = Vector2Distance(buildings[b].entryPoint, where);
+            if ((bestUnit < 0 && bestStation < 0) || d < bestDist) { bestStation = (int)b; bestDist = d; }
+        }
+
+        if (bestStation >= 0) {
+            int i = SpawnUnit(sim, buildings[bestStation]);
+            if (i < 0) { exhausted[t] = true; deferred.push_back(e); continue; } // Stockage plein
+            fleet[bestStation]++;
+            Assign(sim, i, e.slot);
+        } else if (bestUnit >= 0) {
+            Assign(sim, idle[bestUnit], e.slot);
+            idle[bestUnit] = idle.back();
+            idle.pop_back();
+        } else {
+            exhausted[t] = true;
+            deferred.push_back(e);
+        }
+    }
+    // 3. Ceux qui n'ont rien eu retournent dans la file pour le pas suivant
+    for (const Entry& e : deferred) queue.push(e);
+}
+
+// --- AFFECTATION OPTIMALE D'UN MÉTIER ---
+// Personnes = incidents pas encore atteints, objets = véhicules disponibles.
+// Le problème est rendu carré (n x n) : les incidents en trop reçoivent un véhicule
+// "fictif" (pas servi pour l'instant, gain 0) et les véhicules en trop un incident
+// "fictif" (ils restent libres, gain 0).
+void Dispatcher::Optimize(Simulation& sim, Type type) {
+    VehicleStore& v = sim.vehicles;
+    IncidentTable& table = sim.incidents;
+    PriceMemory& mem = memory[type];
+
+    // 1. Les incidents pas encore atteints de ce métier
+    problemIncidents.clear();
+    for (int slot = 0; slot < table.SlotCount(); slot++) {
+        if (!table.IsOpen(slot)) continue;
+        const Incident& inc = table.At(slot);
+        if (ResponderFor(inc.type) != type) continue;
+        if (inc.state == INCIDENT_WAITING || inc.state == INCIDENT_ASSIGNED) problemIncidents.push_back(slot);
+    }
+    int incidentCount = (int)problemIncidents.size();
+    if (incidentCount == 0) return;
+
+    // 2. Les véhicules disponibles : qui rentrent, ou en route vers un incident pas encore atteint
+    candidates.clear();
+    for (int i = 0; i < v.Size(); i++) {
+        if (v.type[i] != type || !v.active[i]) continue;
+        EmergencyState st = v.emState[i];
+        bool available = false;
+        if (st == RETURNING) available = (v.incident[i] < 0);
+        else if (st == DEPLOYING || st == ON_MISSION) {
+            int slot = v.incident[i];
+            available = (slot < 0) || (table.AssignedTo(v, i) && table.At(slot).state == INCIDENT_ASSIGNED);
+        }
+        if (!available) continue;
+        VehicleHandle h = v.HandleAt(i);
+        int delay = (st == DEPLOYING) ? (int)(Vector2Distance(v.pos[i], v.homeEntry[i]) / 2.5f) : 0;
+        candidates.push_back({ i, -1, v.pos[i], delay, (1ull << 62) | ((uint64_t)h.generation << 32) | h.index });
+    }
+    //    ... et ceux qui pourraient encore sortir des bâtiments (sortie du garage à 2,5 px par pas)
+    for (size_t b = 0; b < buildings.size(); b++) {
+        if (buildings[b].type != type) continue;
+        int room = std::min(unitsPerStation - fleet[b], incidentCount);
+        int delay = (int)(Vector2Distance(buildings[b].center, buildings[b].entryPoint) / 2.5f);
+        for (int k = 0; k < room; k++) {
+            candidates.push_back({ -1, (int)b, buildings[b].entryPoint, delay, (2ull << 62) | ((uint64_t)b << 16) | (uint64_t)k });
+        }
+    }
+    int unitCount = (int)candidates.size();
+    if (unitCount == 0) return; // Personne de libre : les incidents attendent
+
+    // 3. Matrice des gains (n x n). Même problème qu'au calcul précédent (mêmes incidents,
+    //    mêmes candidats, même ordre) : on ne refait que ce qui a changé.
+    int n = std::max(incidentCount, unitCount);
+    BenefitCache& cache = benefitCache[type];
+    bool sameLayout = (cache.n == n && cache.incidentCount == incidentCount && cache.unitCount == unitCount);
+    for (int r = 0; r < incidentCount && sameLayout; r++) sameLayout = (cache.rowIds[r] == table.At(problemIncidents[r]).id);
+    for (int c = 0; c < unitCount && sameLayout; c++) sameLayout = (cache.columnKeys[c] == candidates[c].key);
+    if (!sameLayout) {
+        cache.n = n;
+        cache.incidentCount = incidentCount;
+        cache.unitCount = unitCount;
+        cache.rowIds.resize(incidentCount);
+        cache.rowCurrent.assign(incidentCount, -1);
+        cache.columnKeys.resize(unitCount);
+        cache.columnPos.resize(unitCount);
+        cache.columnDelay.resize(unitCount);
+        cache.benefit.assign((size_t)n * n, 0); // Lignes et colonnes fictives : gain 0
+    }
+    auto gain = [&](int r, int c) {
+        const Incident& inc = table.At(problemIncidents[r]);
+        const Candidate& u = candidates[c];
+        // Temps de trajet estimé : distance "en ville" (routes en grille) à pleine vitesse
+        float manhattan = fabsf(u.pos.x - inc.pos.x) + fabsf(u.pos.y - inc.pos.y);
+        int64_t eta = (int64_t)(manhattan / UNIT_STEP) + u.delay;
+        int64_t sticky = (u.vehicle >= 0 && u.vehicle == cache.rowCurrent[r]) ? STICKY_VALUE : 0;
+        return SERVE_VALUE + PRIORITY_VALUE * inc.priority - eta + sticky;
+    };
+    //    Lignes : nouvel incident, ou incident qui a changé de véhicule (le bonus se déplace)
+    rowChanged.assign(incidentCount, 0);
+    changedRows.clear();
+    changedColumns.clear();
+    for (int r = 0; r < incidentCount; r++) {
+        const Incident& inc = table.At(problemIncidents[r]);
+        int current = (inc.state == INCIDENT_ASSIGNED) ? v.SlotOf(inc.unit) : -1;
+        if (sameLayout && cache.rowCurrent[r] == current) continue;
+        cache.rowIds[r] = inc.id;
+        cache.rowCurrent[r] = current;
+        rowChanged[r] = 1;
+        changedRows.push_back(r);
+        int64_t* row = &cache.benefit[(size_t)r * n];
+        for (int c = 0; c < unitCount; c++) row[c] = gain(r, c);
+    }
+    //    Colonnes : nouveau candidat, ou véhicule qui a bougé (les lignes déjà refaites sont à jour)
+    for (int c = 0; c < unitCount; c++) {
+        const Candidate& u = candidates[c];
+        if (sameLayout && cache.columnPos[c].x == u.pos.x && cache.columnPos[c].y == u.pos.y &&
+            cache.columnDelay[c] == u.delay) continue;
+        cache.columnKeys[c] = u.key;
+        cache.columnPos[c] = u.pos;
+        cache.columnDelay[c] = u.delay;
+        changedColumns.push_back(c);
+        for (int r = 0; r < incidentCount; r++) {
+            if (!rowChanged[r]) cache.benefit[(size_t)r * n + c] = gain(r, c);
+        }
+    }
+
+    // 4. Prix de départ : ceux du calcul précédent pour les mêmes véhicules (warm start)
+    objectKeys.resize(n);
+    prices.assign(n, 0);
+    for (int c = 0; c < n; c++) {
+        objectKeys[c] = (c < unitCount) ? candidates[c].key : ((3ull << 62) | (uint64_t)(c - unitCount));
+        auto it = std::lower_bound(mem.prices.begin(), mem.prices.end(), std::make_pair(objectKeys[c], INT64_MIN));
+        if (it != mem.prices.end() && it->first == objectKeys[c]) prices[c] = it->second;
+    }
+    //    Même problème qu'au calcul précédent : les prix sont exactement ceux qu'il a rendus, on
+    //    repart de son affectation et le solveur ne reprend que les lignes et colonnes changées.
+    //    Sinon, affectation de départ : chaque incident garde son véhicule actuel (le solveur
+    //    ne fait enchérir que ceux dont le véhicule n'est plus un bon choix).
+    AuctionSolver& solver = cache.solver;
+    if (sameLayout && mem.valid && (int)cache.match.size() == n) {
+        solver.Update(n, cache.benefit, prices, cache.match, changedRows, changedColumns);
+    } else {
+        cache.match.assign(n, -1);
+        if (mem.valid) {
+            columnOf.assign(v.Size(), -1);
+            for (int c = 0; c < unitCount; c++) {
+                if (candidates[c].vehicle >= 0) columnOf[candidates[c].vehicle] = c;
+            }
+            for (int r = 0; r < incidentCount; r++) {
+                if (cache.rowCurrent[r] >= 0) cache.match[r] = columnOf[cache.rowCurrent[r]];
+            }
+        }
+        solver.Solve(n, cache.benefit, prices, cache.match, mem.valid);
+    }
+    const std::vector<int>& match = cache.match;
+    optimizerRuns++;
+    optimizerBids += solver.LastBids();
+
+    // On retient les prix (le solveur les a ramenés au plus petit)
+    mem.prices.clear();
+    for (int c = 0; c < n; c++) mem.prices.push_back({ objectKeys[c], prices[c] });
+    std::sort(mem.prices.begin(), mem.prices.end());
+    mem.valid = true;
+
+    // 5. Application : on détache d'abord les véhicules qui changent d'incident...
+    detached.clear();
+    for (int r = 0; r < incidentCount; r++) {
+        Incident& inc = table.At(problemIncidents[r]);
+        if (inc.state != INCIDENT_ASSIGNED) continue;
+        int current = v.SlotOf(inc.unit);
+        int c = match[r];
+        if (c < unitCount && candidates[c].vehicle == current) continue; // Même véhicule : rien à faire
+        if (current >= 0) { v.incident[current] = -1; detached.push_back(current); }
+        inc.state = INCIDENT_WAITING;
+        inc.unit = INVALID_VEHICLE;
+    }
+    // ... puis on donne à chaque incident son nouveau véhicule
+    for (int r = 0; r < incidentCount; r++) {
+        int slot = problemIncidents[r];
+        int c = match[r];
+        if (c >= unitCount || table.At(slot).state != INCIDENT_WAITING) continue;
+        const Candidate& u = candidates[c];
+        int vehicle = u.vehicle;
+        if (vehicle < 0) {
+            vehicle = SpawnUnit(sim, buildings[u.station]);
+            if (vehicle < 0) continue; // Stockage plein : l'incident attend
+            fleet[u.station]++;
+        } else if (v.incident[vehicle] < 0 && (v.emState[vehicle] == ON_MISSION || v.emState[vehicle] == DEPLOYING) &&
+                   std::find(detached.begin(), detached.end(), vehicle) != detached.end()) {
+            redirected++; // Détourné en route vers un autre incident
+        }
+        Assign(sim, vehicle, slot);
+    }
+    // Les véhicules détachés qui n'ont rien reçu rentrent à la base
+    for (int vehicle : detached) {
+        if (v.incident[vehicle] >= 0) continue;
+        v.target[vehicle] = v.homeEntry[vehicle];
+        v.hasRoute[vehicle] = 0;
+        if (v.emState[vehicle] == ON_MISSION) v.emState[vehicle] = RETURNING;
+    }
+}
+
+// La file ne contient plus que les incidents encore sans véhicule
+void Dispatcher::RebuildQueue(const Simulation& sim) {
+    queue = std::priority_queue<Entry>();
+    const IncidentTable& table = sim.incidents;
+    for (int slot = 0; slot < table.SlotCount(); slot++) {
+        if (!table.IsOpen(slot)) continue;
+        const Incident& inc = table.At(slot);
+        if (inc.state == INCIDENT_WAITING) queue.push({ inc.priority, inc.reportedTick, inc.id, slot });
+    }
+}
+
+void Dispatcher::OfferUnit(Simulation& sim, int vehicle) {
+    Type t = sim.vehicles.type[vehicle];
+    if (t == CIVIL) return;
+    dirty = true; // Un véhicule de plus : l'affectation optimale peut changer
+    // On cherche le plus urgent de son métier ; les autres entrées retournent dans la file
+    deferred.clear();
+    while (!queue.empty()) {
+        Entry e = queue.top();
+        queue.pop();
+        if (!IsWaiting(sim, e)) continue;
+        if (ResponderFor(sim.incidents.At(e.slot).type) == t) { Assign(sim, vehicle, e.slot); break; }
+        deferred.push_back(e);
+    }
+    for (const Entry& e : deferred) queue.push(e);
+}
+
+void Dispatcher::Collect(Simulation& sim) {
+    IncidentTable& table = sim.incidents;
+    for (int slot = 0; slot < table.SlotCount(); slot++) {
+        if (!table.IsOpen(slot)) continue;
+        Incident& inc = table.At(slot);
+        if (inc.state == INCIDENT_RESOLVED) {
+            if (inc.arrivedTick >= 0) {
+                responded++;
+                responseTicks += inc.arrivedTick - inc.reportedTick;
+                // Durées pour les histogrammes : trajet du dernier véhicule envoyé, puis travail sur place
+                Profiler& prof = sim.profiler;
+                prof.travelTime.Record((inc.arrivedTick - inc.dispatchedTick) * SIM_DT);
+                LatencyHistogram& work = (inc.type == INCIDENT_FIRE) ? prof.extinguishTime : prof.treatTime;
+                work.Record((sim.tick - inc.arrivedTick) * SIM_DT);
+            }
+            table.Close(slot);
+            resolved++;
+            if (!queue.empty()) dirty = true; // Un véhicule se libère et des incidents attendent
+        } else if (inc.state != INCIDENT_WAITING && sim.vehicles.SlotOf(inc.unit) < 0) {
+            // Le véhicule a disparu en route : l'incident repart dans la file
+            inc.state = INCIDENT_WAITING;
+            inc.unit = INVALID_VEHICLE;
+            queue.push({ inc.priority, inc.reportedTick, inc.id, slot });
+            dirty = true;
+        }
+    }
+}
+
+// --- SAUVEGARDE ---
+void IncidentTable::Save(StateWriter& out) const {
+    out.Section("INCI");
+    out.Vector(slots);
+    out.Vector(used);
+    out.Vector(freeSlots);
+    out.Value(nextId);
+    out.Value(openCount);
+}
+
+bool IncidentTable::Load(StateReader& in) {
+    in.Section("INCI");
+    in.Vector(slots);
+    in.Vector(used);
+    in.Vector(freeSlots);
+    in.Value(nextId);
+    in.Value(openCount);
+    if (in.Ok() && used.size() != slots.size()) return in.Fail("table des incidents incoherente");
+    return in.Ok();
+}
+
+void Dispatcher::Save(StateWriter& out) const {
+    out.Section("DISP");
+    out.Value(unitsPerStation);
+    out.Value(optimize);
+    long long stats[] = { reported, dispatched, resolved, firstDispatches, waitTicks, redirected, responded,
+                          responseTicks, optimizerRuns, optimizerBids };
+    for (long long s : stats) out.Value(s);
+    out.Value(peakOpen);
+    out.Value(dirty);
+
+    // File d'attente : ses entrées dans l'ordre de sortie (les entrées périmées comprises,
+    // elles comptent pour "file vide ou non")
+    std::priority_queue<Entry> copy = queue;
+    out.Value<uint64_t>(copy.size());
+    while (!copy.empty()) { out.Value(copy.top()); copy.pop(); }
+
+    for (const PriceMemory& m : memory) {
+        out.Value(m.valid);
+        out.Value<uint64_t>(m.prices.size());
+        for (const std::pair<uint64_t, int64_t>& p : m.prices) { out.Value(p.first); out.Value(p.second); }
+    }
+    for (const BenefitCache& b : benefitCache) {
+        out.Value(b.n);
+        out.Value(b.incidentCount);
+        out.Value(b.unitCount);
+        out.Vector(b.rowIds);
+        out.Vector(b.rowCurrent);
+        out.Vector(b.columnKeys);
+        out.Vector(b.columnPos);
+        out.Vector(b.columnDelay);
+        out.Vector(b.benefit);
+        out.Vector(b.match);
+    }
+}
+
+bool Dispatcher::Load(StateReader& in) {
+    in.Section("DISP");
+    in.Value(unitsPerStation);
+    in.Value(optimize);
+    long long* stats[] = { &reported, &dispatched, &resolved, &firstDispatches, &waitTicks, &redirected, &responded,
+                           &responseTicks, &optimizerRuns, &optimizerBids };
+    for (long long* s : stats) in.Value(*s);
+    in.Value(peakOpen);
+    in.Value(dirty);
+
+    uint64_t n = 0;
+    queue = std::priority_queue<Entry>();
+    in.Count(n, sizeof(Entry));
+    for (uint64_t k = 0; k < n && in.Ok(); k++) {
+        Entry e;
+        if (in.Value(e)) queue.push(e);
+    }
+
+    for (PriceMemory& m : memory) {
+        in.Value(m.valid);
+        m.prices.clear();
+        in.Count(n, 2 * sizeof(int64_t));
+        for (uint64_t k = 0; k < n && in.Ok(); k++) {
+            std::pair<uint64_t, int64_t> p;
+            in.Value(p.first);
+            in.Value(p.second);
+            m.prices.push_back(p);
+        }
+    }
+    for (BenefitCache& b : benefitCache) {
+        b.solver = AuctionSolver(); // Listes courtes refaites au prochain calcul
+        in.Value(b.n);
+        in.Value(b.incidentCount);
+        in.Value(b.unitCount);
+        in.Vector(b.rowIds);
+        in.Vector(b.rowCurrent);
+        in.Vector(b.columnKeys);
+        in.Vector(b.columnPos);
+        in.Vector(b.columnDelay);
+        in.Vector(b.benefit);
+        in.Vector(b.match);
+        if (!in.Ok()) return false;
+        // Update part de cette affectation : elle doit être complète (chaque objet une fois)
+        bool consistent = b.n >= 0 && b.incidentCount >= 0 && b.unitCount >= 0 &&
+                          b.n == std::max(b.incidentCount, b.unitCount) && b.rowIds.size() == (size_t)b.incidentCount &&
+                          b.rowCurrent.size() == (size_t)b.incidentCount && b.columnKeys.size() == (size_t)b.unitCount &&
+                          b.columnPos.size() == (size_t)b.unitCount && b.columnDelay.size() == (size_t)b.unitCount &&
+                          b.benefit.size() == (size_t)b.n * b.n && (b.match.empty() || b.match.size() == (size_t)b.n);
+        std::vector<uint8_t> seen(consistent ? b.match.size() : 0, 0);
+        for (size_t k = 0; k < seen.size() && consistent; k++) {
+            int j = b.match[k];
+            consistent = (j >= 0 && j < b.n && !seen[j]);
+            if (consistent) seen[j] = 1;
+        }
+        if (!consistent) return in.Fail("matrice du repartiteur incoherente");
+    }
+    return in.Ok();
+}
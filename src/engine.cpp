@@ -5,12 +5,17 @@
 
 #include "../include/engine.h"
 #include "../include/world.h"
-#include "../include/traffic_system.h"
 
 // --- VARIABLES GLOBALES ---
 // On les définit ici pour qu'elles existent en mémoire.
 GameState currentState = MENU; // Le jeu commence sur le Menu
-bool isNight = false;          // Le jeu commence de jour
+bool isNight = false;          // Le jeu commence de jour (copie de la dernière photo de la simulation)
+Camera2D cityCamera = { { 0, 0 }, { 0, 0 }, 0.0f, 1.0f }; // Zoom 1 : le monde tombe pile sur la fenêtre
+
+// Limites du zoom : de très loin (toute une grande ville) à très près
+static const float MIN_ZOOM = 0.02f;
+static const float MAX_ZOOM = 4.0f;
+static const float PAN_SPEED = 600.0f; // Déplacement aux flèches (pixels d'écran par seconde)
 
 // --- FONCTION BOUTON ---
 // Dessine un bouton et renvoie "Vrai" si le joueur clique dessus
@@ -29,7 +34,7 @@ bool DrawButton(Rectangle rect, Color bgColor, Color textColor, const char* text
 
 // --- FONCTION MINI-CARTE (RADAR) ---
 // Affiche une vue aérienne miniature de toute la ville
-void DrawMiniMap(const std::vector<Car*>& cars) {
+void DrawMiniMap(const SimSnapshot& snap) {
     // Définition de la zone de la mini-carte (en bas à gauche dans la barre latérale)
     Rectangle mapArea = { 25, 300, 200, 150 }; 
     
@@ -38,8 +43,8 @@ void DrawMiniMap(const std::vector<Car*>& cars) {
     DrawRectangleLinesEx(mapArea, 2, RAYWHITE); 
 
     // Dimensions du "vrai" monde (sans la barre latérale)
-    float worldW = (float)GetScreenWidth() - SIDEBAR_WIDTH;
-    float worldH = (float)GetScreenHeight();
+    float worldW = worldWidth - SIDEBAR_WIDTH;
+    float worldH = worldHeight;
 
     // --- MATHÉMATIQUES DE CONVERSION ---
     // Cette petite fonction "lambda" transforme une position du Grand Monde (ex: x=500)
@@ -54,28 +59,137 @@ void DrawMiniMap(const std::vector<Car*>& cars) {
 
     // On dessine les routes en gris foncé sur la mini-carte
     for(float vx : vRoads) DrawLineV(ToMap({vx, 0}), ToMap({vx, worldH}), DARKGRAY);
-    for(float hy : hRoads) DrawLineV(ToMap({(float)SIDEBAR_WIDTH, hy}), ToMap({(float)GetScreenWidth(), hy}), DARKGRAY);
+    for(float hy : hRoads) DrawLineV(ToMap({(float)SIDEBAR_WIDTH, hy}), ToMap({worldWidth, hy}), DARKGRAY);
 
-    // On fait clignoter les points d'alerte (Feu = Orange, Accident = Rouge)
+    // On fait clignoter les points d'alerte (Feu = Orange, Accident = Rouge, Vol = Bleu)
     // L'astuce "(int)(GetTime()*5)%2==0" permet de créer le clignotement
-    if (fireActive && (int)(GetTime()*5)%2==0) DrawCircleV(ToMap(firePos), 5, ORANGE);
-    if (accidentActive && (int)(GetTime()*5)%2==0) DrawCircleV(ToMap(accidentPos), 5, RED);
+    if ((int)(GetTime()*5)%2==0) {
+        const Color alertColors[] = { ORANGE, RED, BLUE };
+        for (const SimSnapshot::IncidentView& inc : snap.incidents) {
+            DrawCircleV(ToMap(inc.pos), inc.priority >= 3 ? 5 : 3, alertColors[inc.type]);
+        }
+    }
+
+    // Cadre de la partie visible à l'écran
+    Rectangle view = GetCameraView();
+    Vector2 viewMin = ToMap({ fmaxf(view.x, (float)SIDEBAR_WIDTH), fmaxf(view.y, 0.0f) });
+    Vector2 viewMax = ToMap({ fminf(view.x + view.width, worldWidth), fminf(view.y + view.height, worldHeight) });
+    if (viewMax.x > viewMin.x && viewMax.y > viewMin.y) {
+        DrawRectangleLinesEx({ viewMin.x, viewMin.y, viewMax.x - viewMin.x, viewMax.y - viewMin.y }, 1, RAYWHITE);
+    }
+
+    // Clic sur la carte : on centre la caméra sur cet endroit
+    Vector2 mouse = GetMousePosition();
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mouse, mapArea)) {
+        Vector2 target = { SIDEBAR_WIDTH + (mouse.x - mapArea.x) / mapArea.width * worldW,
+                           (mouse.y - mapArea.y) / mapArea.height * worldH };
+        float centerX = SIDEBAR_WIDTH + (GetScreenWidth() - SIDEBAR_WIDTH) / 2.0f; // Milieu de la zone de jeu
+        cityCamera.offset = { centerX, GetScreenHeight() / 2.0f };
+        cityCamera.target = target;
+    }
 
     // On dessine toutes les voitures sous forme de petits points
-    for(auto c : cars) {
-        Vector2 mPos = ToMap(c->pos); // On calcule sa position sur le radar
+    // (Parcours linéaire des tableaux du stockage : position, type, "se range")
+    const SimSnapshot& v = snap;
+    for(int i = 0; i < v.Size(); i++) {
+        Vector2 mPos = ToMap(v.pos[i]); // On calcule sa position sur le radar
         
         // Choix de la couleur selon le type de véhicule
-        Color col = (c->type == CIVIL) ? GREEN : 
-                    ((c->type == POLICE) ? SKYBLUE : 
-                    ((c->type == AMBULANCE) ? WHITE : RED)); // RED = Pompier
+        Type t = v.type[i];
+        Color col = (t == CIVIL) ? GREEN : 
+                    ((t == POLICE) ? SKYBLUE : 
+                    ((t == AMBULANCE) ? WHITE : RED)); // RED = Pompier
         
         // Si une voiture civile s'est garée pour laisser passer, elle devient Orange
-        if (c->isYielding) col = ORANGE;
+        if (v.isYielding[i]) col = ORANGE;
         
         DrawCircleV(mPos, 2, col); // On dessine le point
     }
     
     // Petit titre au dessus
     DrawText("MINI-MAP", mapArea.x, mapArea.y - 15, 10, GRAY);
-}
\ No newline at end of file
+}
+
+// --- MESURES DE PERFORMANCE (OVERLAY) ---
+// Même place que la mini-carte : une ligne par étape (ms par pas, barre proportionnelle),
+// puis les compteurs et les centiles.
+void DrawProfileOverlay(const SimSnapshot& snap, double drawMs, double drawP99Ms) {
+    Rectangle area = { 25, 270, 200, 180 };
+    DrawRectangleRec(area, BLACK);
+    DrawRectangleLinesEx(area, 2, RAYWHITE);
+    DrawText("PROFIL [P]", area.x, area.y - 15, 10, GRAY);
+
+    const ProfileSummary& p = snap.profile;
+    int x = area.x + 6;
+    int y = area.y + 6;
+    const int line = 11;
+
+    // Étapes du pas (la plus longue donne l'échelle des barres)
+    double longest = drawMs;
+    for (int k = 0; k < PHASE_COUNT; k++) longest = fmax(longest, p.phaseMs[k]);
+    auto phaseLine = [&](const char* name, double ms, Color color) {
+        float bar = (longest > 0) ? (float)(ms / longest) * 60.0f : 0.0f;
+        DrawRectangle(x + 128, y + 2, (int)bar, 6, color);
+        DrawText(TextFormat("%-11s %7.3f", name, ms), x, y, 10, RAYWHITE);
+        y += line;
+    };
+    for (int k = 0; k < PHASE_COUNT; k++) phaseLine(ProfilePhaseName((ProfilePhase)k), p.phaseMs[k], SKYBLUE);
+    phaseLine("dessin", drawMs, ORANGE); // Thread d'affichage (en parallèle de la simulation)
+
+    DrawText(TextFormat("pas %.2f ms  p50 %.2f  p99 %.2f", p.tickMs, p.tickP50Ms, p.tickP99Ms), x, y, 10, YELLOW);
+    y += line;
+    DrawText(TextFormat("dessin p99 %.2f ms", drawP99Ms), x, y, 10, YELLOW);
+    y += line;
+    DrawText(TextFormat("collisions %.0f  cedez %.0f  freins %.0f", p.counterPerTick[COUNTER_COLLISION_TESTS],
+                        p.counterPerTick[COUNTER_YIELDS], p.counterPerTick[COUNTER_HARD_STOPS]), x, y, 10, GRAY);
+    y += line;
+    DrawText(TextFormat("trajet p50 %.1f s p90 %.1f (%lld)", p.travelP50, p.travelP90, p.responses), x, y, 10, GRAY);
+    y += line;
+    DrawText(TextFormat("sur place: feu %.1f s  soins %.1f s", p.extinguishP50, p.treatP50), x, y, 10, GRAY);
+}
+
+// --- CAMÉRA ---
+void ResetCityCamera() {
+    cityCamera.offset = { 0, 0 };
+    cityCamera.target = { 0, 0 };
+    cityCamera.rotation = 0.0f;
+    cityCamera.zoom = 1.0f;
+}
+
+void UpdateCityCamera() {
+    Vector2 mouse = GetMousePosition();
+    bool overCity = mouse.x > SIDEBAR_WIDTH;
+
+    // 1. Zoom à la molette, centré sur la souris : le point sous le curseur ne bouge pas
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0 && overCity) {
+        Vector2 mouseWorld = GetScreenToWorld2D(mouse, cityCamera);
+        cityCamera.offset = mouse;
+        cityCamera.target = mouseWorld;
+        cityCamera.zoom *= (wheel > 0) ? 1.15f : 1.0f / 1.15f;
+        cityCamera.zoom = fminf(MAX_ZOOM, fmaxf(MIN_ZOOM, cityCamera.zoom));
+    }
+
+    // 2. Déplacement en glissant (clic droit ou molette enfoncée)
+    if (overCity && (IsMouseButtonDown(MOUSE_BUTTON_RIGHT) || IsMouseButtonDown(MOUSE_BUTTON_MIDDLE))) {
+        Vector2 delta = GetMouseDelta();
+        cityCamera.target.x -= delta.x / cityCamera.zoom;
+        cityCamera.target.y -= delta.y / cityCamera.zoom;
+    }
+
+    // 3. Déplacement aux flèches (même vitesse à l'écran quel que soit le zoom)
+    float step = PAN_SPEED * GetFrameTime() / cityCamera.zoom;
+    if (IsKeyDown(KEY_LEFT)) cityCamera.target.x -= step;
+    if (IsKeyDown(KEY_RIGHT)) cityCamera.target.x += step;
+    if (IsKeyDown(KEY_UP)) cityCamera.target.y -= step;
+    if (IsKeyDown(KEY_DOWN)) cityCamera.target.y += step;
+
+    // 4. Retour à la vue de départ
+    if (IsKeyPressed(KEY_R)) ResetCityCamera();
+}
+
+Rectangle GetCameraView() {
+    Vector2 topLeft = GetScreenToWorld2D({ (float)SIDEBAR_WIDTH, 0 }, cityCamera);
+    Vector2 bottomRight = GetScreenToWorld2D({ (float)GetScreenWidth(), (float)GetScreenHeight() }, cityCamera);
+    return { topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y };
+}
@@ -0,0 +1,684 @@
+/**
+ * HEADLESS (SANS FENÊTRE)
+ * Point d'entrée pour faire tourner la simulation sur un serveur sans écran.
+ * Pas de Raylib, pas de limite à 60 images par seconde : on enchaîne les pas
+ * de simulation aussi vite que possible et on affiche les "ticks" par seconde.
+ *
+ * Utilisation : SmartCityHeadless [--ticks N | --hours H] [--width W] [--height H] [--city COLSxROWS]
+ *                                 [--cars N] [--interior-spawn P] [--spawn-rate R] [--max-cars N]
+ *                                 [--no-grid] [--threads N] [--seed S]
+ *                                 [--signals fixed|actuated|wave] [--signal-report] [--incident-rate R]
+ *                                 [--greedy-dispatch] [--bench-dispatch]
+ *                                 [--profile] [--profile-csv FICHIER] [--profile-every N] [--histogram-csv FICHIER]
+ *                                 [--record FICHIER] [--keyframe-every N] [--trace-info FICHIER [--trace-at T]]
+ *                                 [--save FICHIER] [--load FICHIER] [--scenario FICHIER]
+ *                                 [--load-profile PROFIL] [--kernels scalar|sse2|avx2]
+ *                                 [--bench-collisions] [--bench-threads] [--bench-routing] [--bench-signals]
+ */
+
+#include "../include/config.h"
+#include "../include/world.h"
+#include "../include/simulation.h"
+#include "../include/sim_thread.h"
+#include "../include/trace.h"
+#include "../include/scenario.h"
+#include "../include/road_graph.h"
+#include "../include/motion_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// --- BENCHMARK : COÛT DE L'ANTI-COLLISION SELON LE NOMBRE DE VOITURES ---
+// Pour chaque taille, on construit une ville assez grande (densité constante),
+// on la remplit, puis on mesure le temps moyen d'un pas avec et sans grille spatiale.
+static void BenchCollisions() {
+    const int sizes[] = { 100, 250, 500, 1000, 2500, 5000, 10000, 20000 };
+    const int bruteForceLimit = 10000; // Au-delà, le test O(n²) prend trop de temps
+    const int ticks = 20;
+
+    printf("%8s %8s %16s %16s %8s\n", "voitures", "blocs", "ms/pas (O(n2))", "ms/pas (grille)", "gain");
+    for (int n : sizes) {
+        // Environ 7 voitures par bloc : la ville grandit avec n
+        int blocks = (int)ceilf(sqrtf(n / 7.0f));
+        if (blocks < 2) blocks = 2;
+        BuildCity(blocks, blocks);
+
+        double ms[2] = { -1, -1 };
+        for (int mode = 0; mode < 2; mode++) {
+            bool useGrid = (mode == 1);
+            if (!useGrid && n > bruteForceLimit) continue;
+
+            Simulation sim(n + DEFAULT_VEHICLE_CAPACITY);
+            sim.useSpatialHash = useGrid;
+            sim.PopulateCivilians(n);
+            sim.Run(2); // Petit échauffement (caches, premières allocations)
+
+            auto start = std::chrono::steady_clock::now();
+            sim.Run(ticks);
+            auto end = std::chrono::steady_clock::now();
+            ms[mode] = std::chrono::duration<double, std::milli>(end - start).count() / ticks;
+        }
+
+        if (ms[0] >= 0) printf("%8d %8d %16.3f %16.3f %7.1fx\n", n, blocks * blocks, ms[0], ms[1], ms[0] / ms[1]);
+        else printf("%8d %8d %16s %16.3f %8s\n", n, blocks * blocks, "-", ms[1], "-");
+    }
+}
+
+// --- BENCHMARK : MISE À JOUR MULTI-THREAD ---
+// Même ville, même graine, même nombre de pas pour 1, 2, 4, 8 et 16 threads.
+// On mesure le temps moyen d'un pas et on vérifie que l'état final est identique au bit près.
+static void BenchThreads() {
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+    const int cars = 20000;
+    const int ticks = 50;
+    const unsigned int seed = 12345;
+
+    int blocks = (int)ceilf(sqrtf(cars / 7.0f));
+    BuildCity(blocks, blocks);
+
+    printf("%d voitures, %d pas, coeurs disponibles: %u\n", cars, ticks, std::thread::hardware_concurrency());
+    printf("%8s %12s %10s %20s\n", "threads", "ms/pas", "gain", "empreinte");
+    double referenceMs = 0;
+    uint64_t referenceChecksum = 0;
+    bool deterministic = true;
+    for (int threads : threadCounts) {
+        Simulation sim(cars + DEFAULT_VEHICLE_CAPACITY);
+        sim.SetSeed(seed);
+        sim.doubleBuffered = true; // Même à 1 thread, pour comparer exactement le même calcul
+        sim.SetThreadCount(threads);
+        sim.maxCivilians = sim.PopulateCivilians(cars);
+
+        auto start = std::chrono::steady_clock::now();
+        sim.Run(ticks);
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count() / ticks;
+
+        uint64_t checksum = sim.StateChecksum();
+        if (threads == 1) { referenceMs = ms; referenceChecksum = checksum; }
+        else if (checksum != referenceChecksum) deterministic = false;
+        printf("%8d %12.3f %9.2fx %20llx\n", threads, ms, referenceMs / ms, (unsigned long long)checksum);
+    }
+    printf("Deterministe: %s\n", deterministic ? "oui" : "NON");
+}
+
+// --- BENCHMARK : TEMPS DE RÉPONSE DES SECOURS ---
+// Le répartiteur de la simulation envoie les secours vers tous les incidents.
+// Même graine, même ville : on compare l'ancienne navigation "au jugé", les itinéraires A*
+// au plus court, et les itinéraires A* avec les temps de parcours mesurés (embouteillages).
+
+static void BenchRouting() {
+    const int blocks = 12;
+    const int cars = 300;
+    const int ticks = 200000;
+    const unsigned int seed = 2024;
+    BuildCity(blocks, blocks);
+
+    printf("%d blocs, %d voitures, %d pas, graine %u\n", blocks * blocks, cars, ticks, seed);
+    const char* names[] = { "au juge", "A* distance", "A* trafic" };
+    printf("%12s %10s %10s %16s %10s %10s\n", "navigation", "envois", "arrivees", "reponse moy (s)", "A*", "reparees");
+    for (int mode = 0; mode < 3; mode++) {
+        Simulation sim(cars + DEFAULT_VEHICLE_CAPACITY);
+        sim.SetSeed(seed);
+        sim.useRouting = (mode >= 1);
+        sim.useTravelTimes = (mode == 2);
+        sim.maxCivilians = sim.PopulateCivilians(cars);
+        sim.Run(ticks, SIM_DT);
+        // Les secours qui n'arrivent jamais (perdus, bloqués) ne comptent pas dans la moyenne
+        printf("%12s %10lld %10d %16.2f %10lld %10lld\n", names[mode], sim.dispatcher.dispatched, (int)sim.arrivals,
+               sim.AverageResponseSeconds(), sim.routesPlanned, sim.routesRepaired);
+    }
+}
+
+// --- BENCHMARK : FEUX FIXES, ADAPTATIFS ET ONDE VERTE ---
+// Même ville, même graine, même trafic : seule la commande des feux change.
+// Attente moyenne par voiture et par carrefour, débit (voitures arrivées aux carrefours
+// par minute de temps simulé) et carrefour le plus pénible.
+static const char* SignalModeName(SignalMode mode) {
+    if (mode == SIGNAL_ACTUATED) return "adaptatif";
+    if (mode == SIGNAL_GREEN_WAVE) return "onde verte";
+    return "fixe";
+}
+
+// Nom de l'option --signals ("fixed", "actuated" ou "wave") ; false si le nom est inconnu
+static bool ParseSignalMode(const char* name, SignalMode& mode) {
+    if (strcmp(name, "fixed") == 0) mode = SIGNAL_FIXED;
+    else if (strcmp(name, "actuated") == 0) mode = SIGNAL_ACTUATED;
+    else if (strcmp(name, "wave") == 0) mode = SIGNAL_GREEN_WAVE;
+    else return false;
+    return true;
+}
+
+static void BenchSignals() {
+    const int blocks = 8;
+    const int cars = 600;
+    const int ticks = 36000; // 10 minutes de la ville
+    const unsigned int seed = 99;
+    BuildCity(blocks, blocks);
+
+    printf("%d blocs, %d voitures, %d pas, graine %u\n", blocks * blocks, cars, ticks, seed);
+    printf("%12s %16s %14s %18s %10s\n", "feux", "attente moy (s)", "debit (/min)", "pire carrefour (s)", "ticks/s");
+    SignalMode modes[] = { SIGNAL_FIXED, SIGNAL_ACTUATED, SIGNAL_GREEN_WAVE };
+    for (SignalMode mode : modes) {
+        Simulation sim(cars + DEFAULT_VEHICLE_CAPACITY);
+        sim.SetSeed(seed);
+        sim.signals.SetMode(mode);
+        sim.maxCivilians = sim.PopulateCivilians(cars);
+        auto start = std::chrono::steady_clock::now();
+        sim.Run(ticks, SIM_DT);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const SignalSystem& sig = sim.signals;
+        double worst = 0;
+        for (int k = 0; k < sig.NodeCount(); k++) worst = std::max(worst, sig.AverageDelay(k));
+        double minutes = ticks * SIM_DT / 60.0;
+        printf("%12s %16.2f %14.1f %18.2f %10.0f\n", SignalModeName(mode), sig.AverageDelay(),
+               sig.TotalArrivals() / minutes, worst, ticks / seconds);
+    }
+}
+
+// --- BENCHMARK : RÉPARTITION DES SECOURS ---
+// 1. Coût du calcul d'affectation : 300 véhicules et 300 incidents, à froid, puis recalcul
+//    après 0,5 s de jeu (un incident remplacé, et 10 %, 30 % ou 100 % des véhicules qui ont
+//    roulé) : Solve à chaud (tout revérifié) contre Update (seulement ce qui a changé).
+//    Gains du répartiteur : chaque incident garde un bonus pour son véhicule actuel (STICKY_VALUE),
+//    la ligne d'un incident qui a changé de véhicule est donc à refaire au calcul suivant.
+//    Objectif : un recalcul Update sous 1 ms (médiane : une préemption de la machine ne fait
+//    pas échouer le test, le pire cas reste affiché). Renvoie false si l'objectif est manqué.
+// 2. Effet sur la ville : même graine, ville chargée, répartiteur glouton contre optimal.
+static int64_t TotalBenefit(int n, const std::vector<int64_t>& benefit, const std::vector<int>& match) {
+    int64_t total = 0;
+    for (int r = 0; r < n; r++) total += benefit[(size_t)r * n + match[r]];
+    return total;
+}
+
+static bool BenchDispatch() {
+    const int n = 300;
+    const int rounds = 200;
+    const double targetMs = 1.0;
+    Random rng(1234, 99);
+    std::vector<Vector2> units(n), sites(n);
+    std::vector<int> priority(n), current(n, -1);
+    for (int k = 0; k < n; k++) {
+        units[k] = { (float)rng.Range(0, 8000), (float)rng.Range(0, 8000) };
+        sites[k] = { (float)rng.Range(0, 8000), (float)rng.Range(0, 8000) };
+        priority[k] = rng.Range(1, 3);
+    }
+    std::vector<int64_t> benefit((size_t)n * n);
+    auto gain = [&](int r, int c) {
+        float manhattan = fabsf(units[c].x - sites[r].x) + fabsf(units[c].y - sites[r].y);
+        int64_t sticky = (c == current[r]) ? STICKY_VALUE : 0;
+        return SERVE_VALUE + PRIORITY_VALUE * priority[r] - (int64_t)(manhattan / UNIT_STEP) + sticky;
+    };
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) benefit[(size_t)r * n + c] = gain(r, c);
+    }
+
+    AuctionSolver solver, warmSolver, coldSolver;
+    std::vector<int64_t> prices, warmPrices, coldPrices;
+    std::vector<int> match, warmMatch, coldMatch;
+    auto start = std::chrono::steady_clock::now();
+    solver.Solve(n, benefit, prices, match, false);
+    double coldMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("Affectation %dx%d a froid : %.3f ms (%lld encheres)\n", n, n, coldMs, solver.LastBids());
+    // Point de départ des recalculs : chaque incident a son véhicule (et le bonus qui va avec)
+    for (int r = 0; r < n; r++) {
+        current[r] = match[r];
+        for (int c = 0; c < n; c++) benefit[(size_t)r * n + c] = gain(r, c);
+    }
+    solver.Solve(n, benefit, prices, match, true);
+    warmMatch = match;
+    warmPrices = prices;
+    warmSolver.Solve(n, benefit, warmPrices, warmMatch, true);
+
+    printf("%10s %16s %14s %14s %14s %10s %12s\n", "vehicules", "Solve chaud (ms)", "Update moy", "Update median",
+           "Update pire", "encheres", "non optimaux");
+    bool passed = true;
+    std::vector<int> rows, columns;
+    std::vector<uint8_t> moved(n);
+    std::vector<double> updateTimes(rounds);
+    const int movingShares[] = { 10, 30, 100 }; // % des véhicules qui ont roulé depuis le dernier calcul
+    for (int share : movingShares) {
+        double warmMs = 0, updateMs = 0, worstMs = 0;
+        long long updateBids = 0;
+        int mismatches = 0;
+        for (int round = 0; round < rounds; round++) {
+            // Les véhicules qui bougent roulent 0,5 s (120 px) ; un incident est remplacé par un nouveau
+            std::fill(moved.begin(), moved.end(), 0);
+            for (int m = 0; m < n * share / 100; m++) {
+                int k = (share == 100) ? m : rng.Range(0, n - 1);
+                if (moved[k]) continue;
+                moved[k] = 1;
+                int axis = rng.Range(0, 3);
+                float step = 30 * UNIT_STEP;
+                if (axis == 0) units[k].x += step; else if (axis == 1) units[k].x -= step;
+                else if (axis == 2) units[k].y += step; else units[k].y -= step;
+            }
+            int replaced = rng.Range(0, n - 1);
+            sites[replaced] = { (float)rng.Range(0, 8000), (float)rng.Range(0, 8000) };
+            priority[replaced] = rng.Range(1, 3);
+            // Lignes à refaire : le nouvel incident, et ceux qui ont changé de véhicule au dernier calcul
+            rows.clear();
+            for (int r = 0; r < n; r++) {
+                int now = (r == replaced) ? -1 : match[r];
+                if (r != replaced && now == current[r]) continue;
+                current[r] = now;
+                rows.push_back(r);
+                for (int c = 0; c < n; c++) benefit[(size_t)r * n + c] = gain(r, c);
+            }
+            columns.clear();
+            for (int c = 0; c < n; c++) {
+                if (moved[c]) columns.push_back(c);
+            }
+            for (int c : columns) {
+                for (int r = 0; r < n; r++) benefit[(size_t)r * n + c] = gain(r, c);
+            }
+
+            start = std::chrono::steady_clock::now();
+            warmSolver.Solve(n, benefit, warmPrices, warmMatch, true);
+            warmMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            solver.Update(n, benefit, prices, match, rows, columns);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            updateMs += ms;
+            worstMs = std::max(worstMs, ms);
+            updateTimes[round] = ms;
+            updateBids += solver.LastBids();
+
+            // Vérification : le recalcul trouve la même valeur que le calcul complet
+            coldPrices.assign(n, 0);
+            coldSolver.Solve(n, benefit, coldPrices, coldMatch, false);
+            int64_t best = TotalBenefit(n, benefit, coldMatch);
+            if (TotalBenefit(n, benefit, match) != best || TotalBenefit(n, benefit, warmMatch) != best) mismatches++;
+        }
+        std::nth_element(updateTimes.begin(), updateTimes.begin() + rounds / 2, updateTimes.end());
+        double medianMs = updateTimes[rounds / 2];
+        printf("%9d%% %16.3f %14.3f %14.3f %14.3f %10lld %8d/%d\n", share, warmMs / rounds, updateMs / rounds, medianMs,
+               worstMs, updateBids / rounds, mismatches, rounds);
+        if (medianMs >= targetMs || mismatches > 0) passed = false;
+    }
+    printf("Objectif recalcul < %.0f ms (Update, mediane, optimal) : %s\n", targetMs, passed ? "OK" : "ECHEC");
+
+    // 2. Dans la ville
+    const int blocks = 20;
+    const int cars = 1500;
+    const int ticks = 54000; // 15 minutes
+    const unsigned int seed = 31;
+    BuildCity(blocks, blocks);
+    printf("\n%d blocs, %d voitures, incidents x4, %d pas, graine %u\n", blocks * blocks, cars, ticks, seed);
+    printf("%10s %10s %10s %14s %16s %10s %12s\n", "repartition", "signales", "resolus", "attente (s)", "reponse moy (s)",
+           "detournes", "ticks/s");
+    for (int mode = 0; mode < 2; mode++) {
+        Simulation sim(cars + DEFAULT_VEHICLE_CAPACITY);
+        sim.SetSeed(seed);
+        sim.interiorSpawnShare = 0.5f;
+        sim.incidentRate = 4.0f;
+        sim.dispatcher.optimize = (mode == 1);
+        sim.maxCivilians = sim.PopulateCivilians(cars);
+        start = std::chrono::steady_clock::now();
+        sim.Run(ticks, SIM_DT);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const Dispatcher& d = sim.dispatcher;
+        printf("%10s %10lld %10lld %14.2f %16.2f %10lld %12.0f\n", mode ? "optimale" : "gloutonne", d.reported, d.resolved,
+               d.AverageWaitSeconds(), d.AverageResponseSeconds(), d.redirected, ticks / seconds);
+    }
+    return passed;
+}
+
+// --- EXPORT DES MESURES (CSV) ---
+// Une ligne par intervalle : ms par pas de chaque étape et compteurs par pas
+static void WriteProfileHeader(FILE* f) {
+    fprintf(f, "tick");
+    for (int k = 0; k < PHASE_COUNT; k++) fprintf(f, ",%s_ms", ProfilePhaseName((ProfilePhase)k));
+    fprintf(f, ",total_ms");
+    for (int k = 0; k < COUNTER_COUNT; k++) fprintf(f, ",%s", ProfileCounterName((ProfileCounter)k));
+    fprintf(f, ",vehicules,incidents_ouverts\n");
+}
+
+static void WriteProfileRow(FILE* f, const Simulation& sim, const ProfileTotals& before, const ProfileTotals& after) {
+    long long ticks = after.ticks - before.ticks;
+    if (ticks <= 0) return;
+    fprintf(f, "%lld", sim.tick);
+    double total = 0;
+    for (int k = 0; k < PHASE_COUNT; k++) {
+        double ms = (after.seconds[k] - before.seconds[k]) * 1000.0 / ticks;
+        total += ms;
+        fprintf(f, ",%.4f", ms);
+    }
+    fprintf(f, ",%.4f", total);
+    for (int k = 0; k < COUNTER_COUNT; k++) fprintf(f, ",%.2f", (double)(after.counts[k] - before.counts[k]) / ticks);
+    fprintf(f, ",%d,%d\n", sim.vehicles.Size(), sim.incidents.OpenCount());
+}
+
+// Histogrammes : une ligne par case non vide (nom, bornes en secondes, nombre)
+static void WriteHistogram(FILE* f, const char* name, const LatencyHistogram& h) {
+    for (int k = 0; k < h.BucketCount(); k++) {
+        if (h.BucketAt(k) == 0) continue;
+        fprintf(f, "%s,%.9g,%.9g,%lld\n", name, h.BucketLow(k), h.BucketHigh(k), h.BucketAt(k));
+    }
+}
+
+static void PrintHistogram(const char* name, const LatencyHistogram& h, double unit, const char* unitName) {
+    printf("%-14s %8lld %10.3f %10.3f %10.3f %10.3f %s\n", name, h.Count(), h.Mean() * unit, h.Percentile(0.5) * unit,
+           h.Percentile(0.99) * unit, h.Max() * unit, unitName);
+}
+
+// --- LECTURE D'UNE TRACE (--trace-info) ---
+// Résumé du fichier, vitesse de relecture (tout d'affilée, puis sauts au hasard) et, avec
+// --trace-at, l'état à ce pas : son empreinte doit être celle affichée par --record
+// quand la partie s'arrête à ce pas. On vérifie aussi qu'un saut direct (depuis l'image
+// clé) redonne exactement l'état obtenu en relisant tout depuis le début.
+static int TraceInfo(const char* path, long long at) {
+    TraceReader reader;
+    if (!reader.Open(path)) { printf("Trace %s illisible : %s\n", path, reader.Error().c_str()); return 1; }
+    printf("Trace: %s (%.1f Mo%s)\n", path, reader.FileSize() / 1e6, reader.Truncated() ? ", fin coupee ignoree" : "");
+    printf("Monde: %dx%d, graine %llu\n", reader.WorldWidth(), reader.WorldHeight(), (unsigned long long)reader.Seed());
+    printf("Pas: %lld a %lld (%lld images, %lld images cles toutes les %d)\n", reader.FirstTick(), reader.LastTick(),
+           reader.FrameCount(), reader.KeyframeCount(), reader.KeyframeEvery());
+    printf("Octets par pas: %.0f\n", (double)reader.FileSize() / reader.FrameCount());
+
+    SimSnapshot snap;
+    int maxCars = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long long t = reader.FirstTick(); t <= reader.LastTick(); t++) {
+        if (!reader.Seek(t, snap)) { printf("Image abimee au pas %lld\n", t); return 1; }
+        maxCars = std::max(maxCars, snap.Size());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Relecture complete: %.3f s (%.0f pas/s), jusqu'a %d vehicules\n", seconds,
+           reader.FrameCount() / std::max(seconds, 1e-9), maxCars);
+
+    const int seeks = 200;
+    Random rng(reader.Seed(), 7);
+    start = std::chrono::steady_clock::now();
+    for (int k = 0; k < seeks; k++) {
+        long long t = reader.FirstTick() + rng.Range(0, (int)(reader.LastTick() - reader.FirstTick()));
+        if (!reader.Seek(t, snap)) { printf("Image abimee au pas %lld\n", t); return 1; }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Saut au hasard: %.3f ms en moyenne\n", seconds * 1000.0 / seeks);
+
+    if (at >= 0) {
+        // Relecture depuis le début, puis saut direct depuis la fin : même état attendu
+        uint64_t sequential = 0;
+        for (long long t = reader.FirstTick(); t <= std::min(at, reader.LastTick()); t++) reader.Seek(t, snap);
+        sequential = TraceChecksum(snap);
+        reader.Seek(reader.LastTick(), snap);
+        reader.Seek(at, snap);
+        uint64_t direct = TraceChecksum(snap);
+        printf("Pas %lld: %d vehicules, %d incidents ouverts (%d en attente)\n", snap.tick, snap.Size(),
+               (int)snap.incidents.size(), snap.waitingIncidents);
+        printf("Empreinte trace: %016llx (saut direct: %s)\n", (unsigned long long)sequential,
+               sequential == direct ? "identique" : "DIFFERENT");
+        if (sequential != direct) return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // 1. PARAMÈTRES (valeurs par défaut = la fenêtre de départ du jeu)
+    int ticks = 100000;
+    int width = INITIAL_SCREEN_WIDTH;
+    int height = INITIAL_SCREEN_HEIGHT;
+    int cityCols = 0, cityRows = 0; // --city : taille en pâtés de maisons (sinon --width/--height)
+    int cars = 0;         // 0 = démarrage à vide, comme le jeu
+    float interiorSpawn = 0.0f; // Part des civils qui naissent à l'intérieur de la ville
+    float spawnRate = DEFAULT_SPAWN_RATE; // Civils qui arrivent par seconde (--spawn-rate 500 : afflux massif)
+    int maxCars = 0;      // Plafond des civils (0 = --cars, ou MAX_CIVILIANS sans --cars)
+    bool useGrid = true;
+    int threads = 0;      // 0 = mise à jour classique sur un seul thread
+    bool hasSeed = false;
+    unsigned long long seed = 0;
+    SignalMode signalMode = SIGNAL_FIXED;
+    bool signalReport = false; // Tableau des attentes carrefour par carrefour
+    float incidentRate = 1.0f;  // Fréquence des incidents (x10 = ville en crise)
+    bool greedyDispatch = false; // Ancien répartiteur (le plus proche d'abord) au lieu de l'affectation optimale
+    bool profileReport = false;       // Tableau des étapes du pas et des histogrammes
+    const char* profileCsv = nullptr; // Mesures par intervalle (CSV)
+    int profileEvery = 600;           // Longueur d'un intervalle (en pas : 10 s de la ville)
+    const char* histogramCsv = nullptr; // Cases des histogrammes (CSV)
+    const char* recordPath = nullptr;   // Trace binaire des trajectoires
+    int keyframeEvery = TRACE_DEFAULT_KEYFRAME;
+    const char* traceInfo = nullptr;    // Relecture d'une trace (sans simulation)
+    long long traceAt = -1;
+    const char* savePath = nullptr;     // Sauvegarde de l'état complet à la fin
+    const char* loadPath = nullptr;     // Reprise d'une sauvegarde (remplace ville et voitures)
+    const char* scenarioPath = nullptr; // Carte d'un quartier (à la place de la ville procédurale)
+    const char* loadProfile = nullptr;  // Profil du générateur de charge (ex : "rush-hour,fires=20")
+    KernelLevel kernels = DefaultKernelLevel(); // Noyaux du mouvement (SIMD), pour comparer les versions
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(argv[i], "--ticks") == 0 && hasValue) ticks = atoi(argv[++i]);
+        // Heures de temps de la ville (un pas = SIM_DT secondes)
+        else if (strcmp(argv[i], "--hours") == 0 && hasValue) ticks = (int)lround(atof(argv[++i]) * 3600.0 / SIM_DT);
+        else if (strcmp(argv[i], "--width") == 0 && hasValue) width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--height") == 0 && hasValue) height = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--city") == 0 && hasValue) sscanf(argv[++i], "%dx%d", &cityCols, &cityRows);
+        else if (strcmp(argv[i], "--cars") == 0 && hasValue) cars = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--interior-spawn") == 0 && hasValue) interiorSpawn = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--spawn-rate") == 0 && hasValue) spawnRate = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-cars") == 0 && hasValue) maxCars = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-grid") == 0) useGrid = false;
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && hasValue) { seed = strtoull(argv[++i], NULL, 10); hasSeed = true; }
+        else if (strcmp(argv[i], "--bench-collisions") == 0) { BenchCollisions(); return 0; }
+        else if (strcmp(argv[i], "--bench-threads") == 0) { BenchThreads(); return 0; }
+        else if (strcmp(argv[i], "--signals") == 0 && hasValue && ParseSignalMode(argv[i + 1], signalMode)) i++;
+        else if (strcmp(argv[i], "--signal-report") == 0) signalReport = true;
+        else if (strcmp(argv[i], "--incident-rate") == 0 && hasValue) incidentRate = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--bench-routing") == 0) { BenchRouting(); return 0; }
+        else if (strcmp(argv[i], "--bench-signals") == 0) { BenchSignals(); return 0; }
+        else if (strcmp(argv[i], "--bench-dispatch") == 0) return BenchDispatch() ? 0 : 1;
+        else if (strcmp(argv[i], "--greedy-dispatch") == 0) greedyDispatch = true;
+        else if (strcmp(argv[i], "--profile") == 0) profileReport = true;
+        else if (strcmp(argv[i], "--profile-csv") == 0 && hasValue) profileCsv = argv[++i];
+        else if (strcmp(argv[i], "--profile-every") == 0 && hasValue) profileEvery = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--histogram-csv") == 0 && hasValue) histogramCsv = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && hasValue) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--keyframe-every") == 0 && hasValue) keyframeEvery = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--trace-info") == 0 && hasValue) traceInfo = argv[++i];
+        else if (strcmp(argv[i], "--trace-at") == 0 && hasValue) traceAt = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--save") == 0 && hasValue) savePath = argv[++i];
+        else if (strcmp(argv[i], "--load") == 0 && hasValue) loadPath = argv[++i];
+        else if (strcmp(argv[i], "--scenario") == 0 && hasValue) scenarioPath = argv[++i];
+        else if (strcmp(argv[i], "--load-profile") == 0 && hasValue) loadProfile = argv[++i];
+        else if (strcmp(argv[i], "--kernels") == 0 && hasValue && ParseKernelLevel(argv[i + 1], kernels)) i++;
+        else {
+            printf("Usage: %s [--ticks N | --hours H] [--width W] [--height H] [--city COLSxROWS] [--cars N] [--interior-spawn P]\n"
+                   "          [--spawn-rate R] [--max-cars N]\n"
+                   "          [--no-grid] [--threads N] [--seed S] [--signals fixed|actuated|wave] [--signal-report]\n"
+                   "          [--incident-rate R] [--greedy-dispatch] [--bench-dispatch]\n"
+                   "          [--profile] [--profile-csv FICHIER] [--profile-every N] [--histogram-csv FICHIER]\n"
+                   "          [--record FICHIER] [--keyframe-every N] [--trace-info FICHIER [--trace-at T]]\n"
+                   "          [--save FICHIER] [--load FICHIER] [--scenario FICHIER]\n"
+                   "          [--load-profile steady|rush-hour[,fires=N][,accidents=N][,crimes=N][,civilians=R][,start=H][,poisson|regular]]\n"
+                   "          [--kernels scalar|sse2|avx2]\n"
+                   "          [--bench-collisions] [--bench-threads] [--bench-routing] [--bench-signals]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (traceInfo) return TraceInfo(traceInfo, traceAt);
+    // Au-dessus de ce que sait faire le processeur : on prend le meilleur disponible
+    kernels = SetKernelLevel(kernels);
+
+    // 2. CONSTRUCTION DE LA VILLE
+    // Scénario : la carte remplace --width/--height/--city, et sa demande de trafic
+    // l'emporte sur les options correspondantes (--cars, --max-cars, --spawn-rate...)
+    ScenarioDemand demand;
+    if (scenarioPath && !loadPath) {
+        auto scenarioStart = std::chrono::steady_clock::now();
+        std::string error;
+        if (!LoadScenario(scenarioPath, demand, error)) { printf("Scenario %s illisible : %s\n", scenarioPath, error.c_str()); return 1; }
+        double scenarioMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scenarioStart).count();
+        printf("Scenario: %s en %.1f ms (%d x %d routes, %d carrefours, %d troncons, %d batiments)\n", scenarioPath,
+               scenarioMs, (int)vRoads.size(), (int)hRoads.size(), roadGraph.NodeCount(), (int)roadGraph.edgeTo.size() / 2,
+               (int)buildings.size());
+        if (demand.civilians >= 0) cars = demand.civilians;
+        if (demand.maxCivilians >= 0) maxCars = demand.maxCivilians;
+    }
+    Simulation sim(std::max(cars, maxCars) + DEFAULT_VEHICLE_CAPACITY);
+    if (loadPath) {
+        // Reprise : la ville, les voitures et les réglages de la partie viennent de la sauvegarde.
+        // Seuls --threads, --ticks et les options de mesure s'appliquent encore.
+        auto loadStart = std::chrono::steady_clock::now();
+        std::string error;
+        if (!sim.LoadState(loadPath, error)) { printf("Sauvegarde %s illisible : %s\n", loadPath, error.c_str()); return 1; }
+        double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        printf("Chargement: %s en %.1f ms (pas %lld, %d vehicules)\n", loadPath, loadMs, sim.tick, sim.vehicles.Size());
+        if (threads > 0) sim.SetThreadCount(threads);
+    } else {
+        if (!scenarioPath) {
+            if (cityCols > 0 && cityRows > 0) BuildCity(cityCols, cityRows); // Ex : --city 200x200
+            else RecalculateGrid(width, height);
+        }
+        sim.useSpatialHash = useGrid;
+        sim.interiorSpawnShare = interiorSpawn;
+        sim.spawnRate = spawnRate;
+        if (threads > 0) {
+            // Avec --threads, toujours le mode double tampon : pour une même graine,
+            // --threads 1 et --threads 16 donnent exactement la même partie
+            sim.doubleBuffered = true;
+            sim.SetThreadCount(threads);
+        }
+        sim.signals.SetMode(signalMode);
+        sim.incidentRate = incidentRate;
+        sim.dispatcher.optimize = !greedyDispatch;
+        if (scenarioPath) ApplyScenarioDemand(demand, sim);
+        if (loadProfile) {
+            // Profil de charge reproductible : même profil + même graine = mêmes arrivées
+            LoadProfile profile = DefaultLoadProfile();
+            std::string error;
+            if (!ParseLoadProfile(loadProfile, profile, error)) { printf("Profil de charge %s invalide : %s\n", loadProfile, error.c_str()); return 1; }
+            sim.loadGenerator.SetProfile(profile);
+        }
+        if (hasSeed) sim.SetSeed(seed); // Sinon graine au hasard (affichée à la fin pour pouvoir rejouer)
+        if (cars > 0) {
+            // Ville pré-remplie : l'apparition automatique maintient ensuite ce niveau
+            sim.maxCivilians = sim.PopulateCivilians(cars);
+        }
+        if (maxCars > 0) sim.maxCivilians = maxCars;
+    }
+
+    // Enregistrement : l'état de départ, puis chaque pas (écriture sur un thread à part)
+    TraceRecorder recorder;
+    if (recordPath) {
+        if (!recorder.Open(recordPath, sim, keyframeEvery)) { printf("Impossible d'ecrire %s\n", recordPath); return 1; }
+        sim.recorder = &recorder;
+    }
+
+    // 3. BOUCLE DE SIMULATION (chronométrée)
+    // Avec --profile-csv, on s'arrête tous les profileEvery pas pour écrire une ligne
+    FILE* csv = nullptr;
+    if (profileCsv) {
+        csv = fopen(profileCsv, "w");
+        if (!csv) { printf("Impossible d'ecrire %s\n", profileCsv); return 1; }
+        WriteProfileHeader(csv);
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (!csv) sim.Run(ticks, SIM_DT);
+    else {
+        for (int done = 0; done < ticks; done += profileEvery) {
+            ProfileTotals before = sim.profiler.Totals();
+            sim.Run(std::min(profileEvery, ticks - done), SIM_DT);
+            WriteProfileRow(csv, sim, before, sim.profiler.Totals());
+        }
+        fclose(csv);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (recordPath) {
+        recorder.Close(); // Attend la fin de l'écriture (compté hors du temps de simulation)
+        sim.recorder = nullptr;
+    }
+
+    if (savePath) {
+        std::string error;
+        if (!sim.SaveState(savePath, error)) { printf("Impossible d'ecrire %s : %s\n", savePath, error.c_str()); return 1; }
+    }
+
+    // 4. RÉSULTATS
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double ticksPerSecond = (seconds > 0) ? ticks / seconds : 0;
+    printf("Ticks: %d\n", ticks);
+    printf("Temps: %.3f s\n", seconds);
+    printf("Ticks/seconde: %.0f\n", ticksPerSecond);
+    printf("Temps simule: %.2f h (x%.0f temps reel)\n", ticks * SIM_DT / 3600.0, ticksPerSecond * SIM_DT);
+    printf("Voitures restantes: %d\n", sim.vehicles.Size());
+    printf("Apparitions: %lld (%.1f/s demandees, %lld sans place libre)\n", sim.spawned, sim.spawnRate, sim.spawnRefused);
+    printf("Threads: %d\n", sim.ThreadCount());
+    printf("Noyaux: %s (meilleurs disponibles : %s)\n", KernelLevelName(kernels), KernelLevelName(BestKernelLevel()));
+    printf("Graine: %llu\n", (unsigned long long)sim.seed);
+    printf("Feux: %s (attente moyenne %.2f s, %lld arrivees aux carrefours)\n", SignalModeName(sim.signals.Mode()),
+           sim.signals.AverageDelay(), sim.signals.TotalArrivals());
+    const Dispatcher& d = sim.dispatcher;
+    printf("Incidents: %lld signales, %lld resolus, %d ouverts (max %d en meme temps)\n", d.reported, d.resolved,
+           sim.incidents.OpenCount(), d.peakOpen);
+    const LoadGenerator& load = sim.loadGenerator;
+    printf("Arrivees: %lld incendies, %lld accidents, %lld vols, %lld civils (heure de la ville %.1f h)\n",
+           load.arrivals[LOAD_FIRE], load.arrivals[LOAD_ACCIDENT], load.arrivals[LOAD_CRIME], load.arrivals[LOAD_CIVILIAN],
+           load.HourAt(sim.tick * (double)SIM_DT));
+    printf("Secours: %lld envois (%lld detournes), attente moy %.2f s, trajet moy %.2f s, reponse moy %.2f s\n",
+           d.dispatched, d.redirected, d.AverageWaitSeconds(), sim.AverageResponseSeconds(), d.AverageResponseSeconds());
+    printf("Empreinte: %016llx\n", (unsigned long long)sim.StateChecksum());
+    if (recordPath) {
+        SimSnapshot last;
+        last.CaptureFrom(sim, false);
+        printf("Trace: %s, %lld pas, %.1f Mo (%.0f octets/pas), simulation en attente %.3f s, empreinte %016llx\n",
+               recordPath, recorder.FramesWritten(), recorder.BytesWritten() / 1e6,
+               (double)recorder.BytesWritten() / std::max(1LL, recorder.FramesWritten()), recorder.WaitSeconds(),
+               (unsigned long long)TraceChecksum(last));
+    }
+
+    if (savePath) printf("Sauvegarde: %s, pas %lld\n", savePath, sim.tick);
+
+    const Profiler& prof = sim.profiler;
+    printf("Pas: moy %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", prof.tickTime.Mean() * 1000.0,
+           prof.tickTime.Percentile(0.5) * 1000.0, prof.tickTime.Percentile(0.99) * 1000.0, prof.tickTime.Max() * 1000.0);
+
+    // 5. DÉTAIL DES MESURES : étapes du pas, compteurs, histogrammes
+    if (profileReport) {
+        const ProfileTotals& t = prof.Totals();
+        long long n = std::max(1LL, t.ticks);
+        printf("%-14s %12s %8s\n", "etape", "ms/pas", "part");
+        double total = 0;
+        for (int k = 0; k < PHASE_COUNT; k++) total += t.seconds[k];
+        for (int k = 0; k < PHASE_COUNT; k++) {
+            printf("%-14s %12.4f %7.1f%%\n", ProfilePhaseName((ProfilePhase)k), t.seconds[k] * 1000.0 / n,
+                   total > 0 ? 100.0 * t.seconds[k] / total : 0.0);
+        }
+        for (int k = 0; k < COUNTER_COUNT; k++) {
+            printf("%-18s %12.1f par pas\n", ProfileCounterName((ProfileCounter)k), (double)t.counts[k] / n);
+        }
+        printf("%-14s %8s %10s %10s %10s %10s\n", "duree", "mesures", "moy", "p50", "p99", "max");
+        PrintHistogram("pas", prof.tickTime, 1000.0, "ms");
+        PrintHistogram("trajet", prof.travelTime, 1.0, "s");
+        PrintHistogram("extinction", prof.extinguishTime, 1.0, "s");
+        PrintHistogram("soins", prof.treatTime, 1.0, "s");
+    }
+    if (histogramCsv) {
+        FILE* f = fopen(histogramCsv, "w");
+        if (!f) { printf("Impossible d'ecrire %s\n", histogramCsv); return 1; }
+        fprintf(f, "histogramme,min_s,max_s,nombre\n");
+        WriteHistogram(f, "pas", prof.tickTime);
+        WriteHistogram(f, "trajet", prof.travelTime);
+        WriteHistogram(f, "extinction", prof.extinguishTime);
+        WriteHistogram(f, "soins", prof.treatTime);
+        fclose(f);
+    }
+
+    // 6. ATTENTES CARREFOUR PAR CARREFOUR (colonne, ligne dans la grille des routes)
+    if (signalReport) {
+        printf("%6s %6s %10s %16s\n", "col", "ligne", "arrivees", "attente moy (s)");
+        for (int k = 0; k < sim.signals.NodeCount(); k++) {
+            printf("%6d %6d %10lld %16.2f\n", roadGraph.NodeCol(k), roadGraph.NodeRow(k),
+                   sim.signals.Arrivals(k), sim.signals.AverageDelay(k));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * GÉNÉRATEUR DE CHARGE
+ * Dates des prochains incendies, accidents, vols et arrivées de civils, rangées dans
+ * une file de priorité (voir load_generator.h).
+ */
+
+#include "../include/load_generator.h"
+#include "../include/emergency.h"
+#include "../include/state_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// --- PROFILS ---
+LoadProfile DefaultLoadProfile() {
+    LoadProfile p;
+    p.rates[LOAD_FIRE] = { FIRES_PER_HOUR, ARRIVAL_POISSON, false };
+    p.rates[LOAD_ACCIDENT] = { ACCIDENTS_PER_HOUR, ARRIVAL_POISSON, true };
+    p.rates[LOAD_CRIME] = { CRIMES_PER_HOUR, ARRIVAL_POISSON, false };
+    p.rates[LOAD_CIVILIAN] = { -1.0, ARRIVAL_REGULAR, true }; // Au rythme de spawnRate, comme avant
+    for (float& t : p.traffic) t = 1.0f;
+    p.startHour = 0.0f;
+    return p;
+}
+
+// Heures de pointe : trafic faible la nuit, pointes du matin (7 h - 9 h) et du soir (17 h - 19 h)
+static void RushHourTraffic(LoadProfile& p) {
+    const float day[24] = {
+        0.2f, 0.15f, 0.1f, 0.1f, 0.15f, 0.3f, 0.8f, 2.0f, 2.5f, 1.6f, 1.0f, 1.0f,
+        1.2f, 1.1f, 1.0f, 1.1f, 1.6f, 2.3f, 2.5f, 1.5f, 0.9f, 0.6f, 0.4f, 0.3f
+    };
+    memcpy(p.traffic, day, sizeof(day));
+    p.startHour = 7.0f;
+}
+
+bool ParseLoadProfile(const char* spec, LoadProfile& profile, std::string& error) {
+    LoadProfile p = profile;
+    const char* s = spec;
+    while (*s) {
+        const char* end = strchr(s, ',');
+        std::string item = end ? std::string(s, end) : std::string(s);
+        s = end ? end + 1 : s + item.size();
+        if (item.empty()) continue;
+
+        std::string key = item, value;
+        size_t equal = item.find('=');
+        if (equal != std::string::npos) { key = item.substr(0, equal); value = item.substr(equal + 1); }
+        char* rest = nullptr;
+        double number = value.empty() ? 0.0 : strtod(value.c_str(), &rest);
+        bool validNumber = !value.empty() && rest && *rest == '\0' && number >= 0.0;
+
+        if (key == "steady" && value.empty()) p = DefaultLoadProfile();
+        else if (key == "rush-hour" && value.empty()) { p = DefaultLoadProfile(); RushHourTraffic(p); }
+        else if (key == "poisson" && value.empty()) { for (ArrivalRate& r : p.rates) r.mode = ARRIVAL_POISSON; }
+        else if (key == "regular" && value.empty()) { for (ArrivalRate& r : p.rates) r.mode = ARRIVAL_REGULAR; }
+        else if (key == "fires" && validNumber) p.rates[LOAD_FIRE].perHour = number;
+        else if (key == "accidents" && validNumber) p.rates[LOAD_ACCIDENT].perHour = number;
+        else if (key == "crimes" && validNumber) p.rates[LOAD_CRIME].perHour = number;
+        else if (key == "civilians" && validNumber) p.rates[LOAD_CIVILIAN].perHour = number * 3600.0;
+        else if (key == "start" && validNumber && number < 24.0) p.startHour = (float)number;
+        else { error = "\"" + item + "\" inconnu"; return false; }
+    }
+    profile = p;
+    return true;
+}
+
+const char* LoadKindName(LoadKind kind) {
+    static const char* names[LOAD_KIND_COUNT] = { "incendies", "accidents", "vols", "civils" };
+    return names[kind];
+}
+
+// --- LA FILE DES ARRIVÉES ---
+// Tas avec la date la plus proche en haut ; à date égale, l'ordre des types (toujours le même)
+bool LoadGenerator::Later(const Event& a, const Event& b) {
+    return a.time > b.time || (a.time == b.time && a.kind > b.kind);
+}
+
+LoadGenerator::LoadGenerator() {
+    profile = DefaultLoadProfile();
+    Seed(0);
+}
+
+void LoadGenerator::SetProfile(const LoadProfile& p) {
+    profile = p;
+    queue.clear();
+    for (double& b : base) b = -1.0; // Le prochain Retune replanifie tout
+}
+
+void LoadGenerator::Seed(uint64_t seed) {
+    for (int k = 0; k < LOAD_KIND_COUNT; k++) {
+        timing[k].Seed(seed, ((uint64_t)STREAM_ARRIVAL << 32) | (uint64_t)k);
+        arrivals[k] = 0;
+    }
+    SetProfile(profile);
+}
+
+double LoadGenerator::HourAt(double time) const {
+    double hour = fmod(profile.startHour + time / 3600.0, 24.0);
+    return hour < 0 ? hour + 24.0 : hour;
+}
+
+double LoadGenerator::RateAt(LoadKind kind, double time) const {
+    double rate = base[kind];
+    if (profile.rates[kind].followsTraffic) rate *= profile.traffic[std::min(23, (int)HourAt(time))];
+    return rate;
+}
+
+double LoadGenerator::Peak(LoadKind kind) const {
+    if (!profile.rates[kind].followsTraffic) return base[kind];
+    float worst = 0.0f;
+    for (float t : profile.traffic) worst = std::max(worst, t);
+    return base[kind] * worst;
+}
+
+// Date de la prochaine arrivée du type "kind" après "from", rangée dans la file
+void LoadGenerator::Schedule(LoadKind kind, double from) {
+    double peak = Peak(kind);
+    if (!(peak > 0.0)) return; // Aucune arrivée de ce type (jusqu'au prochain changement de taux)
+    auto push = [&](double time) {
+        queue.push_back({ time, kind });
+        std::push_heap(queue.begin(), queue.end(), Later);
+    };
+
+    double t = from;
+    if (profile.rates[kind].mode == ARRIVAL_REGULAR) {
+        // Écart fixe, au taux de l'heure en cours ; heure sans arrivée : on passe à la suivante
+        for (int hours = 0; hours <= 24; hours++) {
+            double rate = RateAt(kind, t);
+            if (rate > 0.0) { push(t + 3600.0 / rate); return; }
+            t += (std::floor(HourAt(t)) + 1.0 - HourAt(t)) * 3600.0 + 1e-6;
+        }
+        return;
+    }
+
+    // Poisson : écart exponentiel au taux de la pire heure, gardé selon le taux de l'heure tirée
+    for (int tries = 0; tries < 1000000; tries++) {
+        t += -std::log(timing[kind].Uniform()) * 3600.0 / peak;
+        if (timing[kind].Uniform() * peak <= RateAt(kind, t)) break;
+    }
+    push(t);
+}
+
+void LoadGenerator::Unschedule(LoadKind kind) {
+    queue.erase(std::remove_if(queue.begin(), queue.end(), [kind](const Event& e) { return e.kind == kind; }), queue.end());
+    std::make_heap(queue.begin(), queue.end(), Later);
+}
+
+void LoadGenerator::Retune(double now, const double newBase[LOAD_KIND_COUNT]) {
+    for (int k = 0; k < LOAD_KIND_COUNT; k++) {
+        if (newBase[k] == base[k]) continue;
+        base[k] = newBase[k];
+        Unschedule((LoadKind)k);
+        Schedule((LoadKind)k, now);
+    }
+}
+
+bool LoadGenerator::Pop(double now, LoadKind& kind) {
+    if (queue.empty() || queue.front().time > now) return false;
+    Event e = queue.front();
+    std::pop_heap(queue.begin(), queue.end(), Later);
+    queue.pop_back();
+    kind = e.kind;
+    arrivals[kind]++;
+    Schedule(kind, e.time); // La suivante part de cette arrivée, pas du pas en cours
+    return true;
+}
+
+// --- SAUVEGARDE ---
+void LoadGenerator::Save(StateWriter& out) const {
+    out.Section("LOAD");
+    out.Value(profile);
+    out.Bytes(base, sizeof(base));
+    out.Bytes(arrivals, sizeof(arrivals));
+    for (const Random& r : timing) out.Value(r.Counter());
+    out.Vector(queue);
+}
+
+bool LoadGenerator::Load(StateReader& in) {
+    LoadProfile p;
+    double b[LOAD_KIND_COUNT];
+    long long counts[LOAD_KIND_COUNT];
+    uint64_t counters[LOAD_KIND_COUNT];
+    std::vector<Event> q;
+    in.Section("LOAD");
+    in.Value(p);
+    in.Bytes(b, sizeof(b));
+    in.Bytes(counts, sizeof(counts));
+    for (uint64_t& c : counters) in.Value(c);
+    in.Vector(q);
+    if (!in.Ok()) return false;
+    for (const Event& e : q) {
+        if (e.kind < 0 || e.kind >= LOAD_KIND_COUNT) return in.Fail("arrivee de type inconnu");
+    }
+    if (!std::is_heap(q.begin(), q.end(), Later)) return in.Fail("file des arrivees dans le desordre");
+
+    // Les flux ont déjà la graine de la partie (Simulation::SetSeed) : on reprend leurs compteurs
+    profile = p;
+    memcpy(base, b, sizeof(base));
+    memcpy(arrivals, counts, sizeof(arrivals));
+    for (int k = 0; k < LOAD_KIND_COUNT; k++) timing[k].SetCounter(counters[k]);
+    queue.swap(q);
+    return true;
+}
@@ -7,26 +7,111 @@
 // Inclusions des fichiers d'en-tête situés dans le dossier parent "../include"
 #include "../include/config.h"
 #include "../include/world.h"
-#include "../include/traffic_system.h"
-#include "../include/vehicle.h"
+#include "../include/simulation.h"
+#include "../include/sim_thread.h"
+#include "../include/render.h"
 #include "../include/engine.h"
+#include "../include/trace.h"
+#include "../include/replay_view.h"
+#include "../include/scenario.h"
 #include <math.h> 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-int main() {
+int main(int argc, char** argv) {
     // 1. INITIALISATION DE LA FENÊTRE
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(INITIAL_SCREEN_WIDTH, INITIAL_SCREEN_HEIGHT, "Sim Ville - Complet + Menu + Nuit");
     SetTargetFPS(60);
 
-    // Construction initiale de la ville (routes et bâtiments)
-    RecalculateGrid();
+    // Options : "--seed N" rejoue exactement la même partie (même trafic, mêmes incidents),
+    // "--city 200x200" construit une ville de cette taille en pâtés de maisons,
+    // "--cars N" remplit la ville avec N civils dès le départ,
+    // "--record FICHIER" enregistre la partie, "--replay FICHIER" rejoue une partie enregistrée,
+    // "--load FICHIER" reprend une partie sauvegardée (touche F5 en jeu),
+    // "--scenario FICHIER" charge la carte et la demande d'un quartier (voir scenario.h).
+    int cityCols = 0, cityRows = 0;
+    int cars = 0;
+    bool hasSeed = false;
+    unsigned long long seed = 0;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    const char* loadPath = NULL;
+    const char* scenarioPath = NULL;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0) { seed = strtoull(argv[i + 1], NULL, 10); hasSeed = true; }
+        else if (strcmp(argv[i], "--city") == 0) sscanf(argv[i + 1], "%dx%d", &cityCols, &cityRows);
+        else if (strcmp(argv[i], "--cars") == 0) cars = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--record") == 0) recordPath = argv[i + 1];
+        else if (strcmp(argv[i], "--replay") == 0) replayPath = argv[i + 1];
+        else if (strcmp(argv[i], "--load") == 0) loadPath = argv[i + 1];
+        else if (strcmp(argv[i], "--scenario") == 0) scenarioPath = argv[i + 1];
+    }
 
-    // Liste de toutes les voitures en jeu
-    std::vector<Car*> cars;
-    
-    // Variables de temps
-    LightCycle cycle = V_GREEN; // Les feux commencent au vert vertical
-    float timer = 0;
+    // Relecture : pas de simulation, pas de menu, juste la partie enregistrée
+    if (replayPath) {
+        int code = RunReplay(replayPath, scenarioPath);
+        UnloadCityCache();
+        CloseWindow();
+        return code;
+    }
+
+    // Quartier décrit par un fichier : la ville est construite avant de réserver les
+    // véhicules, pour que le scénario puisse fixer le nombre de civils
+    ScenarioDemand demand;
+    if (scenarioPath && !loadPath) {
+        std::string error;
+        if (!LoadScenario(scenarioPath, demand, error)) {
+            printf("Scenario %s illisible : %s\n", scenarioPath, error.c_str());
+            CloseWindow();
+            return 1;
+        }
+        if (demand.civilians >= 0) cars = demand.civilians;
+    }
+
+    // La simulation : voitures, feux et incidents (sans aucun dessin)
+    Simulation sim((demand.maxCivilians > cars ? demand.maxCivilians : cars) + DEFAULT_VEHICLE_CAPACITY);
+    if (loadPath) {
+        // Reprise : la ville et toute la partie viennent de la sauvegarde
+        std::string error;
+        if (!sim.LoadState(loadPath, error)) {
+            printf("Sauvegarde %s illisible : %s\n", loadPath, error.c_str());
+            CloseWindow();
+            return 1;
+        }
+    } else {
+        // Construction de la ville (routes et bâtiments), une fois pour toutes :
+        // la ville est en coordonnées du monde, la caméra se charge de la montrer.
+        // Sans "--city", elle remplit la fenêtre de départ.
+        // Avec "--scenario", elle est déjà construite.
+        bool bigCity = (cityCols > 0 && cityRows > 0) && !scenarioPath;
+        if (bigCity) BuildCity(cityCols, cityRows);
+        else if (!scenarioPath) RecalculateGrid(GetScreenWidth(), GetScreenHeight());
+
+        if (hasSeed) sim.SetSeed(seed);
+        // Grande ville : les bords sont loin, la moitié des civils partent de l'intérieur
+        if (bigCity) sim.interiorSpawnShare = 0.5f;
+        if (scenarioPath) ApplyScenarioDemand(demand, sim);
+        if (cars > 0) sim.maxCivilians = sim.PopulateCivilians(cars);
+        if (demand.maxCivilians >= 0) sim.maxCivilians = demand.maxCivilians;
+    }
+
+    // Enregistrement de la partie (chaque pas, écrit sur un thread à part)
+    TraceRecorder recorder;
+    if (recordPath) {
+        if (recorder.Open(recordPath, sim)) sim.recorder = &recorder;
+        else printf("Impossible d'ecrire %s\n", recordPath);
+    }
+
+    // La simulation tourne sur son propre thread dès que le jeu commence :
+    // on ne lit plus que ses photos, et on lui parle par commandes.
+    SimThread simThread(sim);
+
+    // Mesures du dessin (thread d'affichage) pour l'overlay de performance (touche 'P')
+    bool showProfile = false;
+    LatencyHistogram drawTimes(1e-6);
+    double drawSeconds = 0; // Moyenne glissante
 
     // --- BOUCLE PRINCIPALE (Tant qu'on ne ferme pas la fenêtre) ---
     while (!WindowShouldClose()) {
@@ -36,6 +121,7 @@ int main() {
         if (currentState == MENU) {
             if (IsKeyPressed(KEY_ENTER)) {
                 currentState = GAME; // Le joueur appuie sur Entrée -> Le jeu commence
+                simThread.Start();   // La ville se met à vivre (à cadence fixe, même si le dessin rame)
             }
             
             BeginDrawing();
@@ -56,7 +142,7 @@ int main() {
             int subW = MeasureText(sub, 20);
             DrawText(sub, sw/2 - subW/2, sh/2 + 20, 20, WHITE);
             
-            const char* info = "Controles: Souris pour boutons, 'N' pour Mode Nuit";
+            const char* info = "Controles: Souris pour boutons, 'N' pour Mode Nuit, 'P' pour le profil, Molette/Clic droit pour la camera";
             int infoW = MeasureText(info, 15);
             DrawText(info, sw/2 - infoW/2, sh/2 + 60, 15, DARKGRAY);
             
@@ -66,141 +152,45 @@ int main() {
         
         // --- B. LOGIQUE DU JEU (JOUABLE) ---
         
-        // Gestion du redimensionnement de la fenêtre (Reconstruire la ville si on change la taille)
-        if (IsWindowResized()) RecalculateGrid();
-
-        // Touche 'N' pour changer Jour / Nuit
-        if (IsKeyPressed(KEY_N)) isNight = !isNight;
-
-        // Gestion des feux tricolores (Timer de 3 secondes)
-        timer += GetFrameTime();
-        if (timer > 3.0f) { 
-            if(cycle == V_GREEN) cycle = V_YELLOW;
-            else if(cycle == V_YELLOW) cycle = H_GREEN;
-            else if(cycle == H_GREEN) cycle = H_YELLOW;
-            else if(cycle == H_YELLOW) cycle = V_GREEN;
-            timer = 0;
-        }
+        // (Redimensionner la fenêtre ne reconstruit plus la ville : on voit simplement plus ou moins loin)
 
-        // --- GÉNÉRATION D'ÉVÉNEMENTS ALÉATOIRES ---
-        
-        // 1. Incendies (Probabilité très faible par image : 3 sur 1000)
-        if (!fireActive && GetRandomValue(0, 1000) < 3) {
-            // Algorithme pour trouver un endroit libre (pas sur une route, pas sur un bâtiment)
-            for(int attempt=0; attempt<10; attempt++) {
-                int col = GetRandomValue(0, vRoads.size()); 
-                int row = GetRandomValue(0, hRoads.size());
-                
-                // Calcul des limites d'un bloc de maisons entre les routes
-                float minX = (col == 0) ? SIDEBAR_WIDTH : vRoads[col-1] + ROAD_WIDTH/2;
-                float maxX = (col == (int)vRoads.size()) ? GetScreenWidth() : vRoads[col] - ROAD_WIDTH/2;
-                float minY = (row == 0) ? 0 : hRoads[row-1] + ROAD_WIDTH/2;
-                float maxY = (row == (int)hRoads.size()) ? GetScreenHeight() : hRoads[row] - ROAD_WIDTH/2;
-
-                Rectangle zone = { minX, minY, maxX - minX, maxY - minY };
-
-                // Si la zone est assez grande
-                if (zone.width > 20 && zone.height > 20) {
-                    // On choisit un coin du bloc au hasard
-                    int corner = GetRandomValue(0, 3);
-                    float pad = 20.0f;
-                    Vector2 candidate;
-                    
-                    if(corner == 0) candidate = (Vector2){ zone.x + pad, zone.y + pad }; 
-                    else if(corner == 1) candidate = (Vector2){ zone.x + zone.width - pad, zone.y + pad };
-                    else if(corner == 2) candidate = (Vector2){ zone.x + pad, zone.y + zone.height - pad }; 
-                    else candidate = (Vector2){ zone.x + zone.width - pad, zone.y + zone.height - pad }; 
-
-                    // Vérification finale : pas sur un bâtiment existant (Police/Hopital/Caserne)
-                    bool onBuilding = false;
-                    for(const auto& b : buildings) {
-                        if(CheckCollisionPointRec(candidate, b.rect)) { onBuilding = true; break; }
-                    }
-                    // Si c'est libre, on déclenche le feu !
-                    if(!onBuilding) { firePos = candidate; fireActive = true; break; }
-                }
-            }
-        }
+        // Touche 'N' pour changer Jour / Nuit (appliqué par la simulation au pas suivant)
+        if (IsKeyPressed(KEY_N)) simThread.Send({ CMD_TOGGLE_NIGHT, CIVIL, 0 });
 
-        // 2. Accidents de la route
-        if (!accidentActive && GetRandomValue(0, 1000) < 3) {
-            accidentActive = true;
-            accidentPos = GetRandomRoadTarget(); // Sur une intersection
-        }
+        // Vitesse de la simulation : 1 = temps réel, 2 = x10, 3 = x100, 4 = maximum
+        if (IsKeyPressed(KEY_ONE)) simThread.Send({ CMD_SET_SPEED, CIVIL, 1 });
+        if (IsKeyPressed(KEY_TWO)) simThread.Send({ CMD_SET_SPEED, CIVIL, 10 });
+        if (IsKeyPressed(KEY_THREE)) simThread.Send({ CMD_SET_SPEED, CIVIL, 100 });
+        if (IsKeyPressed(KEY_FOUR)) simThread.Send({ CMD_SET_SPEED, CIVIL, SPEED_MAX });
+        // Touche F5 : sauvegarde rapide de toute la partie (reprise avec "--load")
+        if (IsKeyPressed(KEY_F5)) simThread.Send({ CMD_SAVE_STATE, CIVIL, 0 });
 
-        // 3. Apparition automatique des voitures civiles
-        if (GetRandomValue(0, 80) == 0 && cars.size() < 35) {
-            Car* newCar = new Car(CIVIL, cars);
-            if(newCar->active) cars.push_back(newCar);
-            else delete newCar; 
-        }
+        // Caméra : molette (zoom), clic droit glissé ou flèches (déplacement), 'R' (retour)
+        UpdateCityCamera();
 
-        // Mise à jour de toutes les voitures (Mouvement, IA, Collisions)
-        for (int i=0; i<cars.size(); i++) {
-            cars[i]->Update(cycle, cars, isNight);
-            // Suppression des voitures sorties de l'écran ou garées (ménage mémoire)
-            if (!cars[i]->active) { delete cars[i]; cars.erase(cars.begin()+i); i--; }
-        }
+        // Dernière photo publiée par le thread de simulation (inchangée pendant tout le dessin)
+        const SimSnapshot& snap = simThread.Latest();
+
+        // Touche 'S' : mode des feux suivant (fixe -> adaptatif -> onde verte)
+        if (IsKeyPressed(KEY_S)) simThread.Send({ CMD_SET_SIGNAL_MODE, CIVIL, (snap.signalMode + 1) % 3 });
+        // Touche 'P' : mesures de performance à la place de la mini-carte
+        if (IsKeyPressed(KEY_P)) showProfile = !showProfile;
+        isNight = snap.isNight;
 
         // --- C. DESSIN (Rendu Graphique) ---
         BeginDrawing();
         ClearBackground(COLOR_GRASS);
 
-        int sw = GetScreenWidth();
         int sh = GetScreenHeight();
 
-        // 1. Routes (Asphalte)
-        for(float vx : vRoads) DrawRectangle(vx-ROAD_WIDTH/2, 0, ROAD_WIDTH, sh, COLOR_ROAD);
-        for(float hy : hRoads) DrawRectangle(SIDEBAR_WIDTH, hy-ROAD_WIDTH/2, sw-SIDEBAR_WIDTH, ROAD_WIDTH, COLOR_ROAD);
-        
-        // 2. EFFET NUIT (Filtre sombre sur le sol)
-        // On le dessine APRES le sol mais AVANT les lumières
-        if (isNight) {
-            DrawRectangle(SIDEBAR_WIDTH, 0, sw-SIDEBAR_WIDTH, sh, Fade(BLACK, 0.7f));
-        }
-
-        // 3. Feux tricolores (Dessinés par dessus la nuit pour briller)
-        for(float vx : vRoads) {
-            for(float hy : hRoads) {
-                DrawIntersectionLights(vx, hy, cycle, isNight);
-            }
-        }
-
-        // 4. Lignes pointillées au centre des routes
-        for(float vx : vRoads) DrawDashedLine((Vector2){vx, 0}, (Vector2){vx, (float)sh}, 2, COLOR_LINE);
-        for(float hy : hRoads) DrawDashedLine((Vector2){(float)SIDEBAR_WIDTH, hy}, (Vector2){(float)sw, hy}, 2, COLOR_LINE);
-
-        // 5. Bâtiments
-        for(auto& b : buildings) {
-            DrawLineEx(b.center, b.entryPoint, 15, DARKGRAY); // Allée de garage
-            DrawRectangleRec(b.rect, b.color);
-            DrawRectangleLinesEx(b.rect, 3, BLACK);
-            DrawText(b.label.c_str(), b.rect.x, b.rect.y - 15, 10, isNight ? WHITE : BLACK);
-            
-            // Fenêtres allumées la nuit
-            if (isNight) {
-                DrawRectangle(b.rect.x + 10, b.rect.y + 10, 10, 10, YELLOW);
-                DrawRectangle(b.rect.x + 30, b.rect.y + 10, 10, 10, YELLOW);
-                DrawRectangle(b.rect.x + 10, b.rect.y + 30, 10, 10, YELLOW);
-            }
-        }
-
-        // 6. Événements visuels (Feu et Sang)
-        if (fireActive) {
-            DrawCircleV(firePos, 30 + sin(GetTime()*10)*10, Fade(ORANGE, 0.6f)); // Halo qui bouge
-            DrawCircleV(firePos, 20 + sin(GetTime()*15)*8, Fade(RED, 0.7f));    // Cœur du feu
-            DrawText("FEU", firePos.x - 10, firePos.y - 10, 20, YELLOW);
-        }
-
-        if (accidentActive) {
-            DrawCircle(accidentPos.x, accidentPos.y, 15, COLOR_BLOOD);
-            DrawCircle(accidentPos.x+5, accidentPos.y+5, 10, COLOR_BLOOD);
-            DrawCircle(accidentPos.x-5, accidentPos.y-4, 8, COLOR_BLOOD);
-            DrawText("ACCIDENT", accidentPos.x - 20, accidentPos.y - 30, 15, RED);
-        }
-
-        // 7. Voitures
-        for(auto c : cars) c->Draw(isNight);
+        // 1 à 7. La ville (routes, feux, bâtiments, incidents, voitures), vue par la caméra
+        double drawStart = Profiler::Now();
+        BeginMode2D(cityCamera);
+        DrawCity(snap, isNight, GetCameraView(), cityCamera.zoom, SimThread::InterpolationAlpha(snap));
+        EndMode2D();
+        double drawTime = Profiler::Now() - drawStart; // Envoi des commandes de dessin (le GPU termine après)
+        drawTimes.Record(drawTime);
+        drawSeconds += (drawTime - drawSeconds) * 0.05;
 
         // 8. BARRE LATÉRALE (Interface utilisateur à gauche)
         DrawRectangle(0, 0, SIDEBAR_WIDTH, sh, COLOR_SIDEBAR);
@@ -208,27 +198,44 @@ int main() {
 
         DrawText("URGENCES", 20, 20, 30, WHITE);
         
-        // Boutons pour lancer des véhicules manuellement
+        // Boutons pour lancer des véhicules manuellement (commande envoyée à la simulation)
         if(DrawButton((Rectangle){20, 80, 200, 40}, BLUE, WHITE, "POLICE")) {
-            Car* c = new Car(POLICE, cars); if(c->active) cars.push_back(c); else delete c;
+            simThread.Send({ CMD_SPAWN, POLICE, 0 });
         }
         if(DrawButton((Rectangle){20, 140, 200, 40}, RED, WHITE, "POMPIERS")) {
-            Car* c = new Car(FIRE, cars); if(c->active) cars.push_back(c); else delete c;
+            simThread.Send({ CMD_SPAWN, FIRE, 0 });
         }
         if(DrawButton((Rectangle){20, 200, 200, 40}, WHITE, BLACK, "AMBULANCE")) {
-            Car* c = new Car(AMBULANCE, cars); if(c->active) cars.push_back(c); else delete c;
+            simThread.Send({ CMD_SPAWN, AMBULANCE, 0 });
         }
 
         // Mini-carte et infos
-        DrawMiniMap(cars);
-        DrawText(TextFormat("Voitures: %d", (int)cars.size()), 20, sh-40, 20, GRAY);
+        if (showProfile) DrawProfileOverlay(snap, drawSeconds * 1000.0, drawTimes.Percentile(0.99) * 1000.0);
+        else DrawMiniMap(snap);
+        DrawText(TextFormat("Voitures: %d  Incidents: %d", snap.Size(), (int)snap.incidents.size()), 20, sh-40, 20,
+                 snap.waitingIncidents > 0 ? ORANGE : GRAY); // Orange : des incidents attendent un véhicule
         DrawText("MODE NUIT: [N]", 20, sh-80, 20, isNight ? YELLOW : GRAY);
+        DrawText(TextFormat("ZOOM: x%.2f  [R]", cityCamera.zoom), 20, sh-120, 20, GRAY);
+
+        // Heure de la ville (temps simulé) et vitesse : réglée par [1] [2] [3] [4]
+        long long cityTime = (long long)(snap.tick * SIM_DT);
+        DrawText(TextFormat("HEURE: %02lld:%02lld:%02lld", cityTime / 3600, cityTime / 60 % 60, cityTime % 60), 20, sh-200, 20, GRAY);
+        if (snap.speed == SPEED_MAX) DrawText(TextFormat("VITESSE: MAX (x%.0f) [1-4]", snap.ticksPerSecond * SIM_DT), 20, sh-160, 20, ORANGE);
+        else DrawText(TextFormat("VITESSE: x%d [1-4]", snap.speed), 20, sh-160, 20, snap.speed > 1 ? ORANGE : GRAY);
+
+        // Mode des feux et attente moyenne aux carrefours (plus petit : juste sous la mini-carte)
+        const char* signalNames[] = { "FIXES", "ADAPTATIFS", "ONDE VERTE" };
+        DrawText(TextFormat("FEUX: %s [S]", signalNames[snap.signalMode]), 20, sh-244, 16, snap.signalMode != SIGNAL_FIXED ? GREEN : GRAY);
+        DrawText(TextFormat("ATTENTE AUX FEUX: %.1f s", snap.averageDelay), 20, sh-224, 16, GRAY);
 
         EndDrawing();
     }
     
-    // Nettoyage de la mémoire avant de quitter (très important en C++)
-    for(auto c : cars) delete c;
+    // On arrête la simulation avant tout le reste (elle ne doit plus toucher à rien)
+    simThread.Stop();
+    recorder.Close(); // Écrit les derniers pas
+    // Les voitures sont libérées par le destructeur de la Simulation
+    UnloadCityCache(); // La texture du fond doit être libérée avant de fermer la fenêtre
     CloseWindow();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**
+ * FICHIER PROJETÉ EN MÉMOIRE
+ * Ouverture d'un fichier en lecture seule par mmap (POSIX) ou MapViewOfFile (Windows),
+ * voir mapped_file.h.
+ */
+
+#include "../include/mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), size(0), mapping(nullptr), file(-1) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle((HANDLE)mapping);
+    if (file != -1) CloseHandle((HANDLE)file);
+#else
+    if (data) munmap((void*)data, size);
+    if (file != -1) close((int)file);
+#endif
+    data = nullptr;
+    mapping = nullptr;
+    file = -1;
+    size = 0;
+}
+
+bool MappedFile::Open(const char* path) {
+    Close();
+    error.clear();
+
+#ifdef _WIN32
+    HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) { error = "fichier introuvable"; return false; }
+    file = (intptr_t)h;
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(h, &length)) { error = "taille du fichier illisible"; Close(); return false; }
+    size = (size_t)length.QuadPart;
+    if (size == 0) return true; // Rien à projeter
+    mapping = CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping) data = (const uint8_t*)MapViewOfFile((HANDLE)mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { error = "fichier introuvable"; return false; }
+    file = fd;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { error = "taille du fichier illisible"; Close(); return false; }
+    size = (size_t)st.st_size;
+    if (size == 0) return true; // mmap refuse une longueur nulle
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) data = (const uint8_t*)p;
+#endif
+    if (!data) { error = "projection en memoire impossible"; Close(); return false; }
+    return true;
+}
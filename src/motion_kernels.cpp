@@ -0,0 +1,351 @@
+/**
+ * NOYAUX DE CALCUL PAR PAQUETS (SIMD)
+ * Mouvement des voitures et tests capteur / carrosserie, en trois versions
+ * (une voiture, 4 voitures SSE2, 8 voitures AVX2) qui donnent le même résultat au bit près.
+ * Le niveau pris au lancement est SSE2 quand le processeur le permet (voir motion_kernels.h).
+ */
+
+#include "../include/motion_kernels.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SMARTCITY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// Les fonctions AVX2 sont compilées pour AVX2 seulement (le reste du programme tourne
+// partout) ; on n'active pas FMA : a + b * c doit rester arrondi deux fois, comme en scalaire.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+// --- VERSION SCALAIRE (LA RÉFÉRENCE) ---
+// Les versions SIMD refont exactement ces calculs, dans le même ordre
+static inline void IntegrateOne(Vector2& p, float& s, Dir d, float desired, float lane, uint8_t flags,
+                                Rectangle city, uint8_t& outside) {
+    outside = 0;
+    if (flags & MOTION_SKIP) return;
+
+    // Vitesse
+    if (desired < 0.0f) {
+        s = s + 0.3f * (0.0f - s);  // Freinage rapide
+        if (s < 0.05f) s = 0.0f;    // Arrêt complet
+    } else {
+        s = s + 0.05f * (desired - s); // Accélération douce
+    }
+
+    // Avance, puis aimantation vers la voie sur l'axe en travers
+    if (d == UP)    p.y -= s;
+    if (d == DOWN)  p.y += s;
+    if (d == LEFT)  p.x -= s;
+    if (d == RIGHT) p.x += s;
+    if (d == UP || d == DOWN) p.x = p.x + 0.15f * (lane - p.x);
+    else p.y = p.y + 0.15f * (lane - p.y);
+
+    outside = (p.x < city.x || p.x > city.x + city.width || p.y < city.y || p.y > city.y + city.height) ? 1 : 0;
+}
+
+static void IntegrateScalar(Vector2* pos, float* speed, const Dir* dir, const float* desired, const float* lane,
+                            const uint8_t* flags, int count, Rectangle city, uint8_t* outside) {
+    for (int k = 0; k < count; k++) {
+        IntegrateOne(pos[k], speed[k], dir[k], desired[k], lane[k], flags[k], city, outside[k]);
+    }
+}
+
+// Rectangle de la voiture (comme GetCarRect) contre le capteur (comme CheckCollisionRecs)
+static inline bool OverlapOne(Rectangle sensor, Vector2 p, Dir d) {
+    bool vertical = (d == UP || d == DOWN);
+    float left = p.x - (vertical ? 8.0f : 13.0f);
+    float top = p.y - (vertical ? 13.0f : 8.0f);
+    float right = left + (vertical ? 16.0f : 26.0f);
+    float bottom = top + (vertical ? 26.0f : 16.0f);
+    return sensor.x < right && sensor.x + sensor.width > left && sensor.y < bottom && sensor.y + sensor.height > top;
+}
+
+static uint32_t OverlapScalar(Rectangle sensor, const Vector2* pos, const Dir* dir, const int* ids, int count) {
+    uint32_t hits = 0;
+    for (int k = 0; k < count; k++) {
+        if (OverlapOne(sensor, pos[ids[k]], dir[ids[k]])) hits |= 1u << k;
+    }
+    return hits;
+}
+
+#ifdef SMARTCITY_X86
+// Les voitures à tester sont éparpillées dans les tableaux : on les recopie d'abord côte à côte
+// (x, y, vertical), complétées jusqu'à un paquet entier par des voitures "NaN" qui ne touchent rien
+struct OverlapBatch {
+    alignas(32) float x[SENSOR_BATCH];
+    alignas(32) float y[SENSOR_BATCH];
+    alignas(32) int32_t vertical[SENSOR_BATCH]; // -1 = UP ou DOWN, 0 sinon
+};
+
+static int GatherBatch(OverlapBatch& b, const Vector2* pos, const Dir* dir, const int* ids, int count, int width) {
+    for (int k = 0; k < count; k++) {
+        Vector2 p = pos[ids[k]];
+        Dir d = dir[ids[k]];
+        b.x[k] = p.x; b.y[k] = p.y;
+        b.vertical[k] = (d == UP || d == DOWN) ? -1 : 0;
+    }
+    int padded = (count + width - 1) / width * width;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (int k = count; k < padded; k++) { b.x[k] = nan; b.y[k] = nan; b.vertical[k] = 0; }
+    return padded;
+}
+
+// --- VERSION SSE2 (4 VOITURES) ---
+// Sélection sans "blend" (SSE4.1) : (masque ET a) OU (NON masque ET b)
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static void IntegrateSse2(Vector2* pos, float* speed, const Dir* dir, const float* desired, const float* lane,
+                          const uint8_t* flags, int count, Rectangle city, uint8_t* outside) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 brake = _mm_set1_ps(0.3f), accel = _mm_set1_ps(0.05f), stop = _mm_set1_ps(0.05f);
+    const __m128 lock = _mm_set1_ps(0.15f);
+    const __m128 minX = _mm_set1_ps(city.x), maxX = _mm_set1_ps(city.x + city.width);
+    const __m128 minY = _mm_set1_ps(city.y), maxY = _mm_set1_ps(city.y + city.height);
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        // Directions et drapeaux des 4 voitures
+        __m128i d = _mm_set_epi32(dir[k + 3], dir[k + 2], dir[k + 1], dir[k]);
+        __m128i f = _mm_set_epi32(flags[k + 3], flags[k + 2], flags[k + 1], flags[k]);
+        __m128 skip = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(f, _mm_set1_epi32(MOTION_SKIP)), _mm_set1_epi32(MOTION_SKIP)));
+        __m128 up = _mm_castsi128_ps(_mm_cmpeq_epi32(d, _mm_set1_epi32(UP)));
+        __m128 down = _mm_castsi128_ps(_mm_cmpeq_epi32(d, _mm_set1_epi32(DOWN)));
+        __m128 left = _mm_castsi128_ps(_mm_cmpeq_epi32(d, _mm_set1_epi32(LEFT)));
+        __m128 right = _mm_castsi128_ps(_mm_cmpeq_epi32(d, _mm_set1_epi32(RIGHT)));
+        __m128 vertical = _mm_or_ps(up, down);
+
+        // 1. Vitesse
+        __m128 s = _mm_loadu_ps(speed + k);
+        __m128 want = _mm_loadu_ps(desired + k);
+        __m128 braked = _mm_add_ps(s, _mm_mul_ps(brake, _mm_sub_ps(zero, s)));
+        braked = _mm_andnot_ps(_mm_cmplt_ps(braked, stop), braked);
+        __m128 eased = _mm_add_ps(s, _mm_mul_ps(accel, _mm_sub_ps(want, s)));
+        __m128 ns = Select(_mm_cmplt_ps(want, zero), braked, eased);
+        ns = Select(skip, s, ns);
+        _mm_storeu_ps(speed + k, ns);
+
+        // 2. Position : x0 y0 x1 y1 | x2 y2 x3 y3 -> x0 x1 x2 x3 et y0 y1 y2 y3
+        __m128 a = _mm_loadu_ps(&pos[k].x);
+        __m128 b = _mm_loadu_ps(&pos[k + 2].x);
+        __m128 x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 ln = _mm_loadu_ps(lane + k);
+        __m128 xMoved = Select(left, _mm_sub_ps(x, ns), Select(right, _mm_add_ps(x, ns), x));
+        __m128 yMoved = Select(up, _mm_sub_ps(y, ns), Select(down, _mm_add_ps(y, ns), y));
+        __m128 nx = Select(vertical, _mm_add_ps(xMoved, _mm_mul_ps(lock, _mm_sub_ps(ln, xMoved))), xMoved);
+        __m128 ny = Select(vertical, yMoved, _mm_add_ps(yMoved, _mm_mul_ps(lock, _mm_sub_ps(ln, yMoved))));
+        nx = Select(skip, x, nx);
+        ny = Select(skip, y, ny);
+        _mm_storeu_ps(&pos[k].x, _mm_unpacklo_ps(nx, ny));
+        _mm_storeu_ps(&pos[k + 2].x, _mm_unpackhi_ps(nx, ny));
+
+        // 3. Hors de la ville ?
+        __m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(nx, minX), _mm_cmpgt_ps(nx, maxX)),
+                               _mm_or_ps(_mm_cmplt_ps(ny, minY), _mm_cmpgt_ps(ny, maxY)));
+        int bits = _mm_movemask_ps(_mm_andnot_ps(skip, out));
+        for (int l = 0; l < 4; l++) outside[k + l] = (bits >> l) & 1;
+    }
+    IntegrateScalar(pos + k, speed + k, dir + k, desired + k, lane + k, flags + k, count - k, city, outside + k);
+}
+
+static uint32_t OverlapSse2(Rectangle sensor, const Vector2* pos, const Dir* dir, const int* ids, int count) {
+    OverlapBatch b;
+    int padded = GatherBatch(b, pos, dir, ids, count, 4);
+    const __m128 sLeft = _mm_set1_ps(sensor.x), sRight = _mm_set1_ps(sensor.x + sensor.width);
+    const __m128 sTop = _mm_set1_ps(sensor.y), sBottom = _mm_set1_ps(sensor.y + sensor.height);
+    uint32_t hits = 0;
+    for (int k = 0; k < padded; k += 4) {
+        __m128 vertical = _mm_castsi128_ps(_mm_load_si128((const __m128i*)(b.vertical + k)));
+        __m128 halfW = Select(vertical, _mm_set1_ps(8.0f), _mm_set1_ps(13.0f));
+        __m128 halfH = Select(vertical, _mm_set1_ps(13.0f), _mm_set1_ps(8.0f));
+        __m128 width = Select(vertical, _mm_set1_ps(16.0f), _mm_set1_ps(26.0f));
+        __m128 height = Select(vertical, _mm_set1_ps(26.0f), _mm_set1_ps(16.0f));
+        __m128 left = _mm_sub_ps(_mm_load_ps(b.x + k), halfW);
+        __m128 top = _mm_sub_ps(_mm_load_ps(b.y + k), halfH);
+        __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(sLeft, _mm_add_ps(left, width)), _mm_cmpgt_ps(sRight, left)),
+                                _mm_and_ps(_mm_cmplt_ps(sTop, _mm_add_ps(top, height)), _mm_cmpgt_ps(sBottom, top)));
+        hits |= (uint32_t)_mm_movemask_ps(hit) << k;
+    }
+    return hits;
+}
+
+// --- VERSION AVX2 (8 VOITURES) ---
+TARGET_AVX2
+static void IntegrateAvx2(Vector2* pos, float* speed, const Dir* dir, const float* desired, const float* lane,
+                          const uint8_t* flags, int count, Rectangle city, uint8_t* outside) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 brake = _mm256_set1_ps(0.3f), accel = _mm256_set1_ps(0.05f), stop = _mm256_set1_ps(0.05f);
+    const __m256 lock = _mm256_set1_ps(0.15f);
+    const __m256 minX = _mm256_set1_ps(city.x), maxX = _mm256_set1_ps(city.x + city.width);
+    const __m256 minY = _mm256_set1_ps(city.y), maxY = _mm256_set1_ps(city.y + city.height);
+    const __m256i skipBit = _mm256_set1_epi32(MOTION_SKIP);
+    int k = 0;
+    for (; k + 8 <= count; k += 8) {
+        // Directions et drapeaux : 8 octets -> 8 entiers
+        __m256i d = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(dir + k)));
+        __m256i f = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(flags + k)));
+        __m256 skip = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(f, skipBit), skipBit));
+        __m256 up = _mm256_castsi256_ps(_mm256_cmpeq_epi32(d, _mm256_set1_epi32(UP)));
+        __m256 down = _mm256_castsi256_ps(_mm256_cmpeq_epi32(d, _mm256_set1_epi32(DOWN)));
+        __m256 left = _mm256_castsi256_ps(_mm256_cmpeq_epi32(d, _mm256_set1_epi32(LEFT)));
+        __m256 right = _mm256_castsi256_ps(_mm256_cmpeq_epi32(d, _mm256_set1_epi32(RIGHT)));
+        __m256 vertical = _mm256_or_ps(up, down);
+
+        // 1. Vitesse
+        __m256 s = _mm256_loadu_ps(speed + k);
+        __m256 want = _mm256_loadu_ps(desired + k);
+        __m256 braked = _mm256_add_ps(s, _mm256_mul_ps(brake, _mm256_sub_ps(zero, s)));
+        braked = _mm256_andnot_ps(_mm256_cmp_ps(braked, stop, _CMP_LT_OQ), braked);
+        __m256 eased = _mm256_add_ps(s, _mm256_mul_ps(accel, _mm256_sub_ps(want, s)));
+        __m256 ns = _mm256_blendv_ps(eased, braked, _mm256_cmp_ps(want, zero, _CMP_LT_OQ));
+        ns = _mm256_blendv_ps(ns, s, skip);
+        _mm256_storeu_ps(speed + k, ns);
+
+        // 2. Position : x0 y0 .. x3 y3 | x4 y4 .. x7 y7 -> x0 .. x7 et y0 .. y7
+        // (shuffle dans chaque moitié, puis on remet les morceaux de 64 bits dans l'ordre)
+        __m256 a = _mm256_loadu_ps(&pos[k].x);
+        __m256 b = _mm256_loadu_ps(&pos[k + 4].x);
+        __m256 x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 ln = _mm256_loadu_ps(lane + k);
+        __m256 xMoved = _mm256_blendv_ps(_mm256_blendv_ps(x, _mm256_add_ps(x, ns), right), _mm256_sub_ps(x, ns), left);
+        __m256 yMoved = _mm256_blendv_ps(_mm256_blendv_ps(y, _mm256_add_ps(y, ns), down), _mm256_sub_ps(y, ns), up);
+        __m256 nx = _mm256_blendv_ps(xMoved, _mm256_add_ps(xMoved, _mm256_mul_ps(lock, _mm256_sub_ps(ln, xMoved))), vertical);
+        __m256 ny = _mm256_blendv_ps(_mm256_add_ps(yMoved, _mm256_mul_ps(lock, _mm256_sub_ps(ln, yMoved))), yMoved, vertical);
+        nx = _mm256_blendv_ps(nx, x, skip);
+        ny = _mm256_blendv_ps(ny, y, skip);
+        // Retour à x, y côte à côte
+        __m256 lo = _mm256_unpacklo_ps(nx, ny); // x0 y0 x1 y1 | x4 y4 x5 y5
+        __m256 hi = _mm256_unpackhi_ps(nx, ny); // x2 y2 x3 y3 | x6 y6 x7 y7
+        _mm256_storeu_ps(&pos[k].x, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(&pos[k + 4].x, _mm256_permute2f128_ps(lo, hi, 0x31));
+
+        // 3. Hors de la ville ?
+        __m256 out = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(nx, minX, _CMP_LT_OQ), _mm256_cmp_ps(nx, maxX, _CMP_GT_OQ)),
+                                  _mm256_or_ps(_mm256_cmp_ps(ny, minY, _CMP_LT_OQ), _mm256_cmp_ps(ny, maxY, _CMP_GT_OQ)));
+        int bits = _mm256_movemask_ps(_mm256_andnot_ps(skip, out));
+        for (int l = 0; l < 8; l++) outside[k + l] = (bits >> l) & 1;
+    }
+    IntegrateScalar(pos + k, speed + k, dir + k, desired + k, lane + k, flags + k, count - k, city, outside + k);
+}
+
+TARGET_AVX2
+static uint32_t OverlapAvx2(Rectangle sensor, const Vector2* pos, const Dir* dir, const int* ids, int count) {
+    OverlapBatch b;
+    int padded = GatherBatch(b, pos, dir, ids, count, 8);
+    const __m256 sLeft = _mm256_set1_ps(sensor.x), sRight = _mm256_set1_ps(sensor.x + sensor.width);
+    const __m256 sTop = _mm256_set1_ps(sensor.y), sBottom = _mm256_set1_ps(sensor.y + sensor.height);
+    uint32_t hits = 0;
+    for (int k = 0; k < padded; k += 8) {
+        __m256 vertical = _mm256_castsi256_ps(_mm256_load_si256((const __m256i*)(b.vertical + k)));
+        __m256 halfW = _mm256_blendv_ps(_mm256_set1_ps(13.0f), _mm256_set1_ps(8.0f), vertical);
+        __m256 halfH = _mm256_blendv_ps(_mm256_set1_ps(8.0f), _mm256_set1_ps(13.0f), vertical);
+        __m256 width = _mm256_blendv_ps(_mm256_set1_ps(26.0f), _mm256_set1_ps(16.0f), vertical);
+        __m256 height = _mm256_blendv_ps(_mm256_set1_ps(16.0f), _mm256_set1_ps(26.0f), vertical);
+        __m256 left = _mm256_sub_ps(_mm256_load_ps(b.x + k), halfW);
+        __m256 top = _mm256_sub_ps(_mm256_load_ps(b.y + k), halfH);
+        __m256 hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(sLeft, _mm256_add_ps(left, width), _CMP_LT_OQ),
+                                                 _mm256_cmp_ps(sRight, left, _CMP_GT_OQ)),
+                                   _mm256_and_ps(_mm256_cmp_ps(sTop, _mm256_add_ps(top, height), _CMP_LT_OQ),
+                                                 _mm256_cmp_ps(sBottom, top, _CMP_GT_OQ)));
+        hits |= (uint32_t)_mm256_movemask_ps(hit) << k;
+    }
+    return hits;
+}
+
+// --- CE QUE SAIT FAIRE LE PROCESSEUR ---
+static bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+    if (!osSavesAvx) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init(); // Peut être appelé avant les constructeurs globaux de la bibliothèque
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif // SMARTCITY_X86
+
+// --- CHOIX DES NOYAUX ---
+typedef void (*IntegrateFn)(Vector2*, float*, const Dir*, const float*, const float*, const uint8_t*, int, Rectangle, uint8_t*);
+typedef uint32_t (*OverlapFn)(Rectangle, const Vector2*, const Dir*, const int*, int);
+
+struct KernelTable {
+    KernelLevel level;
+    IntegrateFn integrate;
+    OverlapFn overlap;
+};
+
+static KernelTable TableFor(KernelLevel level) {
+#ifdef SMARTCITY_X86
+    if (level == KERNEL_AVX2) return { KERNEL_AVX2, IntegrateAvx2, OverlapAvx2 };
+    if (level == KERNEL_SSE2) return { KERNEL_SSE2, IntegrateSse2, OverlapSse2 };
+#endif
+    return { KERNEL_SCALAR, IntegrateScalar, OverlapScalar };
+}
+
+KernelLevel BestKernelLevel() {
+#ifdef SMARTCITY_X86
+    static const KernelLevel best = CpuHasAvx2() ? KERNEL_AVX2 : KERNEL_SSE2;
+    return best;
+#else
+    return KERNEL_SCALAR;
+#endif
+}
+
+// Mesuré sur des pas complets (sim_step/N/K) : AVX2 gagne sur IntegrateMotion seul mais perd
+// sur le pas entier, SSE2 est le plus rapide des trois
+KernelLevel DefaultKernelLevel() {
+    return std::min(KERNEL_SSE2, BestKernelLevel());
+}
+
+static KernelTable kernels = TableFor(DefaultKernelLevel());
+
+KernelLevel ActiveKernelLevel() { return kernels.level; }
+
+KernelLevel SetKernelLevel(KernelLevel level) {
+    if (level > BestKernelLevel()) level = BestKernelLevel();
+    kernels = TableFor(level);
+    return kernels.level;
+}
+
+const char* KernelLevelName(KernelLevel level) {
+    switch (level) {
+        case KERNEL_AVX2: return "avx2";
+        case KERNEL_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+bool ParseKernelLevel(const char* name, KernelLevel& level) {
+    const KernelLevel all[] = { KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2 };
+    for (KernelLevel l : all) {
+        if (strcmp(name, KernelLevelName(l)) == 0) { level = l; return true; }
+    }
+    return false;
+}
+
+// --- POINTS D'ENTRÉE ---
+void IntegrateMotion(Vector2* pos, float* speed, const Dir* dir, const float* desired, const float* lane,
+                     const uint8_t* flags, int count, Rectangle city, uint8_t* outside) {
+    kernels.integrate(pos, speed, dir, desired, lane, flags, count, city, outside);
+}
+
+uint32_t OverlapSensor(Rectangle sensor, const Vector2* pos, const Dir* dir, const int* ids, int count) {
+    // Petit paquet : recopier les voitures côte à côte coûte plus que les tester une à une
+    if (count < SENSOR_SIMD_MIN) return OverlapScalar(sensor, pos, dir, ids, count);
+    return kernels.overlap(sensor, pos, dir, ids, count);
+}
@@ -0,0 +1,125 @@
+/**
+ * MESURES DE PERFORMANCE
+ * Chronomètres par étape, compteurs et histogrammes de durées (voir profiler.h).
+ */
+
+#include "../include/profiler.h"
+#include <algorithm>
+#include <cmath>
+
+const char* ProfilePhaseName(ProfilePhase phase) {
+    static const char* names[PHASE_COUNT] = {
+        "feux", "incidents", "repartiteur", "apparition", "grille", "itineraires", "voitures", "menage", "photo"
+    };
+    return names[phase];
+}
+
+const char* ProfileCounterName(ProfileCounter counter) {
+    static const char* names[COUNTER_COUNT] = { "tests_collision", "cedez_passage", "freinages_urgence" };
+    return names[counter];
+}
+
+// --- HISTOGRAMME ---
+LatencyHistogram::LatencyHistogram(double s) : smallest(s) {
+    Clear();
+}
+
+void LatencyHistogram::Clear() {
+    std::fill(buckets, buckets + BUCKETS, 0LL);
+    count = 0;
+    sum = 0;
+    max = 0;
+}
+
+void LatencyHistogram::Record(double seconds) {
+    // Case = nombre de "quarts de doublement" au-dessus de la plus petite valeur
+    int k = 0;
+    if (seconds > smallest) k = (int)(std::log2(seconds / smallest) * SUB_BUCKETS);
+    k = std::min(std::max(k, 0), BUCKETS - 1);
+    buckets[k]++;
+    count++;
+    sum += seconds;
+    max = std::max(max, seconds);
+}
+
+double LatencyHistogram::BucketLow(int k) const {
+    return (k == 0) ? 0.0 : smallest * std::exp2((double)k / SUB_BUCKETS);
+}
+
+double LatencyHistogram::BucketHigh(int k) const {
+    return smallest * std::exp2((double)(k + 1) / SUB_BUCKETS);
+}
+
+double LatencyHistogram::Percentile(double p) const {
+    if (count == 0) return 0.0;
+    long long rank = (long long)std::ceil(p * count);
+    if (rank < 1) rank = 1;
+    long long seen = 0;
+    for (int k = 0; k < BUCKETS; k++) {
+        seen += buckets[k];
+        if (seen >= rank) return std::min(BucketHigh(k), max); // Jamais plus que la plus grande mesure
+    }
+    return max;
+}
+
+// --- PROFILER ---
+// Poids d'un nouveau pas dans les moyennes glissantes (~les 50 derniers pas)
+static const double RECENT_WEIGHT = 0.02;
+
+Profiler::Profiler() : enabled(true), tickTime(1e-6), travelTime(0.01), extinguishTime(0.01), treatTime(0.01) {
+    Clear();
+}
+
+void Profiler::Clear() {
+    tickTime.Clear();
+    travelTime.Clear();
+    extinguishTime.Clear();
+    treatTime.Clear();
+    totals = ProfileTotals();
+    current = ProfileTotals();
+    tickStart = 0;
+    std::fill(recentPhase, recentPhase + PHASE_COUNT, 0.0);
+    std::fill(recentCounter, recentCounter + COUNTER_COUNT, 0.0);
+    recentTick = 0;
+}
+
+void Profiler::BeginTick() {
+    if (enabled) tickStart = Now();
+}
+
+// Le pas en cours (et ce qui a été mesuré depuis la fin du précédent, comme la photo)
+// passe dans les totaux et les moyennes glissantes
+void Profiler::EndTick() {
+    double tick = enabled ? Now() - tickStart : 0.0;
+    if (enabled) tickTime.Record(tick);
+    recentTick += (tick - recentTick) * RECENT_WEIGHT;
+
+    totals.ticks++;
+    for (int k = 0; k < PHASE_COUNT; k++) {
+        totals.seconds[k] += current.seconds[k];
+        recentPhase[k] += (current.seconds[k] - recentPhase[k]) * RECENT_WEIGHT;
+    }
+    for (int k = 0; k < COUNTER_COUNT; k++) {
+        totals.counts[k] += current.counts[k];
+        recentCounter[k] += (current.counts[k] - recentCounter[k]) * RECENT_WEIGHT;
+    }
+    current = ProfileTotals();
+}
+
+void Profiler::AddCounters(const CarCounters& c) {
+    for (int k = 0; k < COUNTER_COUNT; k++) current.counts[k] += c.values[k];
+}
+
+void Profiler::FillSummary(ProfileSummary& s) const {
+    for (int k = 0; k < PHASE_COUNT; k++) s.phaseMs[k] = recentPhase[k] * 1000.0;
+    for (int k = 0; k < COUNTER_COUNT; k++) s.counterPerTick[k] = recentCounter[k];
+    s.tickMs = recentTick * 1000.0;
+    s.tickP50Ms = tickTime.Percentile(0.50) * 1000.0;
+    s.tickP99Ms = tickTime.Percentile(0.99) * 1000.0;
+    s.tickMaxMs = tickTime.Max() * 1000.0;
+    s.travelP50 = travelTime.Percentile(0.50);
+    s.travelP90 = travelTime.Percentile(0.90);
+    s.extinguishP50 = extinguishTime.Percentile(0.50);
+    s.treatP50 = treatTime.Percentile(0.50);
+    s.responses = travelTime.Count();
+}
@@ -0,0 +1,55 @@
+/**
+ * HASARD (RANDOM)
+ * Petit générateur de nombres aléatoires indépendant de Raylib.
+ * Basé sur un compteur : le n-ième nombre d'un flux se calcule directement,
+ * sans dépendre de l'ordre des appels (indispensable pour rejouer une partie
+ * au bit près, même avec plusieurs threads).
+ */
+
+#include "../include/random.h"
+#include <random>
+
+// Mélange "SplitMix64" : chaque bit de l'entrée change environ la moitié des bits de la sortie
+static uint64_t Mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+uint32_t RandomHash(uint64_t seed, uint64_t stream, uint64_t counter) {
+    // Deux passes de mélange : (graine, flux) donne une clé, puis la clé est mélangée au compteur
+    uint64_t key = Mix64(seed ^ Mix64(stream));
+    return (uint32_t)(Mix64(key ^ Mix64(counter + 0x632BE59BD9B4E019ull)) >> 32);
+}
+
+uint64_t RandomSeedFromDevice() {
+    std::random_device device;
+    return ((uint64_t)device() << 32) | device();
+}
+
+// Comme Raylib, on part d'une graine différente à chaque lancement
+Random::Random() : seed(RandomSeedFromDevice()), stream(0), counter(0) {}
+
+Random::Random(uint64_t seed, uint64_t stream) : seed(seed), stream(stream), counter(0) {}
+
+int Random::Range(int min, int max) {
+    if (min > max) { int tmp = max; max = min; min = tmp; } // Raylib accepte les bornes inversées
+    // Multiplication 32x32 -> 64 bits : ramène le nombre dans [0, taille) sans division
+    uint64_t size = (uint64_t)((int64_t)max - min + 1);
+    return (int)(min + (int64_t)(((uint64_t)Next() * size) >> 32));
+}
+
+unsigned int Random::Next() {
+    return RandomHash(seed, stream, counter++);
+}
+
+double Random::Uniform() {
+    return ((double)Next() + 0.5) / 4294967296.0;
+}
+
+void Random::Seed(uint64_t newSeed, uint64_t newStream) {
+    seed = newSeed;
+    stream = newStream;
+    counter = 0;
+}
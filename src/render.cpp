@@ -0,0 +1,407 @@
+/**
+ * RENDU (AFFICHAGE)
+ * Ce fichier contient tout le dessin de la ville avec Raylib :
+ * routes, marquages, feux tricolores, bâtiments, incidents et voitures.
+ * La simulation (simulation.cpp) ne dessine rien : c'est ici que ça se passe.
+ */
+
+#include "../include/render.h"
+#include "../include/world.h"
+#include "../include/spatial_hash.h"
+#include "rlgl.h"
+
+// --- DESSIN DE LIGNE POINTILLÉE ---
+// Raylib ne fait pas ça par défaut, donc on le fait à la main.
+// On dessine de petits segments les uns à la suite des autres avec des trous.
+void DrawDashedLine(Vector2 start, Vector2 end, float thick, Color color) {
+    Vector2 diff = Vector2Subtract(end, start);
+    float length = Vector2Length(diff);
+    Vector2 dir = Vector2Normalize(diff);
+    
+    // On avance de 30 pixels à chaque fois
+    for (float i = 0; i < length; i += 30) {
+        // Point de début du tiret
+        Vector2 p1 = Vector2Add(start, Vector2Scale(dir, i));
+        // Point de fin du tiret (longueur 15)
+        Vector2 p2 = Vector2Add(start, Vector2Scale(dir, fminf(i + 15, length)));
+        
+        DrawLineEx(p1, p2, thick, color);
+    }
+}
+
+// --- FOND STATIQUE EN CACHE ---
+// Au-delà de cette taille, la texture serait trop grosse pour la carte graphique :
+// on redessine alors le fond directement à chaque image (comme avant).
+static const int MAX_CACHE_SIZE = 8192;
+
+static RenderTexture2D cityCache;      // Le fond de la ville déjà dessiné
+static bool cacheLoaded = false;       // La texture existe-t-elle ?
+static int cacheVersion = -1;          // Version de la carte dessinée dans la texture
+static bool cacheNight = false;        // Mode nuit dessiné dans la texture
+static std::vector<Vector2> vBulbs;    // Ampoules des feux verticaux (2 par croisement)
+static std::vector<Vector2> hBulbs;    // Ampoules des feux horizontaux (2 par croisement)
+static int bulbsVersion = -1;
+
+void InvalidateCityCache() {
+    cacheVersion = -1;
+}
+
+void UnloadCityCache() {
+    if (cacheLoaded) UnloadRenderTexture(cityCache);
+    cacheLoaded = false;
+    cacheVersion = -1;
+}
+
+// Routes visibles sur un axe : [first, last) dans vRoads ou hRoads (avec une marge d'une demi-route)
+static void VisibleRoads(const RoadAxisIndex& index, float from, float to, int& first, int& last) {
+    float margin = ROAD_WIDTH;
+    first = index.Segment(from - margin);
+    last = index.Segment(to + margin);
+}
+
+// Tout ce qui ne bouge pas : routes, nuit, marquages, bâtiments (l'herbe est le fond).
+// Seul ce qui touche "view" est dessiné (toute la carte pour remplir la texture du cache).
+static void DrawStaticCity(bool isNight, Rectangle view, DetailLevel detail) {
+    // Partie visible de la ville (la ville commence après la barre latérale)
+    float left = fmaxf(view.x, (float)SIDEBAR_WIDTH);
+    float top = fmaxf(view.y, 0.0f);
+    float right = fminf(view.x + view.width, worldWidth);
+    float bottom = fminf(view.y + view.height, worldHeight);
+    if (right <= left || bottom <= top) return;
+
+    int firstV, lastV, firstH, lastH;
+    VisibleRoads(vRoadIndex, left, right, firstV, lastV);
+    VisibleRoads(hRoadIndex, top, bottom, firstH, lastH);
+
+    // 1. Routes (Asphalte)
+    for(int k = firstV; k < lastV; k++) DrawRectangle(vRoads[k]-ROAD_WIDTH/2, top, ROAD_WIDTH, bottom - top, COLOR_ROAD);
+    for(int k = firstH; k < lastH; k++) DrawRectangle(left, hRoads[k]-ROAD_WIDTH/2, right - left, ROAD_WIDTH, COLOR_ROAD);
+
+    // 2. EFFET NUIT (Filtre sombre sur le sol)
+    if (isNight) {
+        DrawRectangle(left, top, right - left, bottom - top, Fade(BLACK, 0.7f));
+    }
+
+    // 3. Lignes pointillées au centre des routes (invisibles de loin : moins d'un pixel)
+    // (elles partent d'un multiple de 30 pour que les tirets ne "glissent" pas quand on déplace la vue)
+    if (detail <= DETAIL_SIMPLE) {
+        float dashTop = floorf(top / 30) * 30;
+        float dashLeft = SIDEBAR_WIDTH + floorf((left - SIDEBAR_WIDTH) / 30) * 30;
+        for(int k = firstV; k < lastV; k++) DrawDashedLine((Vector2){vRoads[k], dashTop}, (Vector2){vRoads[k], bottom}, 2, COLOR_LINE);
+        for(int k = firstH; k < lastH; k++) DrawDashedLine((Vector2){dashLeft, hRoads[k]}, (Vector2){right, hRoads[k]}, 2, COLOR_LINE);
+    }
+
+    // 3 bis. Rues coupées (carte d'un scénario) : de l'herbe entre les deux carrefours
+    if (!closedSegments.empty()) {
+        int cols = (int)vRoads.size(), rows = (int)hRoads.size();
+        float half = ROAD_WIDTH / 2.0f;
+        Color grass = isNight ? ColorAlphaBlend(COLOR_GRASS, Fade(BLACK, 0.7f), WHITE) : COLOR_GRASS;
+        int fromV = firstV > 0 ? firstV - 1 : 0, toV = lastV < cols ? lastV : cols - 1;
+        int fromH = firstH > 0 ? firstH - 1 : 0, toH = lastH < rows ? lastH : rows - 1;
+        for (int j = firstH; j < lastH; j++) {
+            for (int k = fromV; k < toV; k++) {
+                if (!(closedSegments[j * cols + k] & CLOSED_RIGHT)) continue;
+                DrawRectangle(vRoads[k] + half, hRoads[j] - half, vRoads[k + 1] - vRoads[k] - ROAD_WIDTH, ROAD_WIDTH, grass);
+            }
+        }
+        for (int j = fromH; j < toH; j++) {
+            for (int k = firstV; k < lastV; k++) {
+                if (!(closedSegments[j * cols + k] & CLOSED_DOWN)) continue;
+                DrawRectangle(vRoads[k] - half, hRoads[j] + half, ROAD_WIDTH, hRoads[j + 1] - hRoads[j] - ROAD_WIDTH, grass);
+            }
+        }
+    }
+
+    // 4. Bâtiments (avec leur étiquette au-dessus et leur allée)
+    for(auto& b : buildings) {
+        Rectangle bounds = { b.rect.x - 15, b.rect.y - 30, b.rect.width + 30, b.rect.height + 60 };
+        if (!CheckCollisionRecs(bounds, view)) continue;
+
+        DrawLineEx(b.center, b.entryPoint, 15, DARKGRAY); // Allée de garage
+        DrawRectangleRec(b.rect, b.color);
+        DrawRectangleLinesEx(b.rect, 3, BLACK);
+        DrawText(b.label.c_str(), b.rect.x, b.rect.y - 15, 10, isNight ? WHITE : BLACK);
+
+        // Fenêtres allumées la nuit
+        if (isNight) {
+            DrawRectangle(b.rect.x + 10, b.rect.y + 10, 10, 10, YELLOW);
+            DrawRectangle(b.rect.x + 30, b.rect.y + 10, 10, 10, YELLOW);
+            DrawRectangle(b.rect.x + 10, b.rect.y + 30, 10, 10, YELLOW);
+        }
+    }
+}
+
+// Redessine le fond dans la texture si la carte ou le mode nuit ont changé.
+// Renvoie false si la carte est trop grande pour une texture.
+static bool UpdateCityCache(bool isNight) {
+    int sw = (int)worldWidth;
+    int sh = (int)worldHeight;
+    if (sw > MAX_CACHE_SIZE || sh > MAX_CACHE_SIZE) { UnloadCityCache(); return false; }
+    if (cacheLoaded && cacheVersion == worldVersion && cacheNight == isNight) return true;
+
+    // Nouvelle taille : nouvelle texture
+    if (cacheLoaded && (cityCache.texture.width != sw || cityCache.texture.height != sh)) UnloadCityCache();
+    if (!cacheLoaded) { cityCache = LoadRenderTexture(sw, sh); cacheLoaded = true; }
+
+    BeginTextureMode(cityCache);
+    ClearBackground(COLOR_GRASS);
+    DrawStaticCity(isNight, (Rectangle){ 0, 0, (float)sw, (float)sh }, DETAIL_FULL);
+    // Le filtre de nuit et le texte sont semi-transparents : on remet l'opacité de la texture
+    // à 100% sans toucher aux couleurs, sinon l'herbe de l'écran transparaîtrait en dessous.
+    rlSetBlendFactorsSeparate(RL_ZERO, RL_ONE, RL_ONE, RL_ZERO, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    DrawRectangle(0, 0, sw, sh, WHITE);
+    EndBlendMode();
+    EndTextureMode();
+
+    cacheVersion = worldVersion;
+    cacheNight = isNight;
+    return true;
+}
+
+// --- AFFICHAGE DES FEUX ---
+// Positions des ampoules, recalculées seulement quand la carte change.
+// Rangées colonne par colonne : le croisement (route verticale k, route horizontale j)
+// a ses 2 ampoules à partir de la case (k * hRoads.size() + j) * 2.
+static void UpdateBulbs() {
+    if (bulbsVersion == worldVersion) return;
+    vBulbs.clear(); hBulbs.clear();
+    // On décale les feux pour qu'ils soient au coin de la route
+    float off = ROAD_WIDTH / 2.0f + 5.0f; 
+    for(float x : vRoads) {
+        for(float y : hRoads) {
+            vBulbs.push_back({ x + off, y - off }); vBulbs.push_back({ x - off, y + off });
+            hBulbs.push_back({ x - off, y - off }); hBulbs.push_back({ x + off, y + off });
+        }
+    }
+    bulbsVersion = worldVersion;
+}
+
+// Niveau de détail selon le zoom : une voiture mesure 26 pixels à zoom 1
+DetailLevel DetailForZoom(float zoom) {
+    if (zoom >= 0.6f) return DETAIL_FULL;     // Voiture de plus de 15 pixels à l'écran
+    if (zoom >= 0.25f) return DETAIL_SIMPLE;  // Encore reconnaissable, mais sans effets
+    if (zoom >= 0.08f) return DETAIL_POINT;   // Quelques pixels : un point suffit
+    return DETAIL_DENSITY;
+}
+
+// Couleurs des feux Verticaux (Haut/Bas) et Horizontaux (Gauche/Droite) pour une phase
+static void PhaseColors(LightCycle phase, Color& vColor, Color& hColor) {
+    // Par défaut, on met tout le monde au ROUGE (sécurité)
+    vColor = RED;
+    hColor = RED;
+    if (phase == V_GREEN) vColor = GREEN;        // Vertical passe
+    else if (phase == V_YELLOW) vColor = ORANGE; // Vertical ralentit
+    else if (phase == H_GREEN) hColor = GREEN;   // Horizontal passe
+    else if (phase == H_YELLOW) hColor = ORANGE; // Horizontal ralentit
+}
+
+void DrawTrafficLights(const std::vector<LightCycle>& phases, bool isNight, Rectangle view, DetailLevel detail) {
+    UpdateBulbs();
+    if (detail == DETAIL_DENSITY) return; // De si loin, les feux ne font même plus un pixel
+
+    // Seulement les croisements visibles : colonnes [firstV, lastV) x lignes [firstH, lastH)
+    int firstV, lastV, firstH, lastH;
+    VisibleRoads(vRoadIndex, view.x, view.x + view.width, firstV, lastV);
+    VisibleRoads(hRoadIndex, view.y, view.y + view.height, firstH, lastH);
+    int rowCount = (int)hRoads.size();
+    int colCount = (int)vRoads.size();
+    bool halos = isNight && detail == DETAIL_FULL; // Halo lumineux la nuit, seulement vu de près
+
+    // Chaque carrefour a sa propre phase (numéro de nœud = ligne * colonnes + colonne).
+    // Toutes les ampoules utilisent la même texture : Raylib les envoie quand même en un seul lot.
+    for (int k = firstV; k < lastV; k++) {
+        for (int j = firstH; j < lastH; j++) {
+            int node = j * colCount + k;
+            Color vColor, hColor;
+            PhaseColors(node < (int)phases.size() ? phases[node] : V_GREEN, vColor, hColor);
+
+            int b = (k * rowCount + j) * 2;
+            DrawCircleV(vBulbs[b], 6, vColor);
+            DrawCircleV(vBulbs[b + 1], 6, vColor);
+            DrawCircleV(hBulbs[b], 6, hColor);
+            DrawCircleV(hBulbs[b + 1], 6, hColor);
+
+            if (halos) {
+                // Cercle flou et transparent autour de chaque lampe pour la faire "briller"
+                for (int e = 0; e < 2; e++) {
+                    DrawCircleGradient(vBulbs[b + e].x, vBulbs[b + e].y, 15, Fade(vColor, 0.5f), Fade(vColor, 0.0f));
+                    DrawCircleGradient(hBulbs[b + e].x, hBulbs[b + e].y, 15, Fade(hColor, 0.5f), Fade(hColor, 0.0f));
+                }
+            }
+        }
+    }
+}
+
+// --- VOITURES VISIBLES ---
+// Grille propre au dessin, reconstruite à chaque image à partir de la photo
+// (la grille de la simulation appartient au thread de simulation).
+// Cases plus petites que les pâtés de maisons pour que la carte de densité soit fine.
+static SpatialHash drawGrid(TARGET_BLOCK_SIZE / 2);
+
+// Vue de très loin : une tache par case, d'autant plus opaque qu'elle contient de voitures
+static void DrawDensity(Rectangle view) {
+    const float fullCell = 12.0f; // Nombre de voitures pour une case "pleine"
+    drawGrid.QueryCells(view, [&](Rectangle bounds, int count) {
+        if (count == 0) return;
+        float alpha = fminf(1.0f, 0.25f + 0.75f * count / fullCell);
+        DrawRectangleRec(bounds, Fade(BLUE, alpha));
+    });
+}
+
+// --- DESSIN DE LA VILLE ---
+// L'ordre de dessin est important : le sol d'abord, les voitures à la fin.
+void DrawCity(const SimSnapshot& snap, bool isNight, Rectangle view, float zoom, float alpha) {
+    DetailLevel detail = DetailForZoom(zoom);
+
+    // 1 à 4. Le fond (routes, nuit, marquages, bâtiments) : une seule copie de texture
+    // (la carte graphique ne remplit que les pixels à l'écran)
+    if (UpdateCityCache(isNight)) {
+        // Les textures de rendu sont à l'envers en OpenGL : hauteur négative pour les retourner
+        Rectangle source = { 0, 0, (float)cityCache.texture.width, -(float)cityCache.texture.height };
+        DrawTextureRec(cityCache.texture, source, (Vector2){ 0, 0 }, WHITE);
+    } else {
+        DrawStaticCity(isNight, view, detail); // Carte géante : pas de cache, seulement la partie visible
+    }
+
+    // 5. Feux tricolores (seule partie du décor qui change, par-dessus la nuit pour briller)
+    DrawTrafficLights(snap.phases, isNight, view, detail);
+
+    // 6. Événements visuels (Feu, Sang, Vol), seulement ceux qui sont à l'écran
+    Rectangle incidentView = { view.x - 60, view.y - 60, view.width + 120, view.height + 120 };
+    for (const SimSnapshot::IncidentView& inc : snap.incidents) {
+        if (!CheckCollisionPointRec(inc.pos, incidentView)) continue;
+        Vector2 p = inc.pos;
+        if (inc.type == INCIDENT_FIRE) {
+            DrawCircleV(p, 30 + sin(GetTime()*10)*10, Fade(ORANGE, 0.6f)); // Halo qui bouge
+            DrawCircleV(p, 20 + sin(GetTime()*15)*8, Fade(RED, 0.7f));    // Cœur du feu
+            DrawText("FEU", p.x - 10, p.y - 10, 20, YELLOW);
+            // Jet d'eau du camion de pompiers qui arrose
+            if (inc.state == INCIDENT_ON_SCENE && inc.unitSlot >= 0) {
+                Vector2 truck = Vector2Lerp(snap.prevPos[inc.unitSlot], snap.pos[inc.unitSlot], alpha);
+                DrawLineEx(truck, p, 4, Fade(SKYBLUE, 0.7f));
+            }
+        } else if (inc.type == INCIDENT_ACCIDENT) {
+            DrawCircle(p.x, p.y, 15, COLOR_BLOOD);
+            DrawCircle(p.x+5, p.y+5, 10, COLOR_BLOOD);
+            DrawCircle(p.x-5, p.y-4, 8, COLOR_BLOOD);
+            DrawText("ACCIDENT", p.x - 20, p.y - 30, 15, RED);
+        } else {
+            // Vol : cercle bleu qui clignote tant que la police n'est pas là
+            bool blink = inc.state != INCIDENT_ON_SCENE && (int)(GetTime()*4)%2==0;
+            DrawCircleLines(p.x, p.y, 18, blink ? RED : BLUE);
+            DrawText("VOL", p.x - 12, p.y - 32, 15, BLUE);
+        }
+    }
+
+    // 7. Voitures : seulement celles des cases visibles
+    const SimSnapshot& v = snap;
+    drawGrid.Build(v.pos.data(), v.active.data(), v.Size());
+    if (detail == DETAIL_DENSITY) {
+        DrawDensity(view);
+        // Les secours restent visibles par-dessus la densité (il y en a peu)
+        drawGrid.Query(view, [&](int i) { if (v.type[i] != CIVIL) DrawVehicle(snap, i, isNight, DETAIL_POINT, alpha); });
+        return;
+    }
+    // Les phares (150 pixels devant la voiture) dépassent de sa case : on élargit la recherche
+    float reach = (isNight && detail == DETAIL_FULL) ? 150.0f : 0.0f;
+    Rectangle area = { view.x - reach, view.y - reach, view.width + 2 * reach, view.height + 2 * reach };
+    drawGrid.Query(area, [&](int i) { DrawVehicle(snap, i, isNight, detail, alpha); });
+}
+
+// --- AFFICHAGE (DESSIN) ---
+void DrawVehicle(const SimSnapshot& snap, int i, bool isNight, DetailLevel detail, float alpha) {
+    const SimSnapshot& v = snap;
+    // Entre la position du pas précédent et celle du dernier pas (mouvement fluide à l'écran)
+    const Vector2 pos = Vector2Lerp(v.prevPos[i], v.pos[i], alpha);
+    const Dir dir = v.dir[i];
+    const Type type = v.type[i];
+    const EmergencyState emState = v.emState[i];
+
+    // Choix de la couleur
+    Color c = BLUE;
+    if (type == POLICE) c = SKYBLUE;
+    else if (type == AMBULANCE) c = WHITE;
+    else if (type == FIRE) c = RED;
+
+    // --- VUE DE LOIN ---
+    // Un carré de 26 pixels (monde) = quelques pixels à l'écran, sans contour ni effets
+    if (detail == DETAIL_POINT || detail == DETAIL_DENSITY) {
+        float size = (type == CIVIL) ? 26.0f : 40.0f; // Les secours restent bien visibles
+        DrawRectangleV((Vector2){ pos.x - size / 2, pos.y - size / 2 }, (Vector2){ size, size }, c);
+        return;
+    }
+
+    Rectangle r = GetCarRect(pos, dir);
+    if (detail == DETAIL_SIMPLE) {
+        DrawRectangleRec(r, c); // Carrosserie seule
+        return;
+    }
+    
+    // --- PHARES (HEADLIGHTS) SI NUIT ---
+    if (isNight && v.active[i]) {
+        Color lightColor = Fade(YELLOW, 0.3f);
+        if (type == POLICE) lightColor = Fade(BLUE, 0.4f); // Phares bleutés pour la police
+        
+        float beamL = 150.0f; // Longueur du faisceau
+        float beamW = 40.0f;  // Largeur du faisceau
+        Vector2 p1, p2, p3;
+        
+        // Calcul du triangle de lumière selon la direction
+        if(dir == UP) {
+            p1 = {pos.x, pos.y - 15};
+            p2 = {pos.x - beamW, pos.y - beamL};
+            p3 = {pos.x + beamW, pos.y - beamL};
+        } else if(dir == DOWN) {
+            p1 = {pos.x, pos.y + 15};
+            p2 = {pos.x - beamW, pos.y + beamL};
+            p3 = {pos.x + beamW, pos.y + beamL};
+        } else if(dir == LEFT) {
+            p1 = {pos.x - 15, pos.y};
+            p2 = {pos.x - beamL, pos.y - beamW};
+            p3 = {pos.x - beamL, pos.y + beamW};
+        } else {
+            p1 = {pos.x + 15, pos.y};
+            p2 = {pos.x + beamL, pos.y - beamW};
+            p3 = {pos.x + beamL, pos.y + beamW};
+        }
+        DrawTriangle(p1, p2, p3, lightColor);
+    }
+    // -----------------------------------
+
+    // Si on se range sur le côté, on dessine un cadre orange autour
+    if (v.isYielding[i]) DrawRectangleLinesEx({r.x-2, r.y-2, r.width+4, r.height+4}, 1, ORANGE);
+
+    // Dessin de l'ombre portée (pour effet 3D)
+    DrawRectangle(r.x+3, r.y+3, r.width, r.height, Fade(BLACK, 0.3f)); 
+    // Dessin de la carrosserie
+    DrawRectangleRec(r, c);
+    DrawRectangleLinesEx(r, 1, BLACK); // Contour noir
+
+    // --- FEUX DE FREINAGE (STOP) ---
+    // Si on ralentit, on allume les feux rouges arrière
+    if (v.isBraking[i]) { 
+        if(dir==UP) DrawRectangle(r.x, r.y+r.height, r.width, 2, RED);
+        if(dir==DOWN) DrawRectangle(r.x, r.y-2, r.width, 2, RED);
+        if(dir==LEFT) DrawRectangle(r.x+r.width, r.y, 2, r.height, RED);
+        if(dir==RIGHT) DrawRectangle(r.x-2, r.y, 2, r.height, RED);
+    }
+
+    // --- GYROPHARES ET SIRÈNES (SECOURS) ---
+    if(type != CIVIL && (int)(GetTime()*15)%2==0 && emState != DOCKING) {
+        // Clignotement orange sur le toit
+        DrawCircleV(pos, 4, ORANGE);
+        // Onde de choc visuelle (cercle rouge qui s'agrandit)
+        DrawCircleLines(pos.x, pos.y, 20 + sin(GetTime()*10)*5, Fade(RED, 0.5f));
+    }
+
+    // --- ANIMATIONS SPÉCIALES ---
+    // (Le jet d'eau des pompiers est dessiné avec l'incendie, dans DrawCity)
+    // Croix verte clignotante pour l'ambulance qui soigne
+    if (type == AMBULANCE && emState == TREATING) {
+            if((int)(GetTime()*10)%2==0) {
+                DrawLine(pos.x-5, pos.y, pos.x+5, pos.y, GREEN);
+                DrawLine(pos.x, pos.y-5, pos.x, pos.y+5, GREEN);
+            }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+/**
+ * RELECTURE (REPLAY)
+ * Rejoue une trace binaire dans la fenêtre : la ville est reconstruite à l'identique,
+ * puis chaque image affiche l'état du pas lu dans le fichier (voir replay_view.h).
+ */
+
+#include "../include/replay_view.h"
+#include "../include/config.h"
+#include "../include/world.h"
+#include "../include/trace.h"
+#include "../include/render.h"
+#include "../include/engine.h"
+#include "../include/scenario.h"
+#include <math.h>
+#include <stdio.h>
+
+int RunReplay(const char* path, const char* scenarioPath) {
+    TraceReader reader;
+    if (!reader.Open(path)) {
+        printf("Trace %s illisible : %s\n", path, reader.Error().c_str());
+        return 1;
+    }
+
+    // Même taille de monde = même ville (routes, bâtiments) que pendant l'enregistrement,
+    // sauf partie jouée sur un scénario : on recharge sa carte
+    if (scenarioPath) {
+        ScenarioDemand demand;
+        std::string error;
+        if (!LoadScenario(scenarioPath, demand, error)) {
+            printf("Scenario %s illisible : %s\n", scenarioPath, error.c_str());
+            return 1;
+        }
+    } else {
+        RecalculateGrid(reader.WorldWidth(), reader.WorldHeight());
+    }
+    ResetCityCamera();
+
+    const long long first = reader.FirstTick();
+    const long long last = reader.LastTick();
+    const int speeds[] = { 1, 10, 100, 1000 };
+
+    SimSnapshot snap;
+    double position = (double)first; // Pas affiché (avec sa fraction, pour les petites vitesses)
+    int speed = 1;
+    bool playing = true;
+    bool broken = !reader.Seek(first, snap);
+    // Lecture/pause ; à la fin de la partie, la lecture repart du début
+    auto TogglePlay = [&]() {
+        if (!playing && position >= (double)last) position = (double)first;
+        playing = !playing;
+    };
+
+    while (!WindowShouldClose()) {
+        // --- A. COMMANDES ---
+        if (IsKeyPressed(KEY_SPACE)) TogglePlay();
+        if (IsKeyPressed(KEY_N)) isNight = !isNight;
+        if (IsKeyPressed(KEY_ONE)) speed = speeds[0];
+        if (IsKeyPressed(KEY_TWO)) speed = speeds[1];
+        if (IsKeyPressed(KEY_THREE)) speed = speeds[2];
+        if (IsKeyPressed(KEY_FOUR)) speed = speeds[3];
+        double tenSeconds = 10.0 / SIM_DT;
+        if (IsKeyPressed(KEY_PAGE_UP)) position += tenSeconds;
+        if (IsKeyPressed(KEY_PAGE_DOWN)) position -= tenSeconds;
+        if (IsKeyPressed(KEY_HOME)) position = (double)first;
+        if (IsKeyPressed(KEY_END)) position = (double)last;
+        UpdateCityCamera();
+
+        int sh = GetScreenHeight();
+
+        // Barre de temps : cliquer (ou glisser) dessus saute à ce moment de la partie
+        Rectangle timeline = { 20, 130, 210, 16 };
+        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(GetMousePosition(), timeline)) {
+            float t = (GetMousePosition().x - timeline.x) / timeline.width;
+            position = first + t * (double)(last - first);
+        }
+
+        // --- B. AVANCE DE LA LECTURE ---
+        if (playing && !broken) position += GetFrameTime() / SIM_DT * speed;
+        if (position >= (double)last) { position = (double)last; playing = false; } // Fin de la partie
+        if (position < (double)first) position = (double)first;
+        if (!broken && (long long)position != snap.tick) broken = !reader.Seek((long long)position, snap);
+        snap.isNight = isNight;
+
+        // --- C. DESSIN ---
+        BeginDrawing();
+        ClearBackground(COLOR_GRASS);
+
+        BeginMode2D(cityCamera);
+        DrawCity(snap, isNight, GetCameraView(), cityCamera.zoom, 1.0f);
+        EndMode2D();
+
+        DrawRectangle(0, 0, SIDEBAR_WIDTH, sh, COLOR_SIDEBAR);
+        DrawRectangle(SIDEBAR_WIDTH, 0, 4, sh, BLACK);
+        DrawText("REPLAY", 20, 20, 30, WHITE);
+        DrawText(TextFormat("Graine %llu", (unsigned long long)reader.Seed()), 20, 55, 10, GRAY);
+
+        if (DrawButton((Rectangle){ 20, 75, 200, 40 }, playing ? DARKGRAY : DARKGREEN, WHITE,
+                       playing ? "PAUSE [ESPACE]" : "LECTURE [ESPACE]")) {
+            TogglePlay();
+        }
+
+        // Barre de temps : partie lue, puis une marque par minute de la ville
+        float done = (last > first) ? (float)((position - first) / (double)(last - first)) : 1.0f;
+        DrawRectangleRec(timeline, BLACK);
+        DrawRectangle(timeline.x, timeline.y, (int)(timeline.width * done), timeline.height, SKYBLUE);
+        const long long minute = lround(60.0 / SIM_DT);
+        for (long long k = first + minute; k < last && (last - first) / minute < 200; k += minute) {
+            float x = timeline.x + timeline.width * (float)(k - first) / (float)(last - first);
+            DrawLine((int)x, timeline.y + timeline.height - 4, (int)x, timeline.y + timeline.height, GRAY);
+        }
+        DrawRectangleLinesEx(timeline, 1, RAYWHITE);
+        long long cityTime = (long long)(snap.tick * SIM_DT);
+        long long endTime = (long long)(last * SIM_DT);
+        DrawText(TextFormat("%02lld:%02lld:%02lld / %02lld:%02lld:%02lld", cityTime / 3600, cityTime / 60 % 60,
+                            cityTime % 60, endTime / 3600, endTime / 60 % 60, endTime % 60), 20, 150, 16, GRAY);
+        DrawText(TextFormat("pas %lld", snap.tick), 20, 170, 10, GRAY);
+        DrawText("[PAGE HAUT/BAS] 10 s  [DEBUT/FIN]", 20, 185, 10, GRAY);
+
+        DrawMiniMap(snap);
+        if (broken) DrawText(TextFormat("TRACE ABIMEE: %s", reader.Error().c_str()), 20, sh - 270, 16, RED);
+
+        DrawText(TextFormat("Voitures: %d  Incidents: %d", snap.Size(), (int)snap.incidents.size()), 20, sh - 40, 20,
+                 snap.waitingIncidents > 0 ? ORANGE : GRAY);
+        DrawText("MODE NUIT: [N]", 20, sh - 80, 20, isNight ? YELLOW : GRAY);
+        DrawText(TextFormat("ZOOM: x%.2f  [R]", cityCamera.zoom), 20, sh - 120, 20, GRAY);
+        DrawText(TextFormat("VITESSE: x%d [1-4]", speed), 20, sh - 160, 20, speed > 1 ? ORANGE : GRAY);
+        const char* signalNames[] = { "FIXES", "ADAPTATIFS", "ONDE VERTE" };
+        DrawText(TextFormat("FEUX: %s", signalNames[snap.signalMode % 3]), 20, sh - 200, 16, GRAY);
+
+        EndDrawing();
+    }
+    return 0;
+}
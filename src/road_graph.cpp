@@ -0,0 +1,197 @@
+/**
+ * GRAPHE ROUTIER ET ITINÉRAIRES (A*)
+ * Les véhicules de secours ne tournent plus "au jugé" : ils suivent
+ * un itinéraire calculé carrefour par carrefour sur le graphe des routes.
+ */
+
+#include "../include/road_graph.h"
+#include "../include/world.h"
+#include <algorithm>
+
+RoadGraph roadGraph;
+
+RoadGraph::RoadGraph() : cols(0), rows(0) {
+    edgeStart.push_back(0);
+}
+
+void RoadGraph::Build(const std::vector<float>& xs, const std::vector<float>& ys, const std::vector<uint8_t>& closed) {
+    cols = (int)xs.size();
+    rows = (int)ys.size();
+    nodePos.clear();
+    edgeStart.clear();
+    edgeTo.clear();
+    edgeLength.clear();
+    exits.assign(NodeCount(), (uint8_t)((1 << UP) | (1 << DOWN) | (1 << LEFT) | (1 << RIGHT)));
+
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++) nodePos.push_back({ xs[c], ys[r] });
+
+    // Tronçons fermés : on retire la sortie des deux carrefours qu'ils relient
+    if ((int)closed.size() == NodeCount()) {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                uint8_t bits = closed[NodeAt(c, r)];
+                if ((bits & CLOSED_DOWN) && r < rows - 1) {
+                    exits[NodeAt(c, r)] &= ~(1 << DOWN);
+                    exits[NodeAt(c, r + 1)] &= ~(1 << UP);
+                }
+                if ((bits & CLOSED_RIGHT) && c < cols - 1) {
+                    exits[NodeAt(c, r)] &= ~(1 << RIGHT);
+                    exits[NodeAt(c + 1, r)] &= ~(1 << LEFT);
+                }
+            }
+        }
+    }
+
+    // Chaque carrefour est relié à ses (au plus) 4 voisins sur la grille, sauf par un tronçon fermé
+    edgeTo.reserve((size_t)NodeCount() * 4);
+    edgeLength.reserve((size_t)NodeCount() * 4);
+    edgeStart.push_back(0);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            uint8_t open = exits[NodeAt(c, r)];
+            if (r > 0 && (open >> UP & 1))           { edgeTo.push_back(NodeAt(c, r - 1)); edgeLength.push_back(ys[r] - ys[r - 1]); }
+            if (r < rows - 1 && (open >> DOWN & 1))  { edgeTo.push_back(NodeAt(c, r + 1)); edgeLength.push_back(ys[r + 1] - ys[r]); }
+            if (c > 0 && (open >> LEFT & 1))         { edgeTo.push_back(NodeAt(c - 1, r)); edgeLength.push_back(xs[c] - xs[c - 1]); }
+            if (c < cols - 1 && (open >> RIGHT & 1)) { edgeTo.push_back(NodeAt(c + 1, r)); edgeLength.push_back(xs[c + 1] - xs[c]); }
+            edgeStart.push_back((int)edgeTo.size());
+        }
+    }
+}
+
+int RoadGraph::NearestNode(Vector2 p) const {
+    if (NodeCount() == 0) return -1;
+    return NodeAt(vRoadIndex.Nearest(p.x), hRoadIndex.Nearest(p.y));
+}
+
+int RoadGraph::NextNodeAhead(Vector2 p, Dir d, float radius, bool leaving) const {
+    if (NodeCount() == 0) return -1;
+    if (leaving) {
+        // On se place juste après le carrefour actuel pour trouver le suivant
+        if (d == UP) p.y -= radius;
+        if (d == DOWN) p.y += radius;
+        if (d == LEFT) p.x -= radius;
+        if (d == RIGHT) p.x += radius;
+    }
+    int col = vRoadIndex.Nearest(p.x);
+    int row = hRoadIndex.Nearest(p.y);
+    Vector2 here = nodePos[NodeAt(col, row)];
+    if (fabs(p.x - here.x) < radius && fabs(p.y - here.y) < radius) return NodeAt(col, row);
+
+    // Segment() = nombre de routes avant la position : la suivante dans le sens de la marche
+    if (d == DOWN)  row = std::min(hRoadIndex.Segment(p.y), rows - 1);
+    if (d == UP)    row = std::max(hRoadIndex.Segment(p.y) - 1, 0);
+    if (d == RIGHT) col = std::min(vRoadIndex.Segment(p.x), cols - 1);
+    if (d == LEFT)  col = std::max(vRoadIndex.Segment(p.x) - 1, 0);
+    return NodeAt(col, row);
+}
+
+Dir RoadGraph::DirectionTo(int from, int to) const {
+    int dc = NodeCol(to) - NodeCol(from);
+    int dr = NodeRow(to) - NodeRow(from);
+    if (dc > 0) return RIGHT;
+    if (dc < 0) return LEFT;
+    if (dr > 0) return DOWN;
+    if (dr < 0) return UP;
+    return NONE;
+}
+
+int RoadGraph::FindEdge(int from, int to) const {
+    for (int k = EdgeBegin(from); k < EdgeEnd(from); k++) if (edgeTo[k] == to) return k;
+    return -1;
+}
+
+int RoadGraph::EdgeAt(Vector2 p, Dir d) const {
+    if (NodeCount() == 0) return -1;
+    if (d == UP || d == DOWN) {
+        // Entre la ligne k-1 et la ligne k (k = nombre de routes horizontales au-dessus)
+        int k = hRoadIndex.Segment(p.y);
+        if (k <= 0 || k >= rows) return -1;
+        int col = vRoadIndex.Nearest(p.x);
+        int above = NodeAt(col, k - 1), below = NodeAt(col, k);
+        return (d == DOWN) ? FindEdge(above, below) : FindEdge(below, above);
+    }
+    if (d == LEFT || d == RIGHT) {
+        int k = vRoadIndex.Segment(p.x);
+        if (k <= 0 || k >= cols) return -1;
+        int row = hRoadIndex.Nearest(p.y);
+        int left = NodeAt(k - 1, row), right = NodeAt(k, row);
+        return (d == RIGHT) ? FindEdge(left, right) : FindEdge(right, left);
+    }
+    return -1;
+}
+
+// --- A* ---
+RoutePlanner::RoutePlanner() : stamp(0), expanded(0) {}
+
+void RoutePlanner::Prepare(const RoadGraph& graph) {
+    int n = graph.NodeCount();
+    if ((int)gScore.size() == n) return;
+    gScore.assign(n, 0.0f);
+    cameFrom.assign(n, -1);
+    seenStamp.assign(n, 0);
+    closedStamp.assign(n, 0);
+    // Un nœud peut entrer dans la liste ouverte une fois par arête entrante au maximum
+    open.clear();
+    open.reserve(graph.edgeTo.size() + 1);
+    stamp = 0;
+}
+
+bool RoutePlanner::FindRoute(const RoadGraph& graph, int from, int to, std::vector<int>& route,
+                             const std::vector<float>* edgeCost, float costPerPixel) {
+    route.clear();
+    expanded = 0;
+    int n = graph.NodeCount();
+    if (from < 0 || to < 0 || from >= n || to >= n) return false;
+
+    Prepare(graph);
+    stamp++;
+    if (stamp == 0) { // Le compteur a fait le tour : on efface vraiment (très rare)
+        std::fill(seenStamp.begin(), seenStamp.end(), 0);
+        std::fill(closedStamp.begin(), closedStamp.end(), 0);
+        stamp = 1;
+    }
+
+    // Estimation du reste : distance "en ville" (on ne roule qu'à l'horizontale ou à la verticale)
+    Vector2 goal = graph.NodePos(to);
+    auto heuristic = [&](int node) {
+        Vector2 p = graph.NodePos(node);
+        return (float)(fabs(goal.x - p.x) + fabs(goal.y - p.y)) * costPerPixel;
+    };
+
+    open.clear();
+    gScore[from] = 0;
+    cameFrom[from] = -1;
+    seenStamp[from] = stamp;
+    open.push_back({ heuristic(from), from });
+
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end());
+        int node = open.back().node;
+        open.pop_back();
+        if (closedStamp[node] == stamp) continue; // Ancienne entrée déjà dépassée
+        closedStamp[node] = stamp;
+        expanded++;
+        if (node == to) { found = true; break; }
+
+        for (int k = graph.EdgeBegin(node); k < graph.EdgeEnd(node); k++) {
+            int next = graph.edgeTo[k];
+            if (closedStamp[next] == stamp) continue;
+            float g = gScore[node] + (edgeCost ? (*edgeCost)[k] : graph.edgeLength[k]);
+            if (seenStamp[next] != stamp || g < gScore[next]) {
+                seenStamp[next] = stamp;
+                gScore[next] = g;
+                cameFrom[next] = node;
+                open.push_back({ g + heuristic(next), next });
+                std::push_heap(open.begin(), open.end());
+            }
+        }
+    }
+    if (!found) return false;
+
+    // On remonte les parents depuis l'arrivée, puis on remet dans l'ordre
+    for (int node = to; node != -1; node = cameFrom[node]) route.push_back(node);
+    std::reverse(route.begin(), route.end());
+    return true;
+}
@@ -0,0 +1,278 @@
+/**
+ * SCÉNARIOS
+ * Lecture d'une carte de quartier (routes, impasses, limites de vitesse, bâtiments
+ * de secours, demande de trafic) dans un fichier texte projeté en mémoire
+ * (voir scenario.h pour le format).
+ */
+
+#include "../include/scenario.h"
+#include "../include/world.h"
+#include "../include/mapped_file.h"
+#include "../include/simulation.h"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+// --- LECTURE LIGNE PAR LIGNE ---
+// Curseur sur les octets du fichier : un mot est un morceau du fichier lui-même
+// (début + longueur), jamais recopié dans une chaîne.
+class ScenarioLines {
+public:
+    ScenarioLines(const char* data, size_t size) : next(data), end(data + size), cur(data), lineEnd(data), line(0) {}
+
+    // Passe à la prochaine ligne qui contient une commande (false à la fin du fichier)
+    bool Next() {
+        while (next < end) {
+            const char* start = next;
+            const char* newline = (const char*)memchr(next, '\n', end - next);
+            lineEnd = newline ? newline : end;
+            next = newline ? newline + 1 : end;
+            line++;
+            const char* comment = (const char*)memchr(start, '#', lineEnd - start);
+            if (comment) lineEnd = comment; // Le commentaire s'arrête à la fin de la ligne
+            cur = start;
+            SkipSpaces();
+            if (cur < lineEnd) return true;
+        }
+        return false;
+    }
+
+    // Mot suivant de la ligne (false s'il n'y en a plus)
+    bool Word(const char*& w, size_t& n) {
+        SkipSpaces();
+        if (cur >= lineEnd) return false;
+        w = cur;
+        while (cur < lineEnd && !IsSpace(*cur)) cur++;
+        n = (size_t)(cur - w);
+        return true;
+    }
+    static bool Is(const char* w, size_t n, const char* keyword) {
+        return strlen(keyword) == n && memcmp(w, keyword, n) == 0;
+    }
+
+    bool Float(float& v) {
+        char buf[32];
+        if (!Token(buf)) return false;
+        char* stop;
+        v = strtof(buf, &stop);
+        return *stop == 0 && std::isfinite(v);
+    }
+    bool Int(int& v) {
+        char buf[32];
+        if (!Token(buf)) return false;
+        char* stop;
+        long value = strtol(buf, &stop, 10);
+        if (*stop != 0 || value < INT_MIN || value > INT_MAX) return false;
+        v = (int)value;
+        return true;
+    }
+
+    // Reste de la ligne, sans les espaces autour (ex : le nom d'un bâtiment)
+    void Rest(const char*& w, size_t& n) {
+        SkipSpaces();
+        const char* last = lineEnd;
+        while (last > cur && IsSpace(last[-1])) last--;
+        w = cur;
+        n = (size_t)(last - cur);
+        cur = lineEnd;
+    }
+
+    bool HasMore() { SkipSpaces(); return cur < lineEnd; }
+    int Line() const { return line; }
+
+private:
+    const char* next;    // Début de la ligne suivante
+    const char* end;     // Fin du fichier
+    const char* cur;     // Position dans la ligne en cours
+    const char* lineEnd; // Fin de la ligne en cours (ou début de son commentaire)
+    int line;            // Numéro de la ligne en cours (à partir de 1)
+
+    static bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+    void SkipSpaces() { while (cur < lineEnd && IsSpace(*cur)) cur++; }
+    // Mot suivant, terminé par un zéro pour strtof / strtol (les nombres sont courts)
+    bool Token(char (&buf)[32]) {
+        const char* w = nullptr;
+        size_t n = 0;
+        if (!Word(w, n) || n >= sizeof(buf)) return false;
+        memcpy(buf, w, n);
+        buf[n] = 0;
+        return true;
+    }
+};
+
+// --- CONTENU DU FICHIER ---
+struct StationSpec {
+    Type type;
+    Vector2 center;
+    char label[32];
+};
+
+struct ScenarioData {
+    float width = 0, height = 0;
+    int vCount = 0, hCount = 0, stationCount = 0; // Comptés au premier passage
+    std::vector<float> v, h, vLimits, hLimits;
+    std::vector<uint8_t> closed;                  // Comme closedSegments
+    std::vector<StationSpec> stations;
+    ScenarioDemand demand;
+};
+
+// Un passage sur tout le fichier. Premier passage (fill = false) : vérifie chaque ligne et
+// compte les routes et les bâtiments. Second passage : remplit les tableaux de "d", déjà
+// réservés à la bonne taille, et vérifie ce qui dépend des totaux (numéros de tronçons).
+static bool ParsePass(const MappedFile& file, bool fill, ScenarioData& d, std::string& error) {
+    ScenarioLines in((const char*)file.Data(), file.Size());
+    auto Fail = [&](const char* why) {
+        error = "ligne " + std::to_string(in.Line()) + " : " + why;
+        return false;
+    };
+
+    bool versionSeen = false;
+    float lastV = 0, lastH = 0; // Dernière route lue (les positions doivent croître)
+    int vSeen = 0, hSeen = 0, stationsSeen = 0;
+    while (in.Next()) {
+        const char* w = nullptr;
+        size_t n = 0;
+        if (!in.Word(w, n)) return Fail("mot-cle attendu"); // Next() s'arrête sur une ligne non vide
+        if (!versionSeen) {
+            int version = 0;
+            if (!ScenarioLines::Is(w, n, "scenario") || !in.Int(version)) return Fail("\"scenario 1\" attendu en premier");
+            if (version != SCENARIO_VERSION) return Fail("version de scenario inconnue");
+            versionSeen = true;
+        }
+        else if (ScenarioLines::Is(w, n, "world")) {
+            if (!in.Float(d.width) || !in.Float(d.height) || d.width <= 0 || d.height <= 0) return Fail("world LARGEUR HAUTEUR attendu");
+        }
+        else if (ScenarioLines::Is(w, n, "vroad") || ScenarioLines::Is(w, n, "hroad")) {
+            bool vertical = (w[0] == 'v');
+            float pos = 0, limit = 0;
+            if (!in.Float(pos)) return Fail("position de la route attendue");
+            if (in.HasMore() && (!in.Float(limit) || limit <= 0)) return Fail("limite de vitesse invalide");
+            float& last = vertical ? lastV : lastH;
+            if (pos <= last) return Fail("routes dans le desordre (positions croissantes, au-dela de 0)");
+            last = pos;
+            if (vertical) {
+                if (fill) { d.v.push_back(SIDEBAR_WIDTH + pos); d.vLimits.push_back(limit); }
+                vSeen++;
+            } else {
+                if (fill) { d.h.push_back(pos); d.hLimits.push_back(limit); }
+                hSeen++;
+            }
+        }
+        else if (ScenarioLines::Is(w, n, "closed")) {
+            const char* axis = nullptr;
+            size_t axisLength = 0;
+            int road = 0, segment = 0;
+            if (!in.Word(axis, axisLength) || !(ScenarioLines::Is(axis, axisLength, "v") || ScenarioLines::Is(axis, axisLength, "h")) ||
+                !in.Int(road) || !in.Int(segment)) {
+                return Fail("closed v|h ROUTE TRONCON attendu");
+            }
+            if (fill) {
+                bool vertical = (axis[0] == 'v');
+                int roads = vertical ? d.vCount : d.hCount;  // Routes de ce sens
+                int across = vertical ? d.hCount : d.vCount; // Routes qui les croisent
+                if (road < 0 || road >= roads || segment < 0 || segment + 1 >= across) return Fail("troncon hors de la carte");
+                if (vertical) d.closed[(size_t)segment * d.vCount + road] |= CLOSED_DOWN;
+                else d.closed[(size_t)road * d.vCount + segment] |= CLOSED_RIGHT;
+            }
+        }
+        else if (ScenarioLines::Is(w, n, "station")) {
+            const char* kind = nullptr;
+            size_t kindLength = 0;
+            StationSpec s;
+            if (!in.Word(kind, kindLength)) return Fail("station fire|ambulance|police X Y [NOM] attendu");
+            const char* defaultLabel;
+            if (ScenarioLines::Is(kind, kindLength, "fire")) { s.type = FIRE; defaultLabel = "CASERNE"; }
+            else if (ScenarioLines::Is(kind, kindLength, "ambulance")) { s.type = AMBULANCE; defaultLabel = "HOPITAL"; }
+            else if (ScenarioLines::Is(kind, kindLength, "police")) { s.type = POLICE; defaultLabel = "POLICE"; }
+            else return Fail("type de station inconnu (fire, ambulance ou police)");
+            if (!in.Float(s.center.x) || !in.Float(s.center.y)) return Fail("position de la station attendue");
+            const char* label;
+            size_t labelLength;
+            in.Rest(label, labelLength);
+            if (labelLength >= sizeof(s.label)) return Fail("nom de station trop long (31 lettres au plus)");
+            if (labelLength == 0) { label = defaultLabel; labelLength = strlen(defaultLabel); }
+            if (fill) {
+                if (s.center.x < 0 || s.center.x > d.width || s.center.y < 0 || s.center.y > d.height) return Fail("station hors de la ville");
+                s.center.x += SIDEBAR_WIDTH;
+                memcpy(s.label, label, labelLength);
+                s.label[labelLength] = 0;
+                d.stations.push_back(s);
+            }
+            stationsSeen++;
+        }
+        else if (ScenarioLines::Is(w, n, "demand")) {
+            const char* key = nullptr;
+            size_t keyLength = 0;
+            float value = 0;
+            if (!in.Word(key, keyLength) || !in.Float(value) || value < 0) return Fail("demand NOM VALEUR (positive) attendu");
+            ScenarioDemand& demand = d.demand;
+            if (ScenarioLines::Is(key, keyLength, "civilians")) demand.civilians = (int)value;
+            else if (ScenarioLines::Is(key, keyLength, "max-civilians")) demand.maxCivilians = (int)value;
+            else if (ScenarioLines::Is(key, keyLength, "spawn-rate")) demand.spawnRate = value;
+            else if (ScenarioLines::Is(key, keyLength, "interior")) {
+                if (value > 1) return Fail("demand interior : part entre 0 et 1");
+                demand.interiorSpawn = value;
+            }
+            else if (ScenarioLines::Is(key, keyLength, "incidents")) demand.incidentRate = value;
+            else return Fail("demande inconnue (civilians, max-civilians, spawn-rate, interior, incidents)");
+        }
+        else return Fail("commande inconnue");
+
+        if (in.HasMore()) return Fail("trop de valeurs sur la ligne");
+    }
+
+    if (!versionSeen) { error = "fichier vide (\"scenario 1\" attendu)"; return false; }
+    if (d.width <= 0) { error = "commande world manquante"; return false; }
+    if (vSeen < 2 || hSeen < 2) { error = "il faut au moins 2 routes de chaque sens"; return false; }
+    if (lastV >= d.width || lastH >= d.height) { error = "route hors de la ville"; return false; }
+    d.vCount = vSeen;
+    d.hCount = hSeen;
+    d.stationCount = stationsSeen;
+    return true;
+}
+
+bool LoadScenario(const char* path, ScenarioDemand& demand, std::string& error) {
+    MappedFile file;
+    if (!file.Open(path)) { error = file.Error(); return false; }
+
+    // 1. Vérification et comptage, puis chaque tableau est réservé une seule fois
+    ScenarioData d;
+    if (!ParsePass(file, false, d, error)) return false;
+    d.v.reserve(d.vCount);
+    d.vLimits.reserve(d.vCount);
+    d.h.reserve(d.hCount);
+    d.hLimits.reserve(d.hCount);
+    d.closed.assign((size_t)d.vCount * d.hCount, 0);
+    d.stations.reserve(d.stationCount);
+
+    // 2. Remplissage
+    if (!ParsePass(file, true, d, error)) return false;
+
+    // 3. La ville change d'un coup (comme RecalculateGrid)
+    worldWidth = SIDEBAR_WIDTH + d.width;
+    worldHeight = d.height;
+    vRoads.swap(d.v);
+    hRoads.swap(d.h);
+    vRoadLimits.swap(d.vLimits);
+    hRoadLimits.swap(d.hLimits);
+    bool anyClosed = false;
+    for (uint8_t bits : d.closed) if (bits) { anyClosed = true; break; }
+    if (anyClosed) closedSegments.swap(d.closed);
+    else closedSegments.clear(); // Tout est ouvert : comme une ville procédurale
+    RebuildRoadNetwork();
+
+    // Les sorties des bâtiments se calculent avec les index des nouvelles routes
+    buildings.clear();
+    buildings.reserve(d.stations.size());
+    for (const StationSpec& s : d.stations) buildings.push_back(MakeStation(s.type, s.center, s.label));
+    BuildFireSites();
+
+    demand = d.demand;
+    return true;
+}
+
+void ApplyScenarioDemand(const ScenarioDemand& demand, Simulation& sim) {
+    if (demand.spawnRate >= 0) sim.spawnRate = demand.spawnRate;
+    if (demand.interiorSpawn >= 0) sim.interiorSpawnShare = demand.interiorSpawn;
+    if (demand.incidentRate >= 0) sim.incidentRate = demand.incidentRate;
+}
@@ -0,0 +1,157 @@
+/**
+ * THREAD DE SIMULATION
+ * Fait avancer la ville par pas de temps fixes sur son propre thread (en temps réel,
+ * en accéléré ou au maximum) et publie une photo de l'état pour le thread d'affichage.
+ * Un dessin lent (nuit, beaucoup de phares) ne ralentit plus la simulation.
+ */
+
+#include "../include/sim_thread.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+void SimSnapshot::CaptureFrom(const Simulation& s, bool night) {
+    tick = s.tick;
+    isNight = night;
+    signalMode = s.signals.Mode();
+    s.signals.FillPhases(phases);
+    averageDelay = s.signals.AverageDelay();
+    incidents.clear();
+    for (int k = 0; k < s.incidents.SlotCount(); k++) {
+        if (!s.incidents.IsOpen(k)) continue;
+        const Incident& inc = s.incidents.At(k);
+        incidents.push_back({ inc.type, inc.state, inc.priority, inc.pos, s.vehicles.SlotOf(inc.unit) });
+    }
+    waitingIncidents = s.dispatcher.QueueLength();
+    s.profiler.FillSummary(profile);
+
+    const VehicleStore& v = s.vehicles;
+    int n = v.Size();
+    pos.assign(v.pos.begin(), v.pos.begin() + n);
+    prevPos.assign(v.prevPos.begin(), v.prevPos.begin() + n);
+    dir.assign(v.dir.begin(), v.dir.begin() + n);
+    type.assign(v.type.begin(), v.type.begin() + n);
+    emState.assign(v.emState.begin(), v.emState.begin() + n);
+    active.assign(v.active.begin(), v.active.begin() + n);
+    isYielding.assign(v.isYielding.begin(), v.isYielding.begin() + n);
+    isBraking.resize(n);
+    for (int i = 0; i < n; i++) isBraking[i] = (v.speed[i] < v.maxSpeed[i] * 0.8f) ? 1 : 0;
+}
+
+SimThread::SimThread(Simulation& s) : sim(s), night(false), speed(1), ticksPerSecond(0), running(false) {}
+
+double SimThread::Now() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+float SimThread::InterpolationAlpha(const SimSnapshot& snap) {
+    if (snap.tickPeriod <= 0) return 1.0f;
+    double alpha = (Now() - snap.publishedAt) / snap.tickPeriod;
+    return (float)std::min(1.0, std::max(0.0, alpha));
+}
+
+SimThread::~SimThread() {
+    Stop();
+}
+
+void SimThread::Start() {
+    if (running) return;
+    // Les trois exemplaires ont la place de toutes les voitures : aucune allocation en jeu
+    int capacity = sim.vehicles.Capacity();
+    for (int k = 0; k < 3; k++) {
+        SimSnapshot& s = snapshots.Slot(k);
+        s.pos.reserve(capacity); s.prevPos.reserve(capacity); s.dir.reserve(capacity); s.type.reserve(capacity);
+        s.emState.reserve(capacity); s.active.reserve(capacity);
+        s.isYielding.reserve(capacity); s.isBraking.reserve(capacity);
+        s.phases.reserve(roadGraph.NodeCount());
+        s.incidents.reserve(MAX_OPEN_INCIDENTS);
+    }
+    // Première photo avant le premier pas : l'affichage a toujours quelque chose à dessiner
+    Publish();
+
+    running = true;
+    worker = std::thread(&SimThread::Loop, this);
+}
+
+void SimThread::Stop() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+const SimSnapshot& SimThread::Latest() {
+    snapshots.Consume();
+    return snapshots.ReadBuffer();
+}
+
+void SimThread::ApplyCommands() {
+    SimCommand command;
+    while (commands.Pop(command)) {
+        if (command.type == CMD_SPAWN) sim.Spawn(command.vehicle);
+        else if (command.type == CMD_TOGGLE_NIGHT) night = !night;
+        else if (command.type == CMD_SET_SPEED) speed = std::max(command.value, SPEED_MAX);
+        else if (command.type == CMD_SET_SIGNAL_MODE) sim.signals.SetMode((SignalMode)command.value);
+        else if (command.type == CMD_SAVE_STATE) {
+            std::string error;
+            if (sim.SaveState(QUICK_SAVE_PATH, error)) printf("Sauvegarde: %s (pas %lld)\n", QUICK_SAVE_PATH, sim.tick);
+            else printf("Impossible d'ecrire %s : %s\n", QUICK_SAVE_PATH, error.c_str());
+        }
+    }
+}
+
+void SimThread::Publish() {
+    ProfileScope scope(sim.profiler, PHASE_PUBLISH); // Compté avec le pas suivant
+    SimSnapshot& snap = snapshots.WriteBuffer();
+    snap.CaptureFrom(sim, night);
+    snap.speed = speed;
+    snap.ticksPerSecond = ticksPerSecond;
+    snap.publishedAt = Now();
+    snap.tickPeriod = (speed == SPEED_MAX) ? 0.0 : SIM_DT / speed; // Pas d'interpolation en vitesse max
+    snapshots.Publish();
+}
+
+// --- BOUCLE À PAS FIXE (ACCUMULATEUR) ---
+// accumulator = temps de simulation "dû" et pas encore calculé.
+// À vitesse x10, chaque seconde réelle ajoute 10 secondes dues : 600 pas de SIM_DT.
+void SimThread::Loop() {
+    double last = Now();
+    double accumulator = 0;
+    double rateStart = last;   // Mesure de la vitesse réelle (fenêtre d'une demi-seconde)
+    long long rateTicks = 0;
+
+    while (running) {
+        ApplyCommands();
+        double now = Now();
+        int ticks = 0;
+
+        if (speed == SPEED_MAX) {
+            // Le plus vite possible : des pas jusqu'à l'heure de la prochaine photo
+            accumulator = 0;
+            do { sim.Step(SIM_DT); ticks++; } while (running && Now() - now < PUBLISH_PERIOD);
+        } else {
+            accumulator += (now - last) * speed;
+            // Au plus MAX_CATCH_UP images de pas d'un coup (SIM_DT = une image à x1)
+            int maxTicks = speed * MAX_CATCH_UP;
+            while (accumulator >= SIM_DT && ticks < maxTicks) {
+                sim.Step(SIM_DT);
+                accumulator -= SIM_DT;
+                ticks++;
+            }
+            if (ticks == maxTicks) accumulator = 0; // Trop de retard : on repart de maintenant
+        }
+        last = now;
+
+        if (ticks > 0) {
+            rateTicks += ticks;
+            double elapsed = Now() - rateStart;
+            if (elapsed >= 0.5) { ticksPerSecond = rateTicks / elapsed; rateTicks = 0; rateStart += elapsed; }
+            Publish();
+        }
+
+        // On dort jusqu'au moment où le prochain pas sera dû
+        if (speed != SPEED_MAX) {
+            double wait = (SIM_DT - accumulator) / speed;
+            if (wait > 0) std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+}
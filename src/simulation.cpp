@@ -0,0 +1,558 @@
+/**
+ * SIMULATION (CŒUR SANS AFFICHAGE)
+ * Ce fichier fait avancer la ville d'un pas de temps : feux, incidents,
+ * apparition des civils et mise à jour de toutes les voitures.
+ * Aucun appel à Raylib ici : c'est ce qui permet le mode "headless".
+ */
+
+#include "../include/simulation.h"
+#include "../include/world.h"
+#include "../include/traffic_system.h"
+#include "../include/trace.h"
+#include "../include/state_file.h"
+#include "../include/motion_kernels.h"
+#include <algorithm>
+#include <cstring>
+
+Simulation::Simulation(int vehicleCapacity) {
+    vehicles.Reserve(vehicleCapacity);
+    // Les tampons du pas sont réservés une fois pour toutes, comme le stockage
+    frontPos.resize(vehicleCapacity);
+    frontDir.resize(vehicleCapacity);
+    frontActive.resize(vehicleCapacity);
+    planSpeed.resize(vehicleCapacity);
+    planLane.resize(vehicleCapacity);
+    planFlags.resize(vehicleCapacity);
+    doubleBuffered = false;
+    pool.reset(new ThreadPool(1));
+    maxCivilians = MAX_CIVILIANS;
+    interiorSpawnShare = 0.0f;
+    spawnRate = DEFAULT_SPAWN_RATE;
+    spawned = 0;
+    spawnRefused = 0;
+    civilianArrivals = 0;
+    useSpatialHash = true;
+    useRouting = true;
+    useTravelTimes = true;
+    routesPlanned = 0;
+    routesRepaired = 0;
+    arrivals = 0;
+    arrivalTicks = 0;
+    incidentRate = 1.0f;
+    recorder = nullptr;
+    tick = 0;
+    SetSeed(RandomSeedFromDevice()); // Partie différente à chaque lancement, sauf graine donnée
+}
+
+void Simulation::Reset() {
+    vehicles.Clear();
+    signals.Reset(roadGraph); // Les feux recommencent au vert vertical (le mode est gardé)
+    incidents.Clear();
+    dispatcher.Clear();
+    profiler.Clear();
+    spawnPlaces.Invalidate();
+    spawned = 0;
+    spawnRefused = 0;
+    civilianArrivals = 0;
+    arrivals = 0;
+    arrivalTicks = 0;
+    routesPlanned = 0;
+    routesRepaired = 0;
+    travelTimes.Reset(roadGraph);
+    tick = 0;
+    SetSeed(seed);
+}
+
+void Simulation::SetSeed(uint64_t newSeed) {
+    seed = newSeed;
+    spawnRng.Seed(seed, STREAM_SPAWN);
+    fireRng.Seed(seed, STREAM_FIRE);
+    accidentRng.Seed(seed, STREAM_ACCIDENT);
+    crimeRng.Seed(seed, STREAM_CRIME);
+    loadGenerator.Seed(seed);
+}
+
+uint32_t Simulation::VehicleRandom(int slot) const {
+    // Flux = (usage, poignée de la voiture), compteur = numéro du pas
+    VehicleHandle h = vehicles.HandleAt(slot);
+    uint64_t stream = ((uint64_t)STREAM_VEHICLE_TURN << 56) ^ ((uint64_t)h.generation << 32) ^ h.index;
+    return RandomHash(seed, stream, (uint64_t)tick);
+}
+
+// --- UN PAS DE SIMULATION ---
+// L'ordre est le même que l'ancienne boucle de main.cpp.
+// Chaque étape est chronométrée (voir profiler.h) : une étape = un bloc { ProfileScope ... }.
+void Simulation::Step(float dt) {
+    profiler.BeginTick();
+    // Positions de départ du pas : l'affichage interpole entre elles et les nouvelles
+    std::copy(vehicles.pos.begin(), vehicles.pos.begin() + vehicles.Size(), vehicles.prevPos.begin());
+    { ProfileScope scope(profiler, PHASE_LIGHTS); UpdateLights(dt); }
+    { ProfileScope scope(profiler, PHASE_INCIDENTS); GenerateEvents(dt); }
+    { ProfileScope scope(profiler, PHASE_DISPATCH); dispatcher.Dispatch(*this); } // Les secours partent vers les incidents en attente
+    { ProfileScope scope(profiler, PHASE_SPAWN); SpawnCivilians(); }
+    UpdateCars(dt);
+    tick++;
+    if (recorder) { ProfileScope scope(profiler, PHASE_PUBLISH); recorder->Record(*this); }
+    profiler.EndTick();
+}
+
+void Simulation::Run(int ticks, float dt) {
+    for (int i = 0; i < ticks; i++) Step(dt);
+}
+
+bool Simulation::Spawn(Type type) {
+    int i = SpawnVehicle(*this, type);
+    if (i < 0) return false;
+    dispatcher.OfferUnit(*this, i); // Un secours sorti à la main prend l'incident le plus urgent de son métier
+    return true;
+}
+
+// --- REMPLISSAGE POUR LES TESTS DE CHARGE ---
+// On pose les civils à intervalle régulier sur chaque voie, en évitant les carrefours.
+// Si on demande moins de voitures que de places, on saute des places pour bien répartir.
+int Simulation::PopulateCivilians(int count) {
+    const float spacing = 60.0f;   // Distance entre deux voitures d'une même voie
+    const float clearance = 50.0f; // On ne pose rien trop près d'un carrefour
+
+    // Toutes les places possibles : (position, direction)
+    struct Slot { Vector2 pos; Dir dir; };
+    std::vector<Slot> slots;
+    for (float vx : vRoads) {
+        for (float y = spacing; y < worldHeight - spacing; y += spacing) {
+            // Route horizontale la plus proche (index en O(1)) : trop près = carrefour
+            if (hRoadIndex.Count() > 0 && fabs(y - hRoadIndex.Snap(y)) < clearance) continue;
+            if (OnClosedSegment({ vx, y }, true)) continue; // Rue coupée (scénario)
+            slots.push_back({ { vx + LANE_NORMAL, y }, DOWN });
+            slots.push_back({ { vx - LANE_NORMAL, y }, UP });
+        }
+    }
+    for (float hy : hRoads) {
+        for (float x = SIDEBAR_WIDTH + spacing; x < worldWidth - spacing; x += spacing) {
+            if (vRoadIndex.Count() > 0 && fabs(x - vRoadIndex.Snap(x)) < clearance) continue;
+            if (OnClosedSegment({ x, hy }, false)) continue;
+            slots.push_back({ { x, hy + LANE_NORMAL }, RIGHT });
+            slots.push_back({ { x, hy - LANE_NORMAL }, LEFT });
+        }
+    }
+
+    if (count > (int)slots.size()) count = (int)slots.size();
+    int placed = 0;
+    for (int i = 0; i < count; i++) {
+        const Slot& slot = slots[(size_t)i * slots.size() / count];
+        if (PlaceVehicle(*this, CIVIL, slot.pos, slot.dir) >= 0) placed++;
+    }
+    spawnPlaces.Invalidate(); // Les places d'apparition prises seront remarquées
+    return placed;
+}
+
+void Simulation::SetThreadCount(int threads) {
+    if (threads < 1) threads = 1;
+    pool.reset(new ThreadPool(threads));
+    // Plusieurs threads = lecture obligatoire d'un état figé
+    if (threads > 1) doubleBuffered = true;
+}
+
+double Simulation::AverageResponseSeconds(float dt) const {
+    int count = arrivals;
+    if (count == 0) return 0;
+    return (double)arrivalTicks / count * dt;
+}
+
+// --- EMPREINTE DE L'ÉTAT (FNV-1a) ---
+static void HashBytes(uint64_t& h, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t k = 0; k < size; k++) { h ^= bytes[k]; h *= 1099511628211ull; }
+}
+
+uint64_t Simulation::StateChecksum() const {
+    uint64_t h = 14695981039346656037ull;
+    int n = vehicles.Size();
+    HashBytes(h, &n, sizeof(n));
+    HashBytes(h, vehicles.pos.data(), n * sizeof(Vector2));
+    HashBytes(h, vehicles.dir.data(), n * sizeof(Dir));
+    HashBytes(h, vehicles.type.data(), n * sizeof(Type));
+    HashBytes(h, vehicles.speed.data(), n * sizeof(float));
+    HashBytes(h, vehicles.emState.data(), n * sizeof(EmergencyState));
+    HashBytes(h, vehicles.isYielding.data(), n * sizeof(uint8_t));
+    std::vector<LightCycle> phases;
+    signals.FillPhases(phases);
+    SignalMode mode = signals.Mode();
+    HashBytes(h, &mode, sizeof(mode));
+    HashBytes(h, phases.data(), phases.size() * sizeof(LightCycle));
+    for (int k = 0; k < incidents.SlotCount(); k++) {
+        if (!incidents.IsOpen(k)) continue;
+        const Incident& inc = incidents.At(k);
+        HashBytes(h, &inc.id, sizeof(inc.id));
+        HashBytes(h, &inc.state, sizeof(inc.state));
+        HashBytes(h, &inc.pos, sizeof(inc.pos));
+    }
+    HashBytes(h, &tick, sizeof(tick));
+    HashBytes(h, &seed, sizeof(seed));
+    return h;
+}
+
+// --- SAUVEGARDE ---
+static const char STATE_MAGIC[8] = { 'S', 'C', 'S', 'T', 'A', 'T', 'E', '1' };
+
+// Tailles des structures écrites telles quelles : un fichier d'une autre compilation est refusé
+static void LayoutSignature(uint32_t layout[4]) {
+    layout[0] = sizeof(Vector2);
+    layout[1] = sizeof(Incident);
+    layout[2] = sizeof(LightCycle);
+    layout[3] = sizeof(VehicleHandle);
+}
+
+bool Simulation::SaveState(const char* path, std::string& error) const {
+    FILE* f = fopen(path, "wb");
+    if (!f) { error = "impossible d'ecrire le fichier"; return false; }
+    setvbuf(f, nullptr, _IOFBF, 1 << 22);
+    StateWriter out(f);
+    WriteState(out);
+    bool ok = out.Ok();
+    if (fclose(f) != 0) ok = false;
+    if (!ok) error = "ecriture incomplete (disque plein ?)";
+    return ok;
+}
+
+bool Simulation::LoadState(const char* path, std::string& error) {
+    FILE* f = fopen(path, "rb");
+    if (!f) { error = "fichier introuvable"; return false; }
+    setvbuf(f, nullptr, _IOFBF, 1 << 22);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    uint64_t fileSize = size > 0 ? (uint64_t)size : 0;
+
+    // Deux passes : tout le fichier est d'abord vérifié (en-tête, sections, tailles) sans rien
+    // changer, puis relu dans la simulation. Un fichier abîmé laisse donc la partie telle quelle.
+    fseek(f, 0, SEEK_SET);
+    StateReader check(f, fileSize);
+    if (!CheckState(check)) {
+        error = check.Error();
+        fclose(f);
+        return false;
+    }
+    fseek(f, 0, SEEK_SET);
+    StateReader in(f, fileSize);
+    bool ok = ReadState(in);
+    fclose(f);
+    if (!ok) { error = in.Error(); return false; } // Fichier changé entre les deux passes
+    profiler.Clear();
+    return true;
+}
+
+void Simulation::WriteState(StateWriter& out) const {
+    out.Bytes(STATE_MAGIC, sizeof(STATE_MAGIC));
+    out.Value(STATE_VERSION);
+    uint32_t layout[4];
+    LayoutSignature(layout);
+    out.Bytes(layout, sizeof(layout));
+
+    SaveWorld(out);
+
+    out.Section("SIMU");
+    out.Value(tick);
+    out.Value(seed);
+    const Random* streams[] = { &spawnRng, &fireRng, &accidentRng, &crimeRng };
+    for (const Random* r : streams) out.Value(r->Counter());
+    out.Value(maxCivilians);
+    out.Value(interiorSpawnShare);
+    out.Value(spawnRate);
+    out.Value(spawned);
+    out.Value(spawnRefused);
+    out.Value(useSpatialHash);
+    out.Value(doubleBuffered);
+    out.Value(useRouting);
+    out.Value(useTravelTimes);
+    out.Value(routesPlanned);
+    out.Value(routesRepaired);
+    out.Value(arrivals.load());
+    out.Value(arrivalTicks.load());
+    out.Value(incidentRate);
+
+    vehicles.Save(out);
+    signals.Save(out);
+    travelTimes.Save(out);
+    incidents.Save(out);
+    dispatcher.Save(out);
+    loadGenerator.Save(out);
+    out.Section("FIN.");
+}
+
+static bool ReadHeader(StateReader& in) {
+    char magic[8];
+    uint32_t version = 0, layout[4], expected[4];
+    LayoutSignature(expected);
+    in.Bytes(magic, sizeof(magic));
+    in.Value(version);
+    in.Bytes(layout, sizeof(layout));
+    if (in.Ok() && memcmp(magic, STATE_MAGIC, sizeof(magic)) != 0) in.Fail("ce n'est pas une sauvegarde");
+    else if (in.Ok() && version != STATE_VERSION) in.Fail("version de sauvegarde inconnue");
+    else if (in.Ok() && memcmp(layout, expected, sizeof(layout)) != 0) in.Fail("sauvegarde d'une autre compilation");
+    return in.Ok();
+}
+
+bool Simulation::CheckState(StateReader& in) const {
+    if (!ReadHeader(in) || !CheckWorld(in)) return false;
+
+    // SIMU : mêmes champs que ReadState, lus dans des copies
+    auto skip = [&in](auto v) { in.Value(v); };
+    in.Section("SIMU");
+    skip(tick);
+    skip(seed);
+    for (int k = 0; k < 4; k++) skip(uint64_t(0));
+    skip(maxCivilians);
+    skip(interiorSpawnShare);
+    skip(spawnRate);
+    skip(spawned);
+    skip(spawnRefused);
+    skip(useSpatialHash);
+    skip(doubleBuffered);
+    skip(useRouting);
+    skip(useTravelTimes);
+    skip(routesPlanned);
+    skip(routesRepaired);
+    skip(int(0));
+    skip((long long)0);
+    skip(incidentRate);
+
+    // Les colonnes des véhicules sont sautées ; le reste est petit et lu dans des objets jetables
+    if (in.Ok()) vehicles.Check(in);
+    if (in.Ok()) { SignalSystem s; s.Load(in); }
+    if (in.Ok()) { TravelTimes t; t.Load(in); }
+    if (in.Ok()) { IncidentTable t; t.Load(in); }
+    if (in.Ok()) { Dispatcher d; d.Load(in); }
+    if (in.Ok()) { LoadGenerator g; g.Load(in); }
+    in.Section("FIN.");
+    return in.Ok();
+}
+
+bool Simulation::ReadState(StateReader& in) {
+    // Le fichier a été vérifié par CheckState : seul un fichier modifié entre-temps échoue ici
+    if (!ReadHeader(in)) return false;
+
+    LoadWorld(in);
+
+    uint64_t counters[4] = { 0, 0, 0, 0 };
+    int arrivalCount = 0;
+    long long arrivalSum = 0;
+    in.Section("SIMU");
+    in.Value(tick);
+    in.Value(seed);
+    for (uint64_t& c : counters) in.Value(c);
+    in.Value(maxCivilians);
+    in.Value(interiorSpawnShare);
+    in.Value(spawnRate);
+    in.Value(spawned);
+    in.Value(spawnRefused);
+    in.Value(useSpatialHash);
+    in.Value(doubleBuffered);
+    in.Value(useRouting);
+    in.Value(useTravelTimes);
+    in.Value(routesPlanned);
+    in.Value(routesRepaired);
+    in.Value(arrivalCount);
+    in.Value(arrivalSum);
+    in.Value(incidentRate);
+
+    if (in.Ok()) vehicles.Load(in);
+    if (in.Ok()) signals.Load(in);
+    if (in.Ok()) travelTimes.Load(in);
+    if (in.Ok()) incidents.Load(in);
+    if (in.Ok()) dispatcher.Load(in);
+    SetSeed(seed); // Tous les flux repartent de la graine lue (le générateur reprend ensuite sa file)
+    if (in.Ok()) loadGenerator.Load(in);
+    in.Section("FIN.");
+    if (!in.Ok()) return false;
+
+    // Ce qui n'est pas dans le fichier : compteurs des flux de hasard, tampons du pas
+    Random* streams[] = { &spawnRng, &fireRng, &accidentRng, &crimeRng };
+    for (int k = 0; k < 4; k++) streams[k]->SetCounter(counters[k]);
+    arrivals = arrivalCount;
+    arrivalTicks = arrivalSum;
+    int capacity = vehicles.Capacity();
+    if ((int)frontPos.size() < capacity) {
+        frontPos.resize(capacity);
+        frontDir.resize(capacity);
+        frontActive.resize(capacity);
+        planSpeed.resize(capacity);
+        planLane.resize(capacity);
+        planFlags.resize(capacity);
+    }
+    spawnPlaces.Invalidate();
+    return true;
+}
+
+// --- FEUX TRICOLORES ---
+// Chaque carrefour a son feu (voir SignalSystem) ; on en profite pour compter
+// les voitures qui attendent devant chacun.
+void Simulation::UpdateLights(float dt) {
+    signals.Update(dt, vehicles, roadGraph);
+}
+
+// --- ARRIVÉES (GÉNÉRATEUR DE CHARGE) ---
+// Le générateur connaît la date de la prochaine arrivée de chaque type : tant qu'aucune
+// n'est due pendant ce pas, il n'y a rien à tirer. Plusieurs incidents peuvent coexister ;
+// on évite seulement d'en ouvrir deux du même type au même endroit.
+void Simulation::GenerateEvents(float dt) {
+    // Taux de base de ce pas : les réglages (incidentRate, spawnRate) peuvent changer en cours de partie
+    const ArrivalRate* rates = loadGenerator.profile.rates;
+    double base[LOAD_KIND_COUNT];
+    for (int k = 0; k < LOAD_CIVILIAN; k++) base[k] = rates[k].perHour * incidentRate;
+    base[LOAD_CIVILIAN] = rates[LOAD_CIVILIAN].perHour >= 0 ? rates[LOAD_CIVILIAN].perHour : spawnRate * 3600.0;
+    loadGenerator.Retune(tick * (double)dt, base);
+
+    auto report = [&](IncidentType type, Vector2 pos, int priority) {
+        if (incidents.OpenCount() >= MAX_OPEN_INCIDENTS || incidents.OpenNear(type, pos, 1.0f)) return;
+        dispatcher.Report(*this, incidents.Open(type, pos, priority, tick));
+    };
+
+    // Toutes les arrivées datées d'avant la fin du pas, dans l'ordre du temps
+    LoadKind kind;
+    while (loadGenerator.Pop((tick + 1) * (double)dt, kind)) {
+        if (kind == LOAD_FIRE) {
+            // 1. Incendies (toujours urgents), à un coin de pâté de maisons tiré dans la table
+            if (!fireSites.empty()) report(INCIDENT_FIRE, fireSites[fireRng.Range(0, (int)fireSites.size() - 1)], 3);
+        } else if (kind == LOAD_ACCIDENT) {
+            // 2. Accidents de la route (sur une intersection ; blessés légers ou graves)
+            Vector2 crash = GetRandomRoadTarget(accidentRng);
+            report(INCIDENT_ACCIDENT, crash, accidentRng.Range(2, 3));
+        } else if (kind == LOAD_CRIME) {
+            // 3. Vols et agressions (au milieu d'une rue)
+            Dir unused;
+            Vector2 scene = GetRandomRoadOrigin(crimeRng, unused);
+            report(INCIDENT_CRIME, scene, crimeRng.Range(1, 2));
+        } else {
+            civilianArrivals++; // 4. Placés plus loin dans le pas (SpawnCivilians)
+        }
+    }
+}
+
+// --- APPARITION AUTOMATIQUE DES VOITURES CIVILES ---
+// Les civils arrivés pendant le pas (plusieurs par pas pour les tests de charge) prennent
+// chacun une place libre. Ville pleine : ils repartent. Sans place libre, les arrivées
+// restantes du pas sont comptées comme refusées (pas de file d'attente qui grossirait
+// sans fin sous un afflux trop fort).
+void Simulation::SpawnCivilians() {
+    int due = civilianArrivals;
+    civilianArrivals = 0;
+    for (; due > 0 && vehicles.Size() < maxCivilians; due--) {
+        if (SpawnVehicle(*this, CIVIL) < 0) {
+            spawnRefused += due;
+            return;
+        }
+        spawned++;
+    }
+}
+
+// --- ITINÉRAIRES DES SECOURS (A*) ---
+// Un secours qui roule vers une destination sans itinéraire valable (nouvelle mission,
+// retour à la base, ou sorti de son trajet) en reçoit un nouveau, depuis le prochain
+// carrefour devant lui jusqu'au carrefour le plus proche de sa destination.
+// Avec les temps de parcours, un itinéraire n'est réparé que si l'un des tronçons
+// qui lui restent à parcourir a changé de plus que le seuil : on ne recalcule jamais
+// tous les itinéraires à chaque pas.
+void Simulation::PlanRoutes() {
+    VehicleStore& v = vehicles;
+    int n = v.Size();
+
+    // 1. Mesure des embouteillages (de temps en temps seulement)
+    bool timesChanged = false;
+    if (useTravelTimes) {
+        if (travelTimes.Times().size() != roadGraph.edgeTo.size()) travelTimes.Reset(roadGraph);
+        if (tick % TravelTimes::SAMPLE_PERIOD == 0) timesChanged = travelTimes.Sample(v, roadGraph);
+    }
+    const std::vector<float>* cost = useTravelTimes ? &travelTimes.Times() : nullptr;
+    float costPerPixel = useTravelTimes ? 1.0f / TravelTimes::FREE_SPEED : 1.0f;
+
+    for (int i = 0; i < n; i++) {
+        if (v.type[i] == CIVIL || !v.active[i]) continue;
+        if (v.emState[i] != ON_MISSION && v.emState[i] != RETURNING) continue;
+        bool sameGoal = (v.routeGoal[i].x == v.target[i].x && v.routeGoal[i].y == v.target[i].y);
+
+        // 2. Réparation : un tronçon encore à parcourir a beaucoup changé
+        if (v.hasRoute[i] && sameGoal && timesChanged) {
+            const std::vector<int>& route = v.route[i];
+            for (int k = std::max(v.routeStep[i] - 1, 0); k + 1 < (int)route.size(); k++) {
+                int e = roadGraph.FindEdge(route[k], route[k + 1]);
+                if (e >= 0 && travelTimes.Changed(e)) { v.hasRoute[i] = 0; routesRepaired++; break; }
+            }
+        }
+        if (v.hasRoute[i] && sameGoal) continue;
+
+        // 3. Calcul de l'itinéraire depuis le prochain carrefour
+        // (si la voiture vient de tourner, elle a déjà quitté ce carrefour)
+        int from = roadGraph.NextNodeAhead(v.pos[i], v.dir[i], 20.0f, v.turnCooldown[i] > 0);
+        int to = roadGraph.NearestNode(v.target[i]);
+        v.hasRoute[i] = planner.FindRoute(roadGraph, from, to, v.route[i], cost, costPerPixel) ? 1 : 0;
+        v.routeStep[i] = 0;
+        v.routeGoal[i] = v.target[i];
+        routesPlanned++;
+    }
+}
+
+// --- MISE À JOUR DE TOUTES LES VOITURES (Mouvement, IA, Collisions) ---
+void Simulation::UpdateCars(float dt) {
+    int n = vehicles.Size();
+
+    {
+        ProfileScope scope(profiler, PHASE_GRID);
+        // On range les voitures dans la grille une seule fois pour tout le pas
+        // (en mode double tampon, la grille sert aussi à découper la carte en régions)
+        if (useSpatialHash || doubleBuffered) grid.Build(vehicles);
+        // Et on calcule une seule fois où les civils doivent laisser passer les secours
+        yieldField.Build(vehicles);
+    }
+    // Les itinéraires sont calculés ici, avant la boucle (un seul planificateur, pas de partage entre threads)
+    if (useRouting) { ProfileScope scope(profiler, PHASE_ROUTES); PlanRoutes(); }
+
+    {
+        ProfileScope scope(profiler, PHASE_CARS);
+        if (!doubleBuffered) {
+            // Parcours linéaire des tableaux (on ne supprime rien pendant la boucle).
+            // Chaque voiture bouge juste après sa décision : les suivantes voient déjà sa nouvelle place.
+            CarCounters counters;
+            for (int i = 0; i < n; i++) UpdateVehicle(*this, i, dt, counters);
+            profiler.AddCounters(counters);
+        } else {
+            // 1. Tampon de lecture : copie figée de ce que les voitures voient des autres
+            std::copy(vehicles.pos.begin(), vehicles.pos.begin() + n, frontPos.begin());
+            std::copy(vehicles.dir.begin(), vehicles.dir.begin() + n, frontDir.begin());
+            std::copy(vehicles.active.begin(), vehicles.active.begin() + n, frontActive.begin());
+
+            // 2. Une tâche = un paquet de voitures qui se suivent dans la grille. Elles y sont
+            // rangées case par case : un paquet correspond à une petite région de la carte.
+            // Le nombre de tâches dépend du nombre de voitures, pas de la taille de la ville
+            // (une grande ville presque vide ne crée pas des milliers de tâches vides).
+            const int carsPerTask = 32;
+            int entryCount = grid.EntryCount();
+            int taskCount = (entryCount + carsPerTask - 1) / carsPerTask;
+            // Chaque tâche compte dans sa propre case : pas d'écriture partagée entre threads
+            taskCounters.assign(taskCount, CarCounters());
+            // Les voitures qui ne sont pas dans la grille ne bougent pas
+            std::fill(planFlags.begin(), planFlags.begin() + n, (uint8_t)MOTION_SKIP);
+            pool->ParallelFor(taskCount, [&](int task) {
+                int begin = task * carsPerTask;
+                int end = std::min(begin + carsPerTask, entryCount);
+                for (int k = begin; k < end; k++) PlanVehicle(*this, grid.EntryAt(k), dt, taskCounters[task]);
+            });
+            for (const CarCounters& counters : taskCounters) profiler.AddCounters(counters);
+
+            // 3. Mouvement de toutes les voitures, par tranches contiguës du stockage
+            // (personne ne relit les positions des autres : l'ordre ne change rien)
+            const int carsPerMove = 2048;
+            pool->ParallelFor((n + carsPerMove - 1) / carsPerMove, [&](int task) {
+                int begin = task * carsPerMove;
+                MoveVehicles(*this, begin, std::min(carsPerMove, n - begin));
+            });
+        }
+    }
+
+    {
+        ProfileScope scope(profiler, PHASE_CLEANUP);
+        // Suppression des voitures sorties de la ville ou garées (O(1) chacune, sans allocation)
+        vehicles.RemoveInactive();
+
+        // Les incidents terminés pendant le pas disparaissent maintenant
+        dispatcher.Collect(*this);
+    }
+}
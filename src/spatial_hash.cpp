@@ -0,0 +1,99 @@
+/**
+ * GRILLE SPATIALE (SPATIAL HASH)
+ * Accélère la détection d'obstacles : au lieu de comparer chaque voiture
+ * avec toutes les autres (O(n²)), on ne compare qu'avec les voisines proches.
+ */
+
+#include "../include/spatial_hash.h"
+#include "../include/vehicle_store.h"
+#include "../include/world.h"
+#include <algorithm>
+
+// Marge autour du monde : les civils apparaissent et disparaissent juste hors de la ville
+static const float WORLD_MARGIN = 200.0f;
+
+// Moitié de la longueur d'une voiture (voir GetCarRect)
+static const float CAR_HALF_LENGTH = 13.0f;
+
+SpatialHash::SpatialHash(float size) {
+    cellSize = size;
+    originX = 0; originY = 0;
+    cols = 0; rows = 0;
+}
+
+// Numéro de colonne d'une position X (les voitures hors grille vont dans la case du bord)
+int SpatialHash::CellX(float x) const {
+    int cx = (int)floorf((x - originX) / cellSize);
+    if (cx < 0) cx = 0;
+    if (cx >= cols) cx = cols - 1;
+    return cx;
+}
+
+int SpatialHash::CellY(float y) const {
+    int cy = (int)floorf((y - originY) / cellSize);
+    if (cy < 0) cy = 0;
+    if (cy >= rows) cy = rows - 1;
+    return cy;
+}
+
+// Cases touchées par un rectangle. On l'agrandit de la demi-longueur d'une voiture
+// (une voiture est rangée selon son CENTRE) et de la marge de mouvement.
+void SpatialHash::CellRange(Rectangle area, int& minCx, int& minCy, int& maxCx, int& maxCy) const {
+    float pad = CAR_HALF_LENGTH + QUERY_MARGIN;
+    minCx = CellX(area.x - pad);
+    minCy = CellY(area.y - pad);
+    maxCx = CellX(area.x + area.width + pad);
+    maxCy = CellY(area.y + area.height + pad);
+}
+
+// --- RECONSTRUCTION (TRI PAR COMPTAGE) ---
+// 1. On compte les voitures par case, 2. on calcule où commence chaque case occupée,
+// 3. on range les voitures. Les tableaux sont réutilisés d'un pas à l'autre (pas d'allocation)
+// et seules les cases occupées sont touchées : rien ne parcourt toute la carte.
+void SpatialHash::Build(const VehicleStore& vehicles) {
+    Build(vehicles.pos.data(), vehicles.active.data(), vehicles.Size());
+}
+
+void SpatialHash::Build(const Vector2* pos, const uint8_t* active, int n) {
+    // La taille du monde peut changer (fenêtre redimensionnée) : on recalcule la grille
+    int newCols = std::max(1, (int)ceilf((worldWidth + 2 * WORLD_MARGIN) / cellSize));
+    int newRows = std::max(1, (int)ceilf((worldHeight + 2 * WORLD_MARGIN) / cellSize));
+    originX = -WORLD_MARGIN;
+    originY = -WORLD_MARGIN;
+    if (newCols != cols || newRows != rows) {
+        // Nouvelle carte : seul cas où l'on remet toutes les cases à zéro
+        cols = newCols;
+        rows = newRows;
+        cellStart.assign(cols * rows, 0);
+        cellCars.assign(cols * rows, 0);
+        occupied.clear();
+    } else {
+        // Sinon, on vide seulement les cases occupées au pas précédent
+        for (int cell : occupied) cellCars[cell] = 0;
+        occupied.clear();
+    }
+    carCell.resize(n);
+
+    // 1. Comptage (et liste des cases qui ont au moins une voiture)
+    for (int i = 0; i < n; i++) {
+        if (!active[i]) { carCell[i] = -1; continue; }
+        int cell = CellY(pos[i].y) * cols + CellX(pos[i].x);
+        carCell[i] = cell;
+        if (cellCars[cell]++ == 0) occupied.push_back(cell);
+    }
+
+    // 2. Début de chaque case occupée, dans l'ordre des numéros de case
+    std::sort(occupied.begin(), occupied.end());
+    int total = 0;
+    for (int cell : occupied) { cellStart[cell] = total; total += cellCars[cell]; }
+
+    // 3. Rangement (on garde l'ordre du stockage à l'intérieur de chaque case).
+    // cellStart sert de curseur d'écriture, puis on le remet au début de chaque case.
+    entries.resize(total);
+    for (int i = 0; i < n; i++) {
+        int cell = carCell[i];
+        if (cell < 0) continue;
+        entries[cellStart[cell]++] = i;
+    }
+    for (int cell : occupied) cellStart[cell] -= cellCars[cell];
+}
@@ -0,0 +1,140 @@
+/**
+ * PLACES D'APPARITION
+ * Liste des voies où un civil peut naître et marquage des places occupées
+ * (voir spawn_index.h).
+ */
+
+#include "../include/spawn_index.h"
+#include "../include/vehicle_store.h"
+#include "../include/world.h"
+#include <algorithm>
+
+SpawnIndex::SpawnIndex() : edgeCount(0), builtVersion(-1), refreshedTick(-1), stamp(0) {}
+
+// --- LES PLACES ---
+// Numérotation (V routes verticales, H routes horizontales) :
+//   bords       : 2 par route verticale (entrée en haut vers le bas, en bas vers le haut),
+//                 puis 2 par route horizontale (à gauche vers la droite, à droite vers la gauche)
+//   verticales  : (route * (H-1) + tronçon) * 2 + sens (0 = vers le bas, 1 = vers le haut)
+//   horizontales: (route * (V-1) + tronçon) * 2 + sens (0 = vers la droite, 1 = vers la gauche)
+// Les positions sont celles de l'ancienne apparition au hasard (bords et GetRandomRoadOrigin).
+void SpawnIndex::BuildPlaces() {
+    places.clear();
+    Rectangle city = CityBounds();
+    int V = (int)vRoads.size();
+    int H = (int)hRoads.size();
+
+    for (int r = 0; r < V; r++) {
+        places.push_back({ { vRoads[r] + LANE_NORMAL, city.y - EDGE_DISTANCE }, DOWN });
+        places.push_back({ { vRoads[r] - LANE_NORMAL, city.y + city.height + EDGE_DISTANCE }, UP });
+    }
+    for (int r = 0; r < H; r++) {
+        places.push_back({ { city.x - EDGE_DISTANCE, hRoads[r] + LANE_NORMAL }, RIGHT });
+        places.push_back({ { city.x + city.width + EDGE_DISTANCE, hRoads[r] - LANE_NORMAL }, LEFT });
+    }
+    edgeCount = (int)places.size();
+    closed.assign(edgeCount, 0);
+
+    // Milieux des tronçons (il faut au moins deux routes de chaque sens)
+    if (V >= 2 && H >= 2) {
+        for (int r = 0; r < V; r++) {
+            for (int b = 0; b + 1 < H; b++) {
+                float mid = (hRoads[b] + hRoads[b + 1]) / 2;
+                places.push_back({ { vRoads[r] + LANE_NORMAL, mid }, DOWN });
+                places.push_back({ { vRoads[r] - LANE_NORMAL, mid }, UP });
+                bool cut = !closedSegments.empty() && (closedSegments[b * V + r] & CLOSED_DOWN);
+                closed.push_back(cut);
+                closed.push_back(cut);
+            }
+        }
+        for (int r = 0; r < H; r++) {
+            for (int b = 0; b + 1 < V; b++) {
+                float mid = (vRoads[b] + vRoads[b + 1]) / 2;
+                places.push_back({ { mid, hRoads[r] + LANE_NORMAL }, RIGHT });
+                places.push_back({ { mid, hRoads[r] - LANE_NORMAL }, LEFT });
+                bool cut = !closedSegments.empty() && (closedSegments[r * V + b] & CLOSED_RIGHT);
+                closed.push_back(cut);
+                closed.push_back(cut);
+            }
+        }
+    }
+
+    busy.assign(places.size(), 0);
+    stamp = 0;
+    freeEdges.reserve(edgeCount);
+    builtVersion = worldVersion;
+}
+
+// Marque la place que cette voiture occupe (s'il y en a une) : même route, même sens,
+// à moins de SPAWN_CLEARANCE le long de la voie. Calcul direct, sans parcourir les places.
+void SpawnIndex::MarkCar(Vector2 pos, Dir dir) {
+    Rectangle city = CityBounds();
+    int V = (int)vRoads.size();
+    int H = (int)hRoads.size();
+
+    if (dir == UP || dir == DOWN) {
+        int r = vRoadIndex.Nearest(pos.x);
+        if (r < 0 || fabs(pos.x - vRoads[r]) > ROAD_WIDTH / 2) return;
+        int lane = (dir == DOWN) ? 0 : 1;
+        float edgeY = (dir == DOWN) ? city.y - EDGE_DISTANCE : city.y + city.height + EDGE_DISTANCE;
+        if (fabs(pos.y - edgeY) < SPAWN_CLEARANCE) Mark(2 * r + lane);
+        int b = hRoadIndex.Segment(pos.y) - 1; // Tronçon entre hRoads[b] et hRoads[b+1]
+        if (b >= 0 && b + 1 < H && fabs(pos.y - (hRoads[b] + hRoads[b + 1]) / 2) < SPAWN_CLEARANCE) {
+            Mark(edgeCount + (r * (H - 1) + b) * 2 + lane);
+        }
+    } else if (dir == LEFT || dir == RIGHT) {
+        int r = hRoadIndex.Nearest(pos.y);
+        if (r < 0 || fabs(pos.y - hRoads[r]) > ROAD_WIDTH / 2) return;
+        int lane = (dir == RIGHT) ? 0 : 1;
+        float edgeX = (dir == RIGHT) ? city.x - EDGE_DISTANCE : city.x + city.width + EDGE_DISTANCE;
+        if (fabs(pos.x - edgeX) < SPAWN_CLEARANCE) Mark(2 * V + 2 * r + lane);
+        int b = vRoadIndex.Segment(pos.x) - 1;
+        if (b >= 0 && b + 1 < V && fabs(pos.x - (vRoads[b] + vRoads[b + 1]) / 2) < SPAWN_CLEARANCE) {
+            Mark(edgeCount + 2 * V * (H - 1) + (r * (V - 1) + b) * 2 + lane);
+        }
+    }
+}
+
+// Un passage sur toutes les voitures : O(n) une fois par pas, quel que soit le nombre d'apparitions
+void SpawnIndex::Refresh(const VehicleStore& vehicles) {
+    if (builtVersion != worldVersion) BuildPlaces();
+    // Nouveau numéro de marquage : toutes les places redeviennent libres sans rien effacer
+    if (++stamp == 0) { std::fill(busy.begin(), busy.end(), 0u); stamp = 1; }
+
+    for (int i = 0; i < vehicles.Size(); i++) {
+        if (vehicles.active[i]) MarkCar(vehicles.pos[i], vehicles.dir[i]);
+    }
+
+    freeEdges.clear();
+    for (int p = 0; p < edgeCount; p++) {
+        if (busy[p] != stamp) freeEdges.push_back(p);
+    }
+}
+
+int SpawnIndex::Take(const VehicleStore& vehicles, long long tick, bool interior, Random& rng) {
+    if (builtVersion != worldVersion || refreshedTick != tick) {
+        Refresh(vehicles);
+        refreshedTick = tick;
+    }
+
+    if (!interior) {
+        // Tirage parmi les bords libres, puis la place sort de la liste (échange avec la dernière)
+        if (freeEdges.empty()) return -1;
+        int k = rng.Range(0, (int)freeEdges.size() - 1);
+        int place = freeEdges[k];
+        freeEdges[k] = freeEdges.back();
+        freeEdges.pop_back();
+        Mark(place);
+        return place;
+    }
+
+    // Intérieur : une place au hasard, ou la suivante libre (la ville est rarement pleine)
+    int count = (int)places.size() - edgeCount;
+    if (count <= 0) return -1;
+    int start = rng.Range(0, count - 1);
+    for (int k = 0; k < count; k++) {
+        int place = edgeCount + (start + k) % count;
+        if (busy[place] != stamp && !closed[place]) { Mark(place); return place; }
+    }
+    return -1;
+}
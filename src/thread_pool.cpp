@@ -0,0 +1,134 @@
+/**
+ * RÉSERVOIR DE THREADS (WORK STEALING)
+ * Permet de mettre à jour les voitures sur plusieurs cœurs du processeur.
+ */
+
+#include "../include/thread_pool.h"
+
+// Un bloc [début, fin) est rangé dans un entier 64 bits : début en haut, fin en bas
+static uint64_t PackRange(uint32_t begin, uint32_t end) { return ((uint64_t)begin << 32) | end; }
+static uint32_t RangeBegin(uint64_t r) { return (uint32_t)(r >> 32); }
+static uint32_t RangeEnd(uint64_t r) { return (uint32_t)r; }
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount < 1) threadCount = 1;
+    jobId = 0;
+    finishedWorkers = 0;
+    stopping = false;
+    currentTask = nullptr;
+
+    queueStorage.reset(new Queue[threadCount]);
+    for (int i = 0; i < threadCount; i++) {
+        queueStorage[i].range.store(PackRange(0, 0));
+        queues.push_back(&queueStorage[i]);
+    }
+    // Le thread 0 est celui qui appelle ParallelFor : on ne crée que les autres
+    for (int i = 1; i < threadCount; i++) workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& w : workers) w.join();
+}
+
+void ThreadPool::ParallelFor(int taskCount, const std::function<void(int)>& task) {
+    if (taskCount <= 0) return;
+    int threads = ThreadCount();
+
+    // Un seul thread : pas besoin de synchronisation
+    if (threads == 1) {
+        for (int t = 0; t < taskCount; t++) task(t);
+        return;
+    }
+
+    // 1. Distribution de départ : un bloc contigu de tâches par thread
+    for (int i = 0; i < threads; i++) {
+        uint32_t begin = (uint32_t)((int64_t)taskCount * i / threads);
+        uint32_t end = (uint32_t)((int64_t)taskCount * (i + 1) / threads);
+        queues[i]->range.store(PackRange(begin, end));
+    }
+
+    // 2. On réveille les autres threads
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        finishedWorkers = 0;
+        jobId++;
+    }
+    wakeUp.notify_all();
+
+    // 3. Le thread appelant travaille aussi
+    RunTasks(0);
+
+    // 4. On attend que tout le monde ait fini
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [&] { return finishedWorkers == threads - 1; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::WorkerLoop(int id) {
+    uint64_t seenJob = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [&] { return stopping || jobId != seenJob; });
+            if (stopping) return;
+            seenJob = jobId;
+        }
+
+        RunTasks(id);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishedWorkers++;
+        }
+        allDone.notify_one();
+    }
+}
+
+void ThreadPool::RunTasks(int id) {
+    const std::function<void(int)>& task = *currentTask;
+    int t;
+    while (true) {
+        while (PopFront(id, t)) task(t);
+        // Notre bloc est vide : on essaie de voler du travail. Si personne n'a plus rien, c'est fini.
+        if (!StealHalf(id)) return;
+    }
+}
+
+bool ThreadPool::PopFront(int id, int& task) {
+    std::atomic<uint64_t>& range = queues[id]->range;
+    uint64_t r = range.load(std::memory_order_acquire);
+    while (RangeBegin(r) < RangeEnd(r)) {
+        uint64_t next = PackRange(RangeBegin(r) + 1, RangeEnd(r));
+        if (range.compare_exchange_weak(r, next, std::memory_order_acq_rel)) {
+            task = (int)RangeBegin(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::StealHalf(int thief) {
+    int threads = ThreadCount();
+    for (int k = 1; k < threads; k++) {
+        int victim = (thief + k) % threads; // On commence par le voisin (région proche)
+        std::atomic<uint64_t>& range = queues[victim]->range;
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (RangeBegin(r) < RangeEnd(r)) {
+            uint32_t begin = RangeBegin(r);
+            uint32_t end = RangeEnd(r);
+            uint32_t half = (end - begin + 1) / 2; // On prend la fin du bloc (au moins 1 tâche)
+            if (range.compare_exchange_weak(r, PackRange(begin, end - half), std::memory_order_acq_rel)) {
+                // Notre propre bloc est vide : personne d'autre ne le modifie avec succès
+                queues[thief]->range.store(PackRange(end - half, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
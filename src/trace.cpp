@@ -0,0 +1,613 @@
+/**
+ * TRACE BINAIRE DES TRAJECTOIRES
+ * Enregistrement pas à pas (thread d'écriture en arrière-plan) et relecture
+ * par projection du fichier en mémoire (voir trace.h).
+ */
+
+#include "../include/trace.h"
+#include "../include/sim_thread.h"
+#include "../include/world.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// --- PETITS OUTILS DE CODAGE ---
+static const char TRACE_MAGIC[8] = { 'S', 'C', 'T', 'R', 'A', 'C', 'E', '1' };
+static const size_t TRACE_HEADER_SIZE = 40;
+
+enum TraceFrameKind : uint8_t { FRAME_KEY = 1, FRAME_DELTA = 2 };
+enum TraceIncidentEvent : uint8_t { EVENT_OPEN, EVENT_UPDATE, EVENT_CLOSE };
+
+// Entier variable : 7 bits par octet, le bit du haut dit "il y a une suite"
+static void PutVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+
+// Les petits nombres négatifs deviennent de petits nombres positifs : 0, -1, 1, -2... -> 0, 1, 2, 3...
+static void PutZigzag(std::vector<uint8_t>& out, int64_t v) {
+    PutVarint(out, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static void PutRaw(std::vector<uint8_t>& out, const void* p, size_t n) {
+    const uint8_t* b = (const uint8_t*)p;
+    out.insert(out.end(), b, b + n);
+}
+
+// Lecture protégée : au moindre débordement, "ok" passe à false et tout renvoie 0
+struct TraceCursor {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok;
+
+    uint8_t Byte() {
+        if (p >= end) { ok = false; return 0; }
+        return *p++;
+    }
+    uint64_t Varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = Byte();
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    int64_t Zigzag() {
+        uint64_t v = Varint();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+};
+
+static int32_t QuantizePos(float v) { return (int32_t)lroundf(v * TRACE_POS_SCALE); }
+static int32_t QuantizeSpeed(float v) { return (int32_t)lroundf(v * TRACE_SPEED_SCALE); }
+
+// Octet d'état : direction (3 bits), état de secours (3 bits), se range, freine
+static uint8_t PackState(Dir dir, EmergencyState em, bool yielding, bool braking) {
+    return (uint8_t)((dir & 7) | ((em & 7) << 3) | (yielding ? 0x40 : 0) | (braking ? 0x80 : 0));
+}
+
+static void PutHandle(std::vector<uint8_t>& out, VehicleHandle h) {
+    if (h.index == INVALID_VEHICLE.index) { PutVarint(out, 0); return; }
+    PutVarint(out, (uint64_t)h.index + 1);
+    PutVarint(out, h.generation);
+}
+
+static VehicleHandle GetHandle(TraceCursor& c) {
+    uint64_t index = c.Varint();
+    if (index == 0) return INVALID_VEHICLE;
+    VehicleHandle h;
+    h.index = (uint32_t)(index - 1);
+    h.generation = (uint32_t)c.Varint();
+    return h;
+}
+
+// --- COPIE D'UN PAS (thread de simulation) ---
+void TraceFrame::CaptureFrom(const Simulation& s) {
+    tick = s.tick;
+    signalMode = s.signals.Mode();
+    s.signals.FillPhases(phases);
+    incidents.clear();
+    for (int k = 0; k < s.incidents.SlotCount(); k++) {
+        if (s.incidents.IsOpen(k)) incidents.push_back(s.incidents.At(k));
+    }
+
+    const VehicleStore& v = s.vehicles;
+    int n = v.Size();
+    handle.resize(n);
+    for (int i = 0; i < n; i++) handle[i] = v.HandleAt(i);
+    type.assign(v.type.begin(), v.type.begin() + n);
+    pos.assign(v.pos.begin(), v.pos.begin() + n);
+    dir.assign(v.dir.begin(), v.dir.begin() + n);
+    speed.assign(v.speed.begin(), v.speed.begin() + n);
+    maxSpeed.assign(v.maxSpeed.begin(), v.maxSpeed.begin() + n);
+    emState.assign(v.emState.begin(), v.emState.begin() + n);
+    isYielding.assign(v.isYielding.begin(), v.isYielding.begin() + n);
+}
+
+// --- ENREGISTREUR ---
+TraceRecorder::TraceRecorder()
+    : file(nullptr), keyframeEvery(TRACE_DEFAULT_KEYFRAME), recordedTick(-1), waitSeconds(0), stopping(false),
+      framesWritten(0), bytesWritten(0), firstTick(0), lastTick(-1) {}
+
+TraceRecorder::~TraceRecorder() {
+    Close();
+}
+
+bool TraceRecorder::Open(const char* path, const Simulation& sim, int every) {
+    Close();
+    file = fopen(path, "wb");
+    if (!file) return false;
+    setvbuf(file, nullptr, _IOFBF, 1 << 20); // Grosses écritures : le disque travaille par paquets
+
+    keyframeEvery = std::max(1, every);
+    recordedTick = -1;
+    waitSeconds = 0;
+    framesWritten = 0;
+    lastTick = -1;
+    lastVehicle.clear();
+    lastSeen.clear();
+    lastPhases.clear();
+    lastIncidents.clear();
+
+    // En-tête (40 octets)
+    std::vector<uint8_t> header;
+    PutRaw(header, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    uint32_t version = TRACE_VERSION;
+    uint32_t period = (uint32_t)keyframeEvery;
+    float dt = SIM_DT;
+    int32_t w = (int32_t)worldWidth, h = (int32_t)worldHeight;
+    uint32_t reserved = 0;
+    uint64_t seed = sim.seed;
+    PutRaw(header, &version, 4);
+    PutRaw(header, &period, 4);
+    PutRaw(header, &dt, 4);
+    PutRaw(header, &w, 4);
+    PutRaw(header, &h, 4);
+    PutRaw(header, &reserved, 4);
+    PutRaw(header, &seed, 8);
+    fwrite(header.data(), 1, header.size(), file);
+    bytesWritten = (long long)header.size();
+
+    // Réservoir : toutes les images sont libres, avec la place de toutes les voitures
+    int capacity = sim.vehicles.Capacity();
+    freeFrames.clear();
+    pending.clear();
+    for (int k = 0; k < POOL_SIZE; k++) {
+        TraceFrame& f = pool[k];
+        f.handle.reserve(capacity); f.type.reserve(capacity); f.pos.reserve(capacity); f.dir.reserve(capacity);
+        f.speed.reserve(capacity); f.maxSpeed.reserve(capacity); f.emState.reserve(capacity);
+        f.isYielding.reserve(capacity);
+        f.incidents.reserve(MAX_OPEN_INCIDENTS);
+        freeFrames.push_back(k);
+    }
+    stopping = false;
+    writer = std::thread(&TraceRecorder::WriterLoop, this);
+
+    Record(sim); // État de départ : première image clé
+    return true;
+}
+
+void TraceRecorder::Close() {
+    if (!file) return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    frameReady.notify_one();
+    if (writer.joinable()) writer.join(); // Le thread d'écriture vide la file avant de s'arrêter
+    fclose(file);
+    file = nullptr;
+}
+
+void TraceRecorder::Record(const Simulation& sim) {
+    if (!file || sim.tick <= recordedTick) return;
+    recordedTick = sim.tick;
+
+    // Une image libre (on attend si le thread d'écriture a pris du retard)
+    int k;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        if (freeFrames.empty()) {
+            auto start = std::chrono::steady_clock::now();
+            frameFree.wait(guard, [&] { return !freeFrames.empty(); });
+            waitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        k = freeFrames.back();
+        freeFrames.pop_back();
+    }
+
+    pool[k].CaptureFrom(sim); // Hors du verrou : seule la simulation touche à cette image
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending.push_back(k);
+    }
+    frameReady.notify_one();
+}
+
+void TraceRecorder::WriterLoop() {
+    std::vector<uint8_t> prefix;
+    while (true) {
+        int k;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            frameReady.wait(guard, [&] { return stopping || !pending.empty(); });
+            if (pending.empty()) break; // Arrêt demandé et plus rien à écrire
+            k = pending.front();
+            pending.pop_front();
+        }
+
+        // Image clé : la première, toutes les keyframeEvery images, et après un pas manquant
+        const TraceFrame& f = pool[k];
+        if (lastTick < 0) firstTick = f.tick;
+        bool key = (lastTick < 0 || f.tick != lastTick + 1 || (f.tick - firstTick) % keyframeEvery == 0);
+        Encode(f, key);
+
+        prefix.clear();
+        prefix.push_back(key ? FRAME_KEY : FRAME_DELTA);
+        PutVarint(prefix, (uint64_t)f.tick);
+        PutVarint(prefix, bytes.size());
+        fwrite(prefix.data(), 1, prefix.size(), file);
+        fwrite(bytes.data(), 1, bytes.size(), file);
+        framesWritten++;
+        bytesWritten += (long long)(prefix.size() + bytes.size());
+        lastTick = f.tick;
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            freeFrames.push_back(k);
+        }
+        frameFree.notify_one();
+    }
+    fflush(file);
+}
+
+// Codage d'une image dans "bytes" (thread d'écriture). Image clé : chaque véhicule est écrit
+// en entier, comme chaque phase et chaque incident ouvert.
+void TraceRecorder::Encode(const TraceFrame& f, bool key) {
+    bytes.clear();
+
+    // 1. Feux : mode, puis phases (image clé : toutes ; delta : les carrefours qui changent)
+    PutVarint(bytes, (uint64_t)f.signalMode);
+    int nodes = (int)f.phases.size();
+    PutVarint(bytes, (uint64_t)nodes);
+    if (key || (int)lastPhases.size() != nodes) {
+        PutVarint(bytes, (uint64_t)nodes);
+        for (int k = 0; k < nodes; k++) { PutVarint(bytes, k == 0 ? 0 : 1); bytes.push_back((uint8_t)f.phases[k]); }
+    } else {
+        int changed = 0;
+        for (int k = 0; k < nodes; k++) changed += (f.phases[k] != lastPhases[k]);
+        PutVarint(bytes, (uint64_t)changed);
+        int previous = 0;
+        for (int k = 0; k < nodes; k++) {
+            if (f.phases[k] == lastPhases[k]) continue;
+            PutVarint(bytes, (uint64_t)(k - previous)); // Écart avec le carrefour précédent
+            bytes.push_back((uint8_t)f.phases[k]);
+            previous = k;
+        }
+    }
+    lastPhases.assign(f.phases.begin(), f.phases.end());
+
+    // 2. Véhicules, dans l'ordre du stockage : (poignée << 1 | nouveau), puis l'état complet
+    //    (nouveau) ou les écarts avec le pas précédent (déjà écrit au pas précédent)
+    int n = (int)f.handle.size();
+    PutVarint(bytes, (uint64_t)n);
+    for (int i = 0; i < n; i++) {
+        VehicleHandle h = f.handle[i];
+        if (h.index >= lastVehicle.size()) {
+            lastVehicle.resize(h.index + 1);
+            lastSeen.resize(h.index + 1, -1);
+        }
+        LastVehicle& last = lastVehicle[h.index];
+        bool known = (!key && lastSeen[h.index] == lastTick && last.generation == h.generation);
+        int32_t x = QuantizePos(f.pos[i].x), y = QuantizePos(f.pos[i].y), s = QuantizeSpeed(f.speed[i]);
+        uint8_t packed = PackState(f.dir[i], f.emState[i], f.isYielding[i] != 0, f.speed[i] < f.maxSpeed[i] * 0.8f);
+
+        PutVarint(bytes, ((uint64_t)h.index << 1) | (known ? 0 : 1));
+        if (known) {
+            PutZigzag(bytes, (int64_t)x - last.x);
+            PutZigzag(bytes, (int64_t)y - last.y);
+            PutZigzag(bytes, (int64_t)s - last.speed);
+        } else {
+            PutVarint(bytes, h.generation);
+            bytes.push_back((uint8_t)f.type[i]);
+            PutZigzag(bytes, x);
+            PutZigzag(bytes, y);
+            PutZigzag(bytes, s);
+        }
+        bytes.push_back(packed);
+        last = { h.generation, x, y, s };
+        lastSeen[h.index] = f.tick;
+    }
+
+    // 3. Incidents : comparaison des deux listes triées par numéro (ouverts, changés, fermés)
+    sorted.clear();
+    for (const Incident& inc : f.incidents) sorted.push_back(&inc);
+    std::sort(sorted.begin(), sorted.end(), [](const Incident* a, const Incident* b) { return a->id < b->id; });
+    if (key) lastIncidents.clear();
+
+    events.clear();
+    int count = 0;
+    size_t a = 0, b = 0;
+    while (a < lastIncidents.size() || b < sorted.size()) {
+        if (b == sorted.size() || (a < lastIncidents.size() && lastIncidents[a].id < sorted[b]->id)) {
+            events.push_back(EVENT_CLOSE);
+            PutVarint(events, lastIncidents[a].id);
+            count++;
+            a++;
+        } else if (a == lastIncidents.size() || sorted[b]->id < lastIncidents[a].id) {
+            const Incident& inc = *sorted[b];
+            events.push_back(EVENT_OPEN);
+            PutVarint(events, inc.id);
+            events.push_back((uint8_t)inc.type);
+            events.push_back((uint8_t)inc.state);
+            PutVarint(events, (uint64_t)std::max(0, inc.priority));
+            PutZigzag(events, QuantizePos(inc.pos.x));
+            PutZigzag(events, QuantizePos(inc.pos.y));
+            PutHandle(events, inc.unit);
+            count++;
+            b++;
+        } else {
+            const Incident& inc = *sorted[b];
+            const LastIncident& old = lastIncidents[a];
+            if (inc.state != old.state || inc.unit.index != old.unit.index || inc.unit.generation != old.unit.generation) {
+                events.push_back(EVENT_UPDATE);
+                PutVarint(events, inc.id);
+                events.push_back((uint8_t)inc.state);
+                PutHandle(events, inc.unit);
+                count++;
+            }
+            a++;
+            b++;
+        }
+    }
+    PutVarint(bytes, (uint64_t)count);
+    bytes.insert(bytes.end(), events.begin(), events.end());
+
+    lastIncidents.clear();
+    for (const Incident* inc : sorted) lastIncidents.push_back({ inc->id, inc->state, inc->unit });
+}
+
+// --- LECTEUR ---
+TraceReader::TraceReader()
+    : data(nullptr), size(0), worldW(0), worldH(0), seed(0),
+      keyframeEvery(TRACE_DEFAULT_KEYFRAME), keyframes(0), truncated(false), current(-1), signalMode(0) {}
+
+TraceReader::~TraceReader() {
+    Close();
+}
+
+void TraceReader::Close() {
+    mapped.Close();
+    data = nullptr;
+    size = 0;
+    frameOffsets.clear();
+    frameTicks.clear();
+    keyframeOf.clear();
+    current = -1;
+}
+
+bool TraceReader::Open(const char* path) {
+    Close();
+    error.clear();
+
+    // 1. Projection du fichier en mémoire : le système ne charge que les pages lues
+    if (!mapped.Open(path)) { error = mapped.Error(); return false; }
+    data = mapped.Data();
+    size = mapped.Size();
+    if (size < TRACE_HEADER_SIZE) { error = "fichier trop court"; Close(); return false; }
+
+    // 2. En-tête
+    if (memcmp(data, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) { error = "ce n'est pas une trace"; Close(); return false; }
+    uint32_t version, period;
+    float dt;
+    int32_t w, h2;
+    memcpy(&version, data + 8, 4);
+    memcpy(&period, data + 12, 4);
+    memcpy(&dt, data + 16, 4);
+    memcpy(&w, data + 20, 4);
+    memcpy(&h2, data + 24, 4);
+    memcpy(&seed, data + 32, 8);
+    if (version != TRACE_VERSION) { error = "version de trace inconnue"; Close(); return false; }
+    if (dt != SIM_DT) { error = "pas de temps different de SIM_DT"; Close(); return false; }
+    keyframeEvery = (int)period;
+    worldW = w;
+    worldH = h2;
+
+    // 3. Début de chaque image
+    if (!IndexFrames()) { Close(); return false; }
+    return true;
+}
+
+bool TraceReader::IndexFrames() {
+    keyframes = 0;
+    truncated = false;
+    int lastKey = -1;
+    size_t offset = TRACE_HEADER_SIZE;
+    while (offset < size) {
+        TraceCursor c = { data + offset, data + size, true };
+        uint8_t kind = c.Byte();
+        long long tick = (long long)c.Varint();
+        uint64_t length = c.Varint();
+        if (!c.ok || length > (uint64_t)(c.end - c.p)) { truncated = true; break; } // Dernière image incomplète
+        if (kind != FRAME_KEY && kind != FRAME_DELTA) { error = "image de genre inconnu"; return false; }
+        if (!frameTicks.empty() && tick <= frameTicks.back()) { error = "pas dans le desordre"; return false; }
+        if (kind == FRAME_KEY) { lastKey = (int)frameOffsets.size(); keyframes++; }
+        if (lastKey < 0) { error = "pas d'image cle au debut"; return false; }
+
+        frameOffsets.push_back(offset);
+        frameTicks.push_back(tick);
+        keyframeOf.push_back(lastKey);
+        offset = (size_t)(c.p - data) + (size_t)length;
+    }
+    if (frameOffsets.empty()) { error = "aucune image"; return false; }
+    return true;
+}
+
+bool TraceReader::DecodeFrame(int frame) {
+    TraceCursor c = { data + frameOffsets[frame], data + size, true };
+    bool key = (c.Byte() == FRAME_KEY);
+    c.Varint(); // Pas (déjà dans frameTicks)
+    uint64_t length = c.Varint();
+    c.end = c.p + length;
+
+    // 1. Feux
+    signalMode = (int)c.Varint();
+    uint64_t nodes = c.Varint();
+    if (nodes > (1u << 24)) return false;
+    if (key || phases.size() != nodes) phases.assign((size_t)nodes, V_GREEN);
+    uint64_t changed = c.Varint();
+    uint64_t node = 0;
+    for (uint64_t k = 0; k < changed && c.ok; k++) {
+        node += c.Varint();
+        uint8_t phase = c.Byte();
+        if (node >= nodes || phase > H_YELLOW) return false;
+        phases[node] = (LightCycle)phase;
+    }
+
+    // 2. Véhicules
+    uint64_t n = c.Varint();
+    if (n > (uint64_t)(c.end - c.p)) return false; // Au moins 2 octets par véhicule
+    vehicles.clear();
+    for (uint64_t k = 0; k < n && c.ok; k++) {
+        uint64_t entry = c.Varint();
+        uint64_t index = entry >> 1;
+        if (index >= (1u << 24)) return false;
+        if (index >= byHandle.size()) byHandle.resize((size_t)index + 1);
+        Vehicle& v = byHandle[(size_t)index];
+        if (entry & 1) {
+            v.index = (uint32_t)index;
+            v.generation = (uint32_t)c.Varint();
+            v.type = (Type)c.Byte();
+            v.x = (int32_t)c.Zigzag();
+            v.y = (int32_t)c.Zigzag();
+            v.speed = (int32_t)c.Zigzag();
+        } else {
+            if (key) return false; // Une image clé écrit tous les véhicules en entier
+            v.x += (int32_t)c.Zigzag();
+            v.y += (int32_t)c.Zigzag();
+            v.speed += (int32_t)c.Zigzag();
+        }
+        v.packed = c.Byte();
+        vehicles.push_back(v);
+    }
+
+    // 3. Incidents
+    if (key) incidents.clear();
+    uint64_t events = c.Varint();
+    for (uint64_t k = 0; k < events && c.ok; k++) {
+        uint8_t event = c.Byte();
+        uint32_t id = (uint32_t)c.Varint();
+        auto it = std::lower_bound(incidents.begin(), incidents.end(), id,
+                                   [](const Incident& inc, uint32_t v) { return inc.id < v; });
+        bool found = (it != incidents.end() && it->id == id);
+        if (event == EVENT_OPEN) {
+            Incident inc = {};
+            inc.id = id;
+            inc.type = (IncidentType)c.Byte();
+            inc.state = (IncidentState)c.Byte();
+            inc.priority = (int)c.Varint();
+            inc.pos.x = (float)c.Zigzag() / TRACE_POS_SCALE;
+            inc.pos.y = (float)c.Zigzag() / TRACE_POS_SCALE;
+            inc.unit = GetHandle(c);
+            inc.reportedTick = inc.dispatchedTick = inc.arrivedTick = -1;
+            if (found || inc.type >= INCIDENT_TYPE_COUNT) return false;
+            incidents.insert(it, inc);
+        } else if (event == EVENT_UPDATE) {
+            IncidentState state = (IncidentState)c.Byte();
+            VehicleHandle unit = GetHandle(c);
+            if (!found) return false;
+            it->state = state;
+            it->unit = unit;
+        } else if (event == EVENT_CLOSE) {
+            if (!found) return false;
+            incidents.erase(it);
+        } else {
+            return false;
+        }
+    }
+    return c.ok;
+}
+
+bool TraceReader::Seek(long long tick, SimSnapshot& snap) {
+    if (frameOffsets.empty()) return false;
+    // Dernière image dont le pas est <= tick
+    int frame = (int)(std::upper_bound(frameTicks.begin(), frameTicks.end(), tick) - frameTicks.begin()) - 1;
+    if (frame < 0) frame = 0;
+
+    if (frame != current) {
+        // En avançant sans passer d'image clé, on continue d'où on est ; sinon, depuis l'image clé
+        int start = keyframeOf[frame];
+        if (current >= 0 && current < frame && start <= current) start = current + 1;
+        for (int k = start; k <= frame; k++) {
+            if (!DecodeFrame(k)) {
+                current = -1;
+                error = "image abimee";
+                return false;
+            }
+        }
+        current = frame;
+    }
+    Fill(snap);
+    return true;
+}
+
+// Photo pour l'affichage : mêmes champs que SimSnapshot::CaptureFrom, sans les statistiques
+void TraceReader::Fill(SimSnapshot& snap) {
+    snap.tick = frameTicks[current];
+    snap.signalMode = (SignalMode)signalMode;
+    snap.phases.assign(phases.begin(), phases.end());
+    snap.averageDelay = 0;
+    snap.profile = ProfileSummary();
+
+    int n = (int)vehicles.size();
+    snap.pos.resize(n);
+    snap.prevPos.resize(n);
+    snap.dir.resize(n);
+    snap.type.resize(n);
+    snap.emState.resize(n);
+    snap.active.assign(n, 1);
+    snap.isYielding.resize(n);
+    snap.isBraking.resize(n);
+    slotOfHandle.assign(byHandle.size(), -1);
+    for (int i = 0; i < n; i++) {
+        const Vehicle& v = vehicles[i];
+        snap.pos[i] = { v.x / TRACE_POS_SCALE, v.y / TRACE_POS_SCALE };
+        snap.prevPos[i] = snap.pos[i];
+        snap.dir[i] = (Dir)(v.packed & 7);
+        snap.type[i] = v.type;
+        snap.emState[i] = (EmergencyState)((v.packed >> 3) & 7);
+        snap.isYielding[i] = (v.packed & 0x40) ? 1 : 0;
+        snap.isBraking[i] = (v.packed & 0x80) ? 1 : 0;
+        slotOfHandle[v.index] = i;
+    }
+
+    snap.incidents.clear();
+    snap.waitingIncidents = 0;
+    for (const Incident& inc : incidents) {
+        int slot = -1;
+        if (inc.unit.index < slotOfHandle.size()) {
+            slot = slotOfHandle[inc.unit.index];
+            if (slot >= 0 && vehicles[slot].generation != inc.unit.generation) slot = -1;
+        }
+        snap.incidents.push_back({ inc.type, inc.state, inc.priority, inc.pos, slot });
+        if (inc.state == INCIDENT_WAITING) snap.waitingIncidents++;
+    }
+}
+
+// --- EMPREINTE ---
+static void HashValue(uint64_t& h, uint64_t v) {
+    for (int k = 0; k < 8; k++) { h ^= (v >> (8 * k)) & 0xFF; h *= 1099511628211ull; }
+}
+
+uint64_t TraceChecksum(const SimSnapshot& snap) {
+    uint64_t h = 14695981039346656037ull;
+    HashValue(h, (uint64_t)snap.tick);
+    HashValue(h, (uint64_t)snap.signalMode);
+    for (LightCycle p : snap.phases) HashValue(h, (uint64_t)p);
+    int n = snap.Size();
+    HashValue(h, (uint64_t)n);
+    for (int i = 0; i < n; i++) {
+        HashValue(h, (uint32_t)QuantizePos(snap.pos[i].x));
+        HashValue(h, (uint32_t)QuantizePos(snap.pos[i].y));
+        HashValue(h, PackState(snap.dir[i], snap.emState[i], snap.isYielding[i] != 0, snap.isBraking[i] != 0));
+        HashValue(h, (uint64_t)snap.type[i]);
+    }
+    // Incidents : la trace les range par numéro, la simulation par case de la table.
+    // Somme des empreintes de chacun : l'ordre ne compte pas.
+    uint64_t incidents = 0;
+    for (const SimSnapshot::IncidentView& inc : snap.incidents) {
+        uint64_t e = 14695981039346656037ull;
+        HashValue(e, inc.type);
+        HashValue(e, inc.state);
+        HashValue(e, (uint64_t)inc.priority);
+        HashValue(e, (uint32_t)QuantizePos(inc.pos.x));
+        HashValue(e, (uint32_t)QuantizePos(inc.pos.y));
+        HashValue(e, (uint64_t)(int64_t)inc.unitSlot);
+        incidents += e;
+    }
+    HashValue(h, incidents);
+    return h;
+}
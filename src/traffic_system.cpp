@@ -1,55 +1,238 @@
 /**
  * SYSTÈME DE TRAFIC
- * Ce fichier gère les variables d'urgence et l'affichage des feux aux carrefours.
+ * Ce fichier gère les règles des feux tricolores aux carrefours :
+ * cycle fixe, feux adaptatifs et onde verte, avec la mesure des attentes.
+ * (L'affichage des feux se trouve dans render.cpp)
  */
 
 #include "../include/traffic_system.h"
+#include "../include/state_file.h"
+#include "../include/road_graph.h"
+#include "../include/vehicle_store.h"
+#include "../include/world.h"
+#include <algorithm>
 
-// --- VARIABLES D'URGENCE ---
-// Ces variables servent à dire au jeu si une catastrophe est en cours.
-
-bool fireActive = false;       // Est-ce qu'il y a un incendie ? (Faux au début)
-Vector2 firePos = { 0, 0 };    // Position exacte du feu sur la carte
-
-bool accidentActive = false;   // Est-ce qu'il y a un accident ? (Faux au début)
-Vector2 accidentPos = { 0, 0 };// Position exacte de l'accident
-
-// --- AFFICHAGE DES FEUX ---
-// Cette fonction dessine les 4 feux à un croisement donné (x, y)
-void DrawIntersectionLights(float x, float y, LightCycle cycle, bool isNight) {
-    // Par défaut, on met tout le monde au ROUGE (sécurité)
-    Color vColor = RED; // Couleur des feux Verticaux (Haut/Bas)
-    Color hColor = RED; // Couleur des feux Horizontaux (Gauche/Droite)
-    
-    // On change les couleurs selon le tour (Cycle)
-    if (cycle == V_GREEN) { 
-        vColor = GREEN; hColor = RED; // Vertical passe
-    }
-    else if (cycle == V_YELLOW) { 
-        vColor = ORANGE; hColor = RED; // Vertical ralentit
-    }
-    else if (cycle == H_GREEN) { 
-        vColor = RED; hColor = GREEN; // Horizontal passe
-    }
-    else if (cycle == H_YELLOW) { 
-        vColor = RED; hColor = ORANGE; // Horizontal ralentit
-    }
-
-    // Calcul de la position : On décale les feux pour qu'ils soient au coin de la route
-    float off = ROAD_WIDTH / 2.0f + 5.0f; 
-
-    // On dessine les 4 ampoules physiques (cercles pleins)
-    DrawCircle(x + off, y - off, 6, vColor);
-    DrawCircle(x - off, y + off, 6, vColor);
-    DrawCircle(x - off, y - off, 6, hColor);
-    DrawCircle(x + off, y + off, 6, hColor);
-    
-    // Si c'est la Nuit, on ajoute un effet visuel (Halo lumineux)
-    if (isNight) {
-        // On dessine un cercle flou et transparent autour de la lampe pour faire "briller"
-        DrawCircleGradient(x + off, y - off, 15, Fade(vColor, 0.5f), Fade(vColor, 0.0f));
-        DrawCircleGradient(x - off, y + off, 15, Fade(vColor, 0.5f), Fade(vColor, 0.0f));
-        DrawCircleGradient(x - off, y - off, 15, Fade(hColor, 0.5f), Fade(hColor, 0.0f));
-        DrawCircleGradient(x + off, y + off, 15, Fade(hColor, 0.5f), Fade(hColor, 0.0f));
-    }
-}
\ No newline at end of file
+// --- CYCLE DES FEUX ---
+// L'ordre est toujours le même : chaque sens a son vert puis son jaune.
+LightCycle NextLightCycle(LightCycle cycle) {
+    if (cycle == V_GREEN) return V_YELLOW;
+    if (cycle == V_YELLOW) return H_GREEN;
+    if (cycle == H_GREEN) return H_YELLOW;
+    return V_GREEN; // Après H_YELLOW on revient au début
+}
+
+// --- CONTRÔLEURS DES CARREFOURS ---
+
+SignalSystem::SignalSystem() : mode(SIGNAL_FIXED), clock(0), totalDelay(0), totalArrivals(0) {}
+
+void SignalSystem::Reset(const RoadGraph& graph) {
+    int n = graph.NodeCount();
+    clock = 0;
+    phase.assign(n, V_GREEN);
+    phaseStart.assign(n, 0.0);
+    demand[0].assign(n, 0); demand[1].assign(n, 0);
+    queue[0].assign(n, 0); queue[1].assign(n, 0);
+    touched.clear();
+    yellow.clear();
+
+    // Onde verte : le vert arrive à chaque carrefour en même temps qu'une voiture partie
+    // du premier carrefour à WAVE_SPEED, vers la droite (routes horizontales)
+    // comme vers le bas (routes verticales)
+    offset.resize(n);
+    Vector2 first = (n > 0) ? graph.NodePos(0) : Vector2{ 0, 0 };
+    for (int k = 0; k < n; k++) {
+        Vector2 p = graph.NodePos(k);
+        offset[k] = ((p.x - first.x) + (p.y - first.y)) / WAVE_SPEED;
+    }
+
+    delay.assign(n, 0.0);
+    arrivals.assign(n, 0);
+    totalDelay = 0;
+    totalArrivals = 0;
+}
+
+void SignalSystem::ResetStats() {
+    std::fill(delay.begin(), delay.end(), 0.0);
+    std::fill(arrivals.begin(), arrivals.end(), 0);
+    totalDelay = 0;
+    totalArrivals = 0;
+}
+
+void SignalSystem::SetMode(SignalMode newMode) {
+    if (newMode == mode) return;
+    // Le mode adaptatif repart de ce que montrent les feux maintenant (pas de saut à l'écran)
+    if (newMode == SIGNAL_ACTUATED) {
+        yellow.clear();
+        for (int k = 0; k < (int)phase.size(); k++) {
+            phase[k] = PhaseAt(k);
+            phaseStart[k] = clock;
+            if (phase[k] == V_YELLOW || phase[k] == H_YELLOW) yellow.push_back(k);
+        }
+    }
+    mode = newMode;
+}
+
+LightCycle SignalSystem::PhaseAt(int node) const {
+    if (node < 0 || node >= (int)phase.size()) return V_GREEN;
+    if (mode == SIGNAL_ACTUATED) return phase[node];
+    if (mode == SIGNAL_FIXED) {
+        // Même ordre que NextLightCycle : V_GREEN, V_YELLOW, H_GREEN, H_YELLOW
+        long long k = (long long)(clock / LIGHT_PHASE_DURATION);
+        return (LightCycle)(k % 4);
+    }
+    // Onde verte : vert horizontal, jaune, vert vertical, jaune, décalés de offset[node]
+    double cycle = 2.0 * (WAVE_GREEN + SIGNAL_YELLOW);
+    double local = fmod(clock - offset[node], cycle);
+    if (local < 0) local += cycle;
+    if (local < WAVE_GREEN) return H_GREEN;
+    if (local < WAVE_GREEN + SIGNAL_YELLOW) return H_YELLOW;
+    if (local < 2 * WAVE_GREEN + SIGNAL_YELLOW) return V_GREEN;
+    return V_YELLOW;
+}
+
+void SignalSystem::FillPhases(std::vector<LightCycle>& phases) const {
+    int n = (int)phase.size();
+    phases.resize(n);
+    for (int k = 0; k < n; k++) phases[k] = PhaseAt(k);
+}
+
+double SignalSystem::AverageDelay(int node) const {
+    return arrivals[node] ? delay[node] / arrivals[node] : 0.0;
+}
+
+double SignalSystem::AverageDelay() const {
+    return totalArrivals ? totalDelay / totalArrivals : 0.0;
+}
+
+// Carrefour vers lequel on roule (le prochain devant soi) et distance jusqu'à son centre.
+// -1 si on a dépassé le dernier carrefour de la route.
+static int ApproachedNode(const RoadGraph& graph, Vector2 p, Dir d, float& dist) {
+    int col, row;
+    if (d == UP || d == DOWN) {
+        col = vRoadIndex.Nearest(p.x);
+        int before = hRoadIndex.Segment(p.y); // Routes horizontales au-dessus (ou à la hauteur) de p
+        row = (d == DOWN) ? before : before - 1;
+    } else if (d == LEFT || d == RIGHT) {
+        row = hRoadIndex.Nearest(p.y);
+        int before = vRoadIndex.Segment(p.x);
+        col = (d == RIGHT) ? before : before - 1;
+    } else {
+        return -1;
+    }
+    if (col < 0 || row < 0 || col >= graph.Cols() || row >= graph.Rows()) return -1;
+    int node = graph.NodeAt(col, row);
+    Vector2 c = graph.NodePos(node);
+    dist = (d == UP || d == DOWN) ? fabsf(p.y - c.y) : fabsf(p.x - c.x);
+    return node;
+}
+
+void SignalSystem::Update(float dt, VehicleStore& v, const RoadGraph& graph) {
+    if ((int)phase.size() != graph.NodeCount()) Reset(graph); // La carte a changé
+    clock += dt;
+    bool actuated = (mode == SIGNAL_ACTUATED);
+
+    // 1. Mesures : chaque civil est compté au carrefour vers lequel il roule
+    int n = v.Size();
+    for (int i = 0; i < n; i++) {
+        if (!v.active[i] || v.type[i] != CIVIL) { v.signalNode[i] = -1; continue; }
+        float dist = 0;
+        int node = ApproachedNode(graph, v.pos[i], v.dir[i], dist);
+        // Nouvelle arrivée : la voiture vient de s'engager vers ce carrefour
+        if (node != v.signalNode[i]) {
+            v.signalNode[i] = node;
+            if (node >= 0) { arrivals[node]++; totalArrivals++; }
+        }
+        if (node < 0) continue;
+
+        bool stopped = v.speed[i] < STOPPED_SPEED;
+        if (stopped) { delay[node] += dt; totalDelay += dt; } // Attente (feu rouge, bouchon...)
+
+        // Zone de détection du contrôleur adaptatif
+        if (actuated && dist <= DETECTOR_RANGE) {
+            int axis = (v.dir[i] == UP || v.dir[i] == DOWN) ? 0 : 1;
+            if (demand[0][node] == 0 && demand[1][node] == 0) touched.push_back(node);
+            demand[axis][node]++;
+            if (stopped) queue[axis][node]++;
+        }
+    }
+    if (!actuated) return; // Les autres modes ne dépendent que de l'heure
+
+    // 2. Carrefours au jaune : passage au vert de l'autre sens après le dégagement
+    size_t kept = 0;
+    for (size_t k = 0; k < yellow.size(); k++) {
+        int node = yellow[k];
+        if (clock - phaseStart[node] >= SIGNAL_YELLOW) {
+            phase[node] = NextLightCycle(phase[node]);
+            phaseStart[node] = clock;
+        } else {
+            yellow[kept++] = node;
+        }
+    }
+    yellow.resize(kept);
+
+    // 3. Carrefours avec de la demande : on prolonge ou on écourte le vert
+    for (int node : touched) {
+        UpdateActuated(node);
+        demand[0][node] = demand[1][node] = 0;
+        queue[0][node] = queue[1][node] = 0;
+    }
+    touched.clear();
+}
+
+void SignalSystem::UpdateActuated(int node) {
+    LightCycle p = phase[node];
+    if (p != V_GREEN && p != H_GREEN) return; // Au jaune : géré par la liste "yellow"
+
+    double green = clock - phaseStart[node];
+    if (green < ACTUATED_MIN_GREEN) return;
+
+    int g = (p == V_GREEN) ? 0 : 1; // Sens au vert
+    int c = 1 - g;                  // Sens au rouge
+    if (queue[c][node] == 0) return; // Personne n'attend en face : on reste au vert
+
+    // On coupe le vert si : plus personne n'arrive de notre côté, la file d'en face est
+    // bien plus longue que notre demande, ou le vert a duré le maximum
+    bool gapOut = (demand[g][node] == 0);
+    bool outweighed = (queue[c][node] >= 2 * demand[g][node]);
+    bool maxedOut = (green >= ACTUATED_MAX_GREEN);
+    if (gapOut || outweighed || maxedOut) {
+        phase[node] = NextLightCycle(p); // Vert -> Jaune
+        phaseStart[node] = clock;
+        yellow.push_back(node);
+    }
+}
+
+// --- SAUVEGARDE ---
+void SignalSystem::Save(StateWriter& out) const {
+    out.Section("SIGN");
+    out.Value(mode);
+    out.Value(clock);
+    out.Vector(phase);
+    out.Vector(phaseStart);
+    for (int k = 0; k < 2; k++) { out.Vector(demand[k]); out.Vector(queue[k]); }
+    out.Vector(touched);
+    out.Vector(yellow);
+    out.Vector(offset);
+    out.Vector(delay);
+    out.Vector(arrivals);
+    out.Value(totalDelay);
+    out.Value(totalArrivals);
+}
+
+bool SignalSystem::Load(StateReader& in) {
+    in.Section("SIGN");
+    in.Value(mode);
+    in.Value(clock);
+    in.Vector(phase);
+    in.Vector(phaseStart);
+    for (int k = 0; k < 2; k++) { in.Vector(demand[k]); in.Vector(queue[k]); }
+    in.Vector(touched);
+    in.Vector(yellow);
+    in.Vector(offset);
+    in.Vector(delay);
+    in.Vector(arrivals);
+    in.Value(totalDelay);
+    in.Value(totalArrivals);
+    if (in.Ok() && (phaseStart.size() != phase.size() || arrivals.size() != phase.size())) return in.Fail("feux incoherents");
+    return in.Ok();
+}
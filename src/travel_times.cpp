@@ -0,0 +1,109 @@
+/**
+ * TEMPS DE PARCOURS (EMBOUTEILLAGES)
+ * Estimation lissée du temps de traversée de chaque tronçon,
+ * mesurée sur les voitures qui y roulent réellement.
+ */
+
+#include "../include/travel_times.h"
+#include "../include/road_graph.h"
+#include "../include/vehicle_store.h"
+#include "../include/state_file.h"
+#include "../include/world.h"
+#include <algorithm>
+
+TravelTimes::TravelTimes() : round(0), changedCount(0) {}
+
+void TravelTimes::Reset(const RoadGraph& graph) {
+    int edges = (int)graph.edgeTo.size();
+    freeTime.resize(edges);
+    for (int e = 0; e < edges; e++) freeTime[e] = graph.edgeLength[e] / FREE_SPEED;
+    smoothed = freeTime;
+    announced = freeTime;
+    flowSum.assign(edges, 0.0f);
+    flowCount.assign(edges, 0);
+    changedRound.assign(edges, 0);
+    activeEdges.clear();
+    isActive.assign(edges, 0);
+    round = 0;
+    changedCount = 0;
+}
+
+bool TravelTimes::Sample(const VehicleStore& v, const RoadGraph& graph) {
+    if (smoothed.size() != graph.edgeTo.size()) Reset(graph); // La carte a changé
+
+    // 1. Fluidité des tronçons où roulent des voitures : vitesse comparée à leur vitesse max
+    for (int i = 0; i < v.Size(); i++) {
+        if (!v.active[i] || v.type[i] != CIVIL) continue; // Les secours doublent tout le monde
+        int e = graph.EdgeAt(v.pos[i], v.dir[i]);
+        if (e < 0) continue;
+        // Vitesse possible ici : celle de la voiture, ou la limite de la route si elle est plus basse
+        float cap = v.maxSpeed[i];
+        float limit = RoadSpeedLimit(LocateOnRoads(v.pos[i], 0.0f), v.dir[i]);
+        if (limit > 0 && limit < cap) cap = limit;
+        flowSum[e] += std::min(v.speed[i] / cap, 1.0f);
+        flowCount[e]++;
+        if (!isActive[e]) { isActive[e] = 1; activeEdges.push_back(e); }
+    }
+
+    // 2. Moyenne exponentielle du temps de traversée (rue vide si personne n'y roule)
+    round++;
+    changedCount = 0;
+    size_t kept = 0;
+    for (size_t k = 0; k < activeEdges.size(); k++) {
+        int e = activeEdges[k];
+        float flow = flowCount[e] ? flowSum[e] / flowCount[e] : 1.0f;
+        // Rue vide : temps à vide. Rue bouchée (fluidité MIN_FLOW) : jusqu'à 1 + 9 x CONGESTION_WEIGHT fois plus long
+        float measured = freeTime[e] * (1.0f + CONGESTION_WEIGHT * (1.0f / std::max(flow, MIN_FLOW) - 1.0f));
+        smoothed[e] += SMOOTHING * (measured - smoothed[e]);
+
+        // 3. Changement important depuis la dernière annonce ?
+        if (fabs(smoothed[e] - announced[e]) > CHANGE_THRESHOLD * announced[e]) {
+            announced[e] = smoothed[e];
+            changedRound[e] = round;
+            changedCount++;
+        }
+
+        // 4. Rue vide revenue au calme : on la retire de la liste jusqu'à la prochaine voiture
+        bool settled = flowCount[e] == 0 && fabs(smoothed[e] - freeTime[e]) < SETTLED * freeTime[e];
+        flowSum[e] = 0.0f;
+        flowCount[e] = 0;
+        if (settled) { smoothed[e] = freeTime[e]; isActive[e] = 0; }
+        else activeEdges[kept++] = e;
+    }
+    activeEdges.resize(kept);
+    return changedCount > 0;
+}
+
+// --- SAUVEGARDE ---
+void TravelTimes::Save(StateWriter& out) const {
+    out.Section("TRAV");
+    out.Vector(freeTime);
+    out.Vector(smoothed);
+    out.Vector(announced);
+    out.Vector(flowSum);
+    out.Vector(flowCount);
+    out.Vector(changedRound);
+    out.Vector(activeEdges);
+    out.Vector(isActive);
+    out.Value(round);
+    out.Value(changedCount);
+}
+
+bool TravelTimes::Load(StateReader& in) {
+    in.Section("TRAV");
+    in.Vector(freeTime);
+    in.Vector(smoothed);
+    in.Vector(announced);
+    in.Vector(flowSum);
+    in.Vector(flowCount);
+    in.Vector(changedRound);
+    in.Vector(activeEdges);
+    in.Vector(isActive);
+    in.Value(round);
+    in.Value(changedCount);
+    size_t edges = freeTime.size();
+    if (in.Ok() && (smoothed.size() != edges || isActive.size() != edges || changedRound.size() != edges)) {
+        return in.Fail("temps de parcours incoherents");
+    }
+    return in.Ok();
+}
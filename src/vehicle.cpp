@@ -1,105 +1,87 @@
 /**
  * VÉHICULE (LOGIQUE ET INTELLIGENCE ARTIFICIELLE)
- * Ce fichier gère tout : le mouvement, les collisions, les missions de secours,
- * les feux rouges et le dessin des voitures.
+ * Ce fichier gère tout : le mouvement, les collisions, les missions de secours
+ * et les feux rouges. (Le dessin des voitures est dans render.cpp)
  */
 
 #include "../include/vehicle.h"
 #include "../include/world.h"
-#include "../include/traffic_system.h"
+#include "../include/simulation.h"
+#include "../include/road_graph.h"
+#include "../include/emergency.h"
+#include "../include/motion_kernels.h"
+#include <algorithm>
 
-// --- CONSTRUCTEUR ---
+// --- APPARITION D'UN SECOURS ---
+// Le véhicule apparaît DANS son bâtiment et sort devant le garage.
+// Sa mission éventuelle lui est donnée ensuite par le répartiteur (emergency.cpp).
+int SpawnUnit(Simulation& sim, const Building& station) {
+    VehicleStore& v = sim.vehicles;
+    int i = v.Add(station.type);
+    if (i < 0) return -1;     // Plus de place dans le stockage
+    v.homeCenter[i] = station.center;      // Centre du bâtiment
+    v.homeEntry[i] = station.entryPoint;   // Sortie du garage
+    v.pos[i] = station.center;             // On place la voiture DANS le bâtiment
+    v.prevPos[i] = station.center;         // (pas de glissement depuis ailleurs à l'affichage)
+    v.target[i] = station.entryPoint;      // Sans mission, elle sort juste devant
+    v.hasTarget[i] = 1;
+    v.dispatchTick[i] = sim.tick; // Début du chrono du temps de réponse
+    v.emState[i] = DEPLOYING; // État "Sortie du garage"
+    v.dir[i] = DOWN; // Par défaut vers le bas pour sortir
+    return i;
+}
+
+// --- APPARITION ---
 // C'est ici qu'une voiture naît.
 // Si c'est une voiture de SECOURS, elle apparaît dans son garage.
-// Si c'est une voiture CIVILE, elle apparaît au hasard au bord de l'écran.
-Car::Car(Type t, const std::vector<Car*>& existingCars) {
-    type = t;
-    active = true;
-    stuckTimer = 0;
-    turnCooldown = 0;
-    actionTimer = 0;
-    isYielding = false; // Par défaut, on ne se gare pas sur le côté
-    
-    // Vitesse : Les secours vont beaucoup plus vite que les civils
-    maxSpeed = (type == CIVIL) ? 1.4f : 4.0f; 
-    
-    speed = maxSpeed;
-    hasTarget = false;
-    emState = IDLE; // État "Au repos"
-    
+// Si c'est une voiture CIVILE, elle apparaît au hasard au bord de la ville (ou dedans).
+int SpawnVehicle(Simulation& sim, Type t) {
+    VehicleStore& v = sim.vehicles;
+
     // --- LOGIQUE D'APPARITION DES SECOURS ---
-    if (type != CIVIL) {
-        bool found = false;
+    if (t != CIVIL) {
         // On cherche le bâtiment qui correspond au véhicule (ex: Camion Pompier -> Caserne)
         for (const auto& b : buildings) {
-            if (b.type == type) { 
-                homeCenter = b.center;      // Centre du bâtiment
-                homeEntry = b.entryPoint;   // Sortie du garage
-                pos = homeCenter;           // On place la voiture DANS le bâtiment
-                
-                // Si une urgence est déjà en cours, on lui donne l'ordre d'y aller direct
-                if (type == FIRE && fireActive) target = firePos;
-                else if (type == AMBULANCE && accidentActive) target = accidentPos; 
-                else target = homeEntry;    // Sinon, elle sort juste devant
-                
-                hasTarget = true; 
-                emState = DEPLOYING; // État "Sortie du garage"
-                found = true;
-                break; 
-            }
+            if (b.type == t) return SpawnUnit(sim, b);
         }
         // Si on n'a pas trouvé de bâtiment pour ce véhicule, on annule la création
-        if(!found) { active = false; return; }
-        dir = DOWN; // Par défaut vers le bas pour sortir
+        return -1;
     } 
-    // --- LOGIQUE D'APPARITION DES CIVILS ---
-    else {
-        bool spawned = false;
-        // On essaie 15 fois de trouver une place libre pour ne pas apparaître SUR une autre voiture
-        for(int attempt=0; attempt<15; attempt++){ 
-            // 50% de chance d'apparaître sur une route Verticale (Haut/Bas)
-            if (GetRandomValue(0, 1) == 0 && !vRoads.empty()) { 
-                int r = GetRandomValue(0, vRoads.size() - 1); // Choix de la route au hasard
-                dir = (GetRandomValue(0, 1) == 0) ? DOWN : UP; // Sens de circulation
-                // Calcul de la position X et Y (hors de l'écran)
-                pos = { vRoads[r] + ((dir==DOWN)?LANE_NORMAL:-LANE_NORMAL), (dir==DOWN)? -90.0f : (float)GetScreenHeight() + 90 }; 
-            } 
-            // 50% de chance d'apparaître sur une route Horizontale (Gauche/Droite)
-            else if (!hRoads.empty()) { 
-                int r = GetRandomValue(0, hRoads.size() - 1);
-                dir = (GetRandomValue(0, 1) == 0) ? RIGHT : LEFT;
-                pos = { (dir==RIGHT)? -90.0f : (float)GetScreenWidth() + 90, hRoads[r] + ((dir==RIGHT)?LANE_NORMAL:-LANE_NORMAL) }; 
-            }
-
-            // On vérifie si la place est libre
-            Rectangle myRect = GetRectInternal(pos, dir);
-            // On élargit un peu la zone de vérification pour laisser de l'espace
-            myRect.x -= 70; myRect.y -= 70; myRect.width += 140; myRect.height += 140;
 
-            bool collision = false;
-            for(auto c : existingCars) {
-                if(CheckCollisionRecs(myRect, c->GetRect())) { collision = true; break; }
-            }
-            // Si pas de collision, c'est bon, on valide !
-            if(!collision) { spawned = true; break; }
-        }
-        // Si après 15 essais on n'a pas trouvé de place, la voiture n'est pas créée
-        if(!spawned) active = false;
-    }
+    // --- LOGIQUE D'APPARITION DES CIVILS ---
+    // Départ depuis une entrée au bord de la ville (juste dehors), ou depuis l'intérieur
+    // du réseau (grande ville). Tout est en coordonnées du monde : la fenêtre n'y est pour rien.
+    // L'index des places (spawn_index.h) donne directement une voie libre : pas d'essais
+    // au hasard contre toutes les voitures.
+    bool interior = sim.interiorSpawnShare > 0 && sim.spawnRng.Range(0, 999) < (int)(sim.interiorSpawnShare * 1000);
+    int place = sim.spawnPlaces.Take(v, sim.tick, interior, sim.spawnRng);
+    // Plus de place de ce genre : on essaie l'autre (l'intérieur seulement si la ville l'autorise)
+    if (place < 0 && (interior || sim.interiorSpawnShare > 0)) place = sim.spawnPlaces.Take(v, sim.tick, !interior, sim.spawnRng);
+    if (place < 0) return -1; // Toutes les voies d'apparition sont occupées
+    const SpawnIndex::Place& spot = sim.spawnPlaces.At(place);
+    return PlaceVehicle(sim, CIVIL, spot.pos, spot.dir);
 }
 
-// Renvoie le rectangle physique de la voiture
-Rectangle Car::GetRect() const { return GetRectInternal(pos, dir); }
+// Apparition directe : la voiture est posée exactement où on veut
+int PlaceVehicle(Simulation& sim, Type t, Vector2 p, Dir d) {
+    VehicleStore& v = sim.vehicles;
+    int i = v.Add(t);
+    if (i < 0) return -1;
+    v.pos[i] = p;
+    v.prevPos[i] = p;
+    v.dir[i] = d;
+    return i;
+}
 
-// Calcul interne de la taille de la voiture (plus longue que large) selon la direction
-Rectangle Car::GetRectInternal(Vector2 p, Dir d) {
+// Calcul de la taille de la voiture (plus longue que large) selon la direction
+Rectangle GetCarRect(Vector2 p, Dir d) {
     if (d == UP || d == DOWN) return { p.x - 8, p.y - 13, 16, 26 }; 
     return { p.x - 13, p.y - 8, 26, 16 };
 }
 
 // --- CAPTEUR (LES YEUX) ---
 // Crée une zone invisible devant la voiture pour détecter les obstacles
-Rectangle Car::GetSensor() const {
+Rectangle GetCarSensor(Vector2 pos, Dir dir, float speed, Type type) {
     // Plus on va vite, plus on regarde loin devant (distance de freinage)
     float lookAhead = 70.0f + (speed * 25.0f); 
     float width = (type != CIVIL) ? 8.0f : 14.0f; // Largeur du capteur
@@ -112,43 +94,110 @@ Rectangle Car::GetSensor() const {
     return {0,0,0,0};
 }
 
-// --- CERVEAU PRINCIPAL (UPDATE) ---
-// Exécuté à chaque image (60 fois par seconde)
-void Car::Update(LightCycle cycle, const std::vector<Car*>& cars, bool isNight) {
+// Temps de réponse : du départ de la base jusqu'à l'arrivée sur l'incident
+static void RecordArrival(Simulation& sim, int i) {
+    sim.arrivals++;
+    sim.arrivalTicks += sim.tick - sim.vehicles.dispatchTick[i];
+}
+
+// --- SUIVI D'ITINÉRAIRE ---
+// Au carrefour "node", donne la direction du prochain carrefour de l'itinéraire.
+// Au dernier carrefour, on part vers la destination par l'axe où elle est la plus éloignée.
+// Renvoie false si la voiture n'est pas sur son itinéraire (il sera recalculé au pas suivant).
+static bool FollowRoute(VehicleStore& v, int i, int node, Vector2 target, Dir& newDir) {
+    const std::vector<int>& route = v.route[i];
+    int& step = v.routeStep[i];
+    int size = (int)route.size();
+
+    // On vient d'atteindre le prochain carrefour : on passe au suivant
+    if (step < size && route[step] == node) step++;
+    // Sinon, on doit encore être sur le carrefour qu'on vient de valider
+    else if (step == 0 || route[step - 1] != node) { v.hasRoute[i] = 0; return false; }
+
+    if (step < size) { newDir = roadGraph.DirectionTo(node, route[step]); return true; }
+
+    // Dernier carrefour : derniers mètres vers la destination
+    Vector2 here = roadGraph.NodePos(node);
+    float tDx = target.x - here.x; float tDy = target.y - here.y;
+    if (fabs(tDx) >= fabs(tDy)) newDir = (tDx > 0) ? RIGHT : LEFT;
+    else newDir = (tDy > 0) ? DOWN : UP;
+    return true;
+}
+
+// --- IMPASSES ---
+// La sortie voulue mène à un tronçon fermé : première sortie ouverte parmi tout droit,
+// à droite ou à gauche, puis demi-tour (toujours le même ordre : même partie à chaque fois)
+static Dir OpenExit(int node, Dir wanted, Dir current) {
+    bool vertical = (current == UP || current == DOWN);
+    Dir back = (current == UP) ? DOWN : (current == DOWN) ? UP : (current == LEFT) ? RIGHT : LEFT;
+    const Dir order[] = { current, vertical ? RIGHT : DOWN, vertical ? LEFT : UP, back };
+    for (Dir d : order) {
+        if (d != wanted && roadGraph.IsOpen(node, d)) return d;
+    }
+    return wanted; // Carrefour coupé de tout : on continue quand même
+}
+
+// --- CERVEAU PRINCIPAL (DÉCISION) ---
+// Exécuté à chaque pas de simulation (dt = temps écoulé depuis le dernier pas).
+// Décide de tout (mission, virage, vitesse voulue, voie) ; le mouvement lui-même est fait
+// ensuite par MoveVehicles, sur des paquets de voitures à la fois.
+void PlanVehicle(Simulation& sim, int i, float dt, CarCounters& counters) {
+    VehicleStore& v = sim.vehicles;
+    sim.planFlags[i] = MOTION_SKIP; // Tant que la décision n'est pas allée au bout : on ne bouge pas
+
+    // Raccourcis vers les données de CETTE voiture (case i de chaque tableau)
+    const Type type = v.type[i];
+    Vector2& pos = v.pos[i];
+    Dir& dir = v.dir[i];
+    float& speed = v.speed[i];
+    const float maxSpeed = v.maxSpeed[i];
+    uint8_t& active = v.active[i];
+    Vector2& target = v.target[i];
+    const bool hasTarget = v.hasTarget[i];
+    float& turnCooldown = v.turnCooldown[i];
+    float& actionTimer = v.actionTimer[i];
+    EmergencyState& emState = v.emState[i];
+    const Vector2 homeCenter = v.homeCenter[i];
+    const Vector2 homeEntry = v.homeEntry[i];
+    uint8_t& isYielding = v.isYielding[i];
+
     if (!active) return; // Si la voiture est désactivée, on ne fait rien
-    float dt = GetFrameTime(); // Temps écoulé depuis la dernière image
+
+    // Ce que cette voiture voit des AUTRES voitures. En mode double tampon, c'est la copie
+    // figée du début du pas : le résultat ne dépend pas de l'ordre de mise à jour.
+    const Vector2* otherPos = sim.doubleBuffered ? sim.frontPos.data() : v.pos.data();
+    const Dir* otherDir = sim.doubleBuffered ? sim.frontDir.data() : v.dir.data();
+    const uint8_t* otherActive = sim.doubleBuffered ? sim.frontActive.data() : v.active.data();
     if (turnCooldown > 0) turnCooldown -= dt; // On réduit le chrono de virage
     
-    // --- GESTION DES MISSIONS (POMPIERS) ---
-    if (type == FIRE) {
-            // Si on est en route vers le feu
-            if (emState == ON_MISSION) {
-                if (!fireActive) { emState = RETURNING; target = homeEntry; } // Fausse alerte, on rentre
-                else if (Vector2Distance(pos, firePos) < 70.0f) emState = EXTINGUISHING; // Arrivé ! On éteint.
+    // --- GESTION DES MISSIONS (TOUS LES SECOURS) ---
+    // Chaque secours lit l'incident que le répartiteur lui a confié (et seulement celui-là).
+    // Pompiers : on éteint (EXTINGUISHING) ; ambulance et police : on intervient (TREATING).
+    if (type != CIVIL && (emState == ON_MISSION || emState == EXTINGUISHING || emState == TREATING)) {
+        Incident* mission = sim.incidents.AssignedTo(v, i); // nullptr : pas (ou plus) de mission
+        // Si on est en route vers l'incident
+        if (emState == ON_MISSION && mission) {
+            target = mission->pos; // (un véhicule réaffecté en route change de destination)
+            if (Vector2Distance(pos, mission->pos) < ArrivalRadiusFor(mission->type)) {
+                emState = (type == FIRE) ? EXTINGUISHING : TREATING; // Arrivé ! On intervient.
+                mission->state = INCIDENT_ON_SCENE;
+                mission->arrivedTick = sim.tick;
+                RecordArrival(sim, i);
             }
-            // Si on est en train d'éteindre
-            if (emState == EXTINGUISHING) {
-                speed = Lerp(speed, 0.0f, 0.1f); // On s'arrête
-                if (fireActive) {
-                    actionTimer += dt; // On arrose pendant 3 secondes
-                    if (actionTimer > 3.0f) { fireActive = false; emState = RETURNING; target = homeEntry; actionTimer = 0; }
-                } else { emState = RETURNING; target = homeEntry; }
-                return; // On ne bouge plus pendant qu'on éteint
-            }
-    }
-    // --- GESTION DES MISSIONS (AMBULANCES) ---
-    if (type == AMBULANCE) {
-        if (emState == ON_MISSION) {
-            if (!accidentActive) { emState = RETURNING; target = homeEntry; } 
-            else if (Vector2Distance(pos, accidentPos) < 30.0f) emState = TREATING; // Arrivé ! On soigne.
+        } else if (emState == ON_MISSION && v.incident[i] >= 0) {
+            emState = RETURNING; target = homeEntry; v.incident[i] = -1; // Incident disparu, on rentre
         }
-        if (emState == TREATING) {
-            speed = Lerp(speed, 0.0f, 0.2f); // On s'arrête
-            if (accidentActive) {
-                actionTimer += dt; // On soigne pendant 3 secondes
-                if (actionTimer > 3.0f) { accidentActive = false; emState = RETURNING; target = homeEntry; actionTimer = 0; }
-            } else { emState = RETURNING; target = homeEntry; }
-            return; 
+        // Si on est en train d'intervenir
+        if (emState == EXTINGUISHING || emState == TREATING) {
+            speed = Lerp(speed, 0.0f, (type == FIRE) ? 0.1f : 0.2f); // On s'arrête
+            if (mission) {
+                actionTimer += dt; // On arrose / on soigne / on interroge...
+                if (actionTimer > WorkTimeFor(mission->type)) {
+                    mission->state = INCIDENT_RESOLVED; // Fermé par le répartiteur à la fin du pas
+                    emState = RETURNING; target = homeEntry; actionTimer = 0; v.incident[i] = -1;
+                }
+            } else { emState = RETURNING; target = homeEntry; actionTimer = 0; v.incident[i] = -1; }
+            return; // On ne bouge plus pendant qu'on intervient
         }
     }
     
@@ -158,43 +207,46 @@ void Car::Update(LightCycle cycle, const std::vector<Car*>& cars, bool isNight)
         if (Vector2Distance(pos, homeEntry) < 8.0f) {
             pos = homeEntry; emState = ON_MISSION;
             // Une fois sorti, on se place sur la bonne voie de la route la plus proche
-            float cx = GetSnapAxis(pos.x, vRoads); float cy = GetSnapAxis(pos.y, hRoads);
-            if (fabs(pos.x-cx) < fabs(pos.y-cy)) { dir=(pos.y<GetScreenHeight()/2)?DOWN:UP; pos.x=cx+((dir==DOWN)?LANE_NORMAL:-LANE_NORMAL); }
-            else { dir=(pos.x<GetScreenWidth()/2)?RIGHT:LEFT; pos.y=cy+((dir==RIGHT)?LANE_NORMAL:-LANE_NORMAL); }
+            float cx = vRoadIndex.Snap(pos.x); float cy = hRoadIndex.Snap(pos.y);
+            if (fabs(pos.x-cx) < fabs(pos.y-cy)) { dir=(pos.y<worldHeight/2)?DOWN:UP; pos.x=cx+((dir==DOWN)?LANE_NORMAL:-LANE_NORMAL); }
+            else { dir=(pos.x<worldWidth/2)?RIGHT:LEFT; pos.y=cy+((dir==RIGHT)?LANE_NORMAL:-LANE_NORMAL); }
         } else { Vector2 diff = Vector2Subtract(homeEntry, pos); pos = Vector2Add(pos, Vector2Scale(Vector2Normalize(diff), 2.5f)); }
         return;
     }
     // Logique pour rentrer se garer (DOCKING)
     if (emState == DOCKING) {
         Vector2 diff = Vector2Subtract(homeCenter, pos);
-        if (Vector2Length(diff) < 5.0f) active = false; // Garé ! On disparaît (active = false)
+        if (Vector2Length(diff) < 5.0f) active = 0; // Garé ! On disparaît (active = false)
         else pos = Vector2Add(pos, Vector2Scale(Vector2Normalize(diff), 2.5f));
         return; 
     }
     // Si on est proche de l'entrée au retour, on passe en mode DOCKING
     if (emState == RETURNING && Vector2Distance(pos, homeEntry) < 20) emState = DOCKING;
     
-    // Mise à jour de la cible (Target) si l'urgence se déplace ou change
-    if (type != CIVIL && emState == ON_MISSION) {
-            if (type == FIRE && fireActive) target = firePos;
-            else if (type == AMBULANCE && accidentActive) target = accidentPos;
-            else if (Vector2Distance(pos, target) < 30) { emState = RETURNING; target = homeEntry; }
+    // Sorti sans mission (bouton sans incident en attente) : arrivé devant le garage, on rentre
+    if (type != CIVIL && emState == ON_MISSION && v.incident[i] < 0 && Vector2Distance(pos, target) < 30) {
+        emState = RETURNING; target = homeEntry;
     }
 
     // --- NAVIGATION GPS ---
-    // On repère sur quelle route on est
-    float currentRoadX = GetSnapAxis(pos.x, vRoads);
-    float currentRoadY = GetSnapAxis(pos.y, hRoads);
-    // On vérifie si on est au milieu d'un carrefour
-    bool atIntersection = (fabs(pos.x - currentRoadX) < 20.0f && fabs(pos.y - currentRoadY) < 20.0f);
+    // On repère sur quelle route on est, et si on est au milieu d'un carrefour (index en O(1))
+    RoadLocation here = LocateOnRoads(pos, 20.0f);
+    float currentRoadX = here.roads.x;
+    float currentRoadY = here.roads.y;
+    bool atIntersection = here.atIntersection;
 
     if (atIntersection && turnCooldown <= 0.0f) {
         Dir newDir = dir;
         bool turnNeeded = false;
         
         // --- INTELLIGENCE DE DIRECTION ---
-        // Si on a une destination précise (Secours)
-        if (hasTarget || (type != CIVIL && emState != IDLE)) {
+        // Secours avec un itinéraire : on suit la liste des carrefours calculée par A*
+        bool routed = false;
+        if (type != CIVIL && sim.useRouting && v.hasRoute[i] && here.col >= 0 && here.row >= 0) {
+            routed = FollowRoute(v, i, roadGraph.NodeAt(here.col, here.row), target, newDir);
+        }
+        // Si on a une destination précise (Secours) mais pas (encore) d'itinéraire
+        if (!routed && (hasTarget || (type != CIVIL && emState != IDLE))) {
             float tDx = target.x - currentRoadX; float tDy = target.y - currentRoadY;
             // On décide de tourner si la cible n'est pas en face
             if (dir == LEFT || dir == RIGHT) { if (fabs(tDx) < 10.0f) { newDir = (target.y > pos.y) ? DOWN : UP; turnNeeded = true; } } 
@@ -208,12 +260,19 @@ void Car::Update(LightCycle cycle, const std::vector<Car*>& cars, bool isNight)
         // Si on est un Civil (Balade au hasard)
         else if (type == CIVIL) {
             // 25% de chance de tourner à chaque intersection
-            if (GetRandomValue(0, 100) < 25) { 
-                if (dir == UP || dir == DOWN) newDir = (GetRandomValue(0,1)) ? LEFT : RIGHT;
-                else newDir = (GetRandomValue(0,1)) ? UP : DOWN;
+            // (flux de hasard propre à cette voiture : ne dépend pas de l'ordre des threads)
+            unsigned int roll = sim.VehicleRandom(i);
+            bool sideChoice = (roll >> 16) & 1;
+            if ((roll & 0xFFFF) % 101 < 25) { 
+                if (dir == UP || dir == DOWN) newDir = sideChoice ? LEFT : RIGHT;
+                else newDir = sideChoice ? UP : DOWN;
             }
         }
 
+        // Jamais dans un tronçon fermé (carte d'un scénario)
+        int node = roadGraph.NodeAt(here.col, here.row);
+        if (newDir != NONE && !roadGraph.IsOpen(node, newDir)) newDir = OpenExit(node, newDir, dir);
+
         // Si on change de direction, on ajuste la position pour bien prendre le virage
         if (newDir != dir) {
             dir = newDir;
@@ -224,31 +283,53 @@ void Car::Update(LightCycle cycle, const std::vector<Car*>& cars, bool isNight)
         }
     }
 
+    // --- RUES COUPÉES (carte d'un scénario) ---
+    // Vérifié à chaque carrefour, même juste après un virage ou rangé sur le côté pour un
+    // secours (la voie de côté est hors du rayon de décision ci-dessus) : sinon on filerait
+    // tout droit dans le tronçon fermé.
+    if (!closedSegments.empty()) {
+        RoadLocation cross = atIntersection ? here : LocateOnRoads(pos, LANE_CIVIL_YIELD);
+        if (cross.atIntersection) {
+            int node = roadGraph.NodeAt(cross.col, cross.row);
+            if (!roadGraph.IsOpen(node, dir)) {
+                dir = OpenExit(node, dir, dir);
+                float offset = (dir == DOWN || dir == RIGHT) ? LANE_NORMAL : -LANE_NORMAL;
+                if (dir == UP || dir == DOWN) { pos.x = cross.roads.x + offset; pos.y = cross.roads.y; }
+                else { pos.x = cross.roads.x; pos.y = cross.roads.y + offset; }
+                currentRoadX = cross.roads.x; currentRoadY = cross.roads.y;
+                turnCooldown = 0.8f;
+            }
+        }
+    }
+
     float desiredSpeed = maxSpeed;
     bool hardStop = false; 
 
+    // --- RÈGLE : LIMITE DE VITESSE DE LA ROUTE (civils seulement, les secours ont la priorité) ---
+    if (type == CIVIL) {
+        float limit = RoadSpeedLimit(here, dir);
+        if (limit > 0 && limit < desiredSpeed) desiredSpeed = limit;
+    }
+
     // --- RÈGLE : LAISSER PASSER LES SECOURS ---
-    isYielding = false; 
+    isYielding = 0; 
     if (type == CIVIL) {
-        // On regarde s'il y a un véhicule d'urgence en mission pas loin
-        for(auto c : cars) {
-            if (c->type != CIVIL && c->emState == ON_MISSION && c->active) {
-                if (Vector2Distance(pos, c->pos) < 250.0f) { 
-                    isYielding = true; // On active le mode "Se garer"
-                }
-            }
-        }
+        // Y a-t-il un véhicule d'urgence en mission pas loin ? (champ calculé une fois par pas)
+        if (sim.yieldField.Contains(pos)) isYielding = 1; // On active le mode "Se garer"
     }
     if (isYielding) {
         desiredSpeed = 1.2f; // On ralentit pour se garer
+        counters.values[COUNTER_YIELDS]++;
     }
 
     // --- RÈGLE : FEUX TRICOLORES (Seulement pour Civils qui ne cèdent pas le passage) ---
     if (type == CIVIL && !isYielding) { 
         bool redLight = false;
-        // On vérifie si le feu est rouge pour nous
-        if ((dir == UP || dir == DOWN) && cycle != V_GREEN) redLight = true;
-        if ((dir == LEFT || dir == RIGHT) && cycle != H_GREEN) redLight = true;
+        // On vérifie si le feu du carrefour le plus proche est rouge pour nous
+        int lightNode = (here.col >= 0 && here.row >= 0) ? roadGraph.NodeAt(here.col, here.row) : -1;
+        LightCycle light = sim.signals.PhaseAt(lightNode);
+        if ((dir == UP || dir == DOWN) && light != V_GREEN) redLight = true;
+        if ((dir == LEFT || dir == RIGHT) && light != H_GREEN) redLight = true;
         
         if (redLight) {
             // Calcul de la distance jusqu'au feu
@@ -271,36 +352,47 @@ void Car::Update(LightCycle cycle, const std::vector<Car*>& cars, bool isNight)
     }
 
     // --- SYSTÈME ANTI-COLLISION ---
-    Rectangle mySensor = GetSensor(); // On récupère la zone devant nous
-    for(auto c : cars) {
-        if (c == this || !c->active) continue; // On ne se teste pas soi-même
-        if (type == CIVIL && isYielding && c->dir != dir) continue; // Si on se gare, on ignore ceux d'en face
-
-        // Si notre capteur touche une autre voiture
-        if (CheckCollisionRecs(mySensor, c->GetRect())) {
-            if (!isYielding) {
-                desiredSpeed = 0.0f; // On veut s'arrêter
-                // Si on est très près, FREINAGE D'URGENCE (Hard Stop)
-                if (Vector2Distance(pos, c->pos) < 55.0f) {
-                    hardStop = true;
-                    speed = 0.0f; 
-                } else if (Vector2Distance(pos, c->pos) < 80.0f) {
-                    hardStop = true; 
-                }
-            } else {
-                // Si on est en train de se garer, on freine aussi si on touche quelqu'un
-                if (Vector2Distance(pos, c->pos) < 35.0f) desiredSpeed = 0.0f;
+    Rectangle mySensor = GetCarSensor(pos, dir, speed, type); // On récupère la zone devant nous
+    // Notre capteur touche la voiture j
+    auto reactTo = [&](int j) {
+        if (!isYielding) {
+            desiredSpeed = 0.0f; // On veut s'arrêter
+            // Si on est très près, FREINAGE D'URGENCE (Hard Stop)
+            if (Vector2Distance(pos, otherPos[j]) < 55.0f) {
+                hardStop = true;
+                speed = 0.0f; 
+            } else if (Vector2Distance(pos, otherPos[j]) < 80.0f) {
+                hardStop = true; 
             }
+        } else {
+            // Si on est en train de se garer, on freine aussi si on touche quelqu'un
+            if (Vector2Distance(pos, otherPos[j]) < 35.0f) desiredSpeed = 0.0f;
         }
-    }
+    };
+    // Les voitures à tester sont mises de côté, puis testées par paquets (OverlapSensor, SIMD)
+    int candidates[SENSOR_BATCH];
+    int candidateCount = 0;
+    auto testCandidates = [&]() {
+        uint32_t hits = OverlapSensor(mySensor, otherPos, otherDir, candidates, candidateCount);
+        for (int k = 0; hits != 0; k++, hits >>= 1) {
+            if (hits & 1) reactTo(candidates[k]);
+        }
+        candidateCount = 0;
+    };
+    auto checkObstacle = [&](int j) {
+        if (j == i || !otherActive[j]) return; // On ne se teste pas soi-même
+        if (type == CIVIL && isYielding && otherDir[j] != dir) return; // Si on se gare, on ignore ceux d'en face
 
-    // --- APPLICATION DE LA VITESSE ---
-    if (hardStop || desiredSpeed == 0.0f) {
-        speed = Lerp(speed, 0.0f, 0.3f); // Freinage rapide
-        if (speed < 0.05f) speed = 0.0f; // Arrêt complet
-    } else {
-        speed = Lerp(speed, desiredSpeed, 0.05f); // Accélération douce
-    }
+        counters.values[COUNTER_COLLISION_TESTS]++;
+        candidates[candidateCount++] = j;
+        if (candidateCount == SENSOR_BATCH) testCandidates();
+    };
+    // Grâce à la grille, on ne teste que les voitures des cases touchées par le capteur
+    if (sim.useSpatialHash) sim.grid.Query(mySensor, checkObstacle);
+    else for(int j = 0; j < v.Size(); j++) checkObstacle(j);
+    if (candidateCount > 0) testCandidates();
+
+    if (hardStop) counters.values[COUNTER_HARD_STOPS]++;
 
     // --- MAINTIEN DE LA VOIE (LANE KEEPING) ---
     float offsetMagnitude = LANE_NORMAL;
@@ -318,106 +410,52 @@ void Car::Update(LightCycle cycle, const std::vector<Car*>& cars, bool isNight)
     float targetOffset = (dir == DOWN || dir == RIGHT) ? offsetMagnitude : -offsetMagnitude;
     if (invertSide) targetOffset = -targetOffset;
 
-    // --- MOUVEMENT PHYSIQUE ---
-    if (dir == UP)    pos.y -= speed;
-    if (dir == DOWN)  pos.y += speed;
-    if (dir == LEFT)  pos.x -= speed;
-    if (dir == RIGHT) pos.x += speed;
-
-    // Aimentation douce vers le centre de la voie (pour corriger les écarts)
-    float lockStrength = 0.15f; 
-    if (dir == UP || dir == DOWN) pos.x = Lerp(pos.x, currentRoadX + targetOffset, lockStrength);
-    else pos.y = Lerp(pos.y, currentRoadY + targetOffset, lockStrength);
-
-    // --- SUPPRESSION HORS ÉCRAN ---
-    if (!hasTarget) {
-        // Si on sort de l'écran très loin, on supprime la voiture pour libérer la mémoire
-        if (pos.x < SIDEBAR_WIDTH - 100 || pos.x > GetScreenWidth() + 100 || 
-            pos.y < -100 || pos.y > GetScreenHeight() + 100) active = false;
+    // --- CE QUE LE MOUVEMENT DOIT FAIRE (voir MoveVehicles) ---
+    sim.planSpeed[i] = (hardStop || desiredSpeed == 0.0f) ? -1.0f : desiredSpeed; // < 0 : freinage rapide
+    // Centre de la voie visée, sur l'axe en travers (aimantation douce)
+    sim.planLane[i] = ((dir == UP || dir == DOWN) ? currentRoadX : currentRoadY) + targetOffset;
+    sim.planFlags[i] = 0;
+}
+
+// --- APRÈS LE MOUVEMENT ---
+// Ce qui reste au cas par cas : les voitures sorties de la ville
+static void FinishMotion(VehicleStore& v, int i, Rectangle city) {
+    // --- SUPPRESSION HORS DE LA VILLE ---
+    Vector2& pos = v.pos[i];
+    Dir& dir = v.dir[i];
+    if (!v.hasTarget[i]) {
+        // Si on sort de la ville très loin, on supprime la voiture pour libérer la mémoire
+        if (pos.x < city.x - 100 || pos.x > city.x + city.width + 100 || 
+            pos.y < city.y - 100 || pos.y > city.y + city.height + 100) v.active[i] = 0;
     } else {
         // "Teleport" pour effet pac-man (si nécessaire) ou bloquer aux murs pour les secours
-            if(pos.x < SIDEBAR_WIDTH) { pos.x = SIDEBAR_WIDTH+2; dir=RIGHT; }
-            if(pos.x > GetScreenWidth()) { pos.x = GetScreenWidth()-2; dir=LEFT; }
-            if(pos.y < 0) { pos.y = 2; dir=DOWN; }
-            if(pos.y > GetScreenHeight()) { pos.y = GetScreenHeight()-2; dir=UP; }
+            if(pos.x < city.x) { pos.x = city.x+2; dir=RIGHT; }
+            if(pos.x > city.x + city.width) { pos.x = city.x + city.width-2; dir=LEFT; }
+            if(pos.y < city.y) { pos.y = city.y+2; dir=DOWN; }
+            if(pos.y > city.y + city.height) { pos.y = city.y + city.height-2; dir=UP; }
     }
 }
 
-// --- AFFICHAGE (DESSIN) ---
-void Car::Draw(bool isNight) {
-    // Choix de la couleur
-    Color c = BLUE;
-    if (type == POLICE) c = SKYBLUE;
-    else if (type == AMBULANCE) c = WHITE;
-    else if (type == FIRE) c = RED;
-    
-    Rectangle r = GetRect();
-    
-    // --- PHARES (HEADLIGHTS) SI NUIT ---
-    if (isNight && active) {
-        Color lightColor = Fade(YELLOW, 0.3f);
-        if (type == POLICE) lightColor = Fade(BLUE, 0.4f); // Phares bleutés pour la police
-        
-        float beamL = 150.0f; // Longueur du faisceau
-        float beamW = 40.0f;  // Largeur du faisceau
-        Vector2 p1, p2, p3;
-        
-        // Calcul du triangle de lumière selon la direction
-        if(dir == UP) {
-            p1 = {pos.x, pos.y - 15};
-            p2 = {pos.x - beamW, pos.y - beamL};
-            p3 = {pos.x + beamW, pos.y - beamL};
-        } else if(dir == DOWN) {
-            p1 = {pos.x, pos.y + 15};
-            p2 = {pos.x - beamW, pos.y + beamL};
-            p3 = {pos.x + beamW, pos.y + beamL};
-        } else if(dir == LEFT) {
-            p1 = {pos.x - 15, pos.y};
-            p2 = {pos.x - beamL, pos.y - beamW};
-            p3 = {pos.x - beamL, pos.y + beamW};
-        } else {
-            p1 = {pos.x + 15, pos.y};
-            p2 = {pos.x + beamL, pos.y - beamW};
-            p3 = {pos.x + beamL, pos.y + beamW};
+// --- MOUVEMENT PHYSIQUE (PAR PAQUETS) ---
+void MoveVehicles(Simulation& sim, int first, int count) {
+    VehicleStore& v = sim.vehicles;
+    Rectangle city = CityBounds();
+    const int block = 256;
+    uint8_t outside[block];
+    for (int start = first; start < first + count; start += block) {
+        int n = std::min(block, first + count - start);
+        // Vitesse, avance et maintien de la voie de "n" voitures d'un coup (motion_kernels.h)
+        IntegrateMotion(&v.pos[start], &v.speed[start], &v.dir[start], &sim.planSpeed[start], &sim.planLane[start],
+                        &sim.planFlags[start], n, city, outside);
+        for (int k = 0; k < n; k++) {
+            if (sim.planFlags[start + k] & MOTION_SKIP) continue;
+            if (outside[k]) FinishMotion(v, start + k, city);
         }
-        DrawTriangle(p1, p2, p3, lightColor);
-    }
-    // -----------------------------------
-
-    // Si on se range sur le côté, on dessine un cadre orange autour
-    if (isYielding) DrawRectangleLinesEx({r.x-2, r.y-2, r.width+4, r.height+4}, 1, ORANGE);
-
-    // Dessin de l'ombre portée (pour effet 3D)
-    DrawRectangle(r.x+3, r.y+3, r.width, r.height, Fade(BLACK, 0.3f)); 
-    // Dessin de la carrosserie
-    DrawRectangleRec(r, c);
-    DrawRectangleLinesEx(r, 1, BLACK); // Contour noir
-
-    // --- FEUX DE FREINAGE (STOP) ---
-    // Si on ralentit, on allume les feux rouges arrière
-    if (speed < maxSpeed * 0.8f) { 
-        if(dir==UP) DrawRectangle(r.x, r.y+r.height, r.width, 2, RED);
-        if(dir==DOWN) DrawRectangle(r.x, r.y-2, r.width, 2, RED);
-        if(dir==LEFT) DrawRectangle(r.x+r.width, r.y, 2, r.height, RED);
-        if(dir==RIGHT) DrawRectangle(r.x-2, r.y, 2, r.height, RED);
-    }
-
-    // --- GYROPHARES ET SIRÈNES (SECOURS) ---
-    if(type != CIVIL && (int)(GetTime()*15)%2==0 && emState != DOCKING) {
-        // Clignotement orange sur le toit
-        DrawCircleV(pos, 4, ORANGE);
-        // Onde de choc visuelle (cercle rouge qui s'agrandit)
-        DrawCircleLines(pos.x, pos.y, 20 + sin(GetTime()*10)*5, Fade(RED, 0.5f));
     }
+}
 
-    // --- ANIMATIONS SPÉCIALES ---
-    // Jet d'eau pour les pompiers
-    if (type == FIRE && emState == EXTINGUISHING) DrawLineEx(pos, firePos, 4, Fade(SKYBLUE, 0.7f));
-    // Croix verte clignotante pour l'ambulance qui soigne
-    if (type == AMBULANCE && emState == TREATING) {
-            if((int)(GetTime()*10)%2==0) {
-                DrawLine(pos.x-5, pos.y, pos.x+5, pos.y, GREEN);
-                DrawLine(pos.x, pos.y-5, pos.x, pos.y+5, GREEN);
-            }
-    }
-}
\ No newline at end of file
+// --- UNE VOITURE, DE A À Z ---
+void UpdateVehicle(Simulation& sim, int i, float dt, CarCounters& counters) {
+    PlanVehicle(sim, i, dt, counters);
+    MoveVehicles(sim, i, 1);
+}
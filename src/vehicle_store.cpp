@@ -0,0 +1,341 @@
+/**
+ * STOCKAGE DES VÉHICULES
+ * Tableaux contigus (un par information) réservés une seule fois,
+ * suppression par échange avec le dernier, et poignées stables.
+ */
+
+#include "../include/vehicle_store.h"
+#include "../include/state_file.h"
+
+VehicleStore::VehicleStore() {
+    count = 0;
+    capacity = 0;
+}
+
+void VehicleStore::Reserve(int newCapacity) {
+    if (newCapacity <= capacity) return;
+    capacity = newCapacity;
+
+    // Toutes les colonnes ont la taille maximum : Add() ne fait jamais d'allocation
+    pos.resize(capacity);
+    prevPos.resize(capacity);
+    dir.resize(capacity);
+    type.resize(capacity);
+    speed.resize(capacity);
+    maxSpeed.resize(capacity);
+    active.resize(capacity);
+    target.resize(capacity);
+    hasTarget.resize(capacity);
+    stuckTimer.resize(capacity);
+    turnCooldown.resize(capacity);
+    actionTimer.resize(capacity);
+    emState.resize(capacity);
+    homeCenter.resize(capacity);
+    homeEntry.resize(capacity);
+    dispatchTick.resize(capacity);
+    incident.resize(capacity);
+    route.resize(capacity);
+    routeStep.resize(capacity);
+    routeGoal.resize(capacity);
+    hasRoute.resize(capacity);
+    isYielding.resize(capacity);
+    signalNode.resize(capacity);
+
+    // Les nouvelles poignées sont empilées à l'envers pour sortir dans l'ordre 0, 1, 2...
+    int oldHandles = (int)slotOfHandle.size();
+    handleOfSlot.resize(capacity);
+    slotOfHandle.resize(capacity, 0);
+    generations.resize(capacity, 0);
+    freeHandles.reserve(capacity);
+    std::vector<uint32_t> fresh;
+    for (int h = capacity - 1; h >= oldHandles; h--) fresh.push_back((uint32_t)h);
+    freeHandles.insert(freeHandles.begin(), fresh.begin(), fresh.end());
+}
+
+int VehicleStore::Add(Type t) {
+    if (count >= capacity) return -1; // Plein : on refuse (pas d'allocation pendant le jeu)
+    int slot = count++;
+
+    // Valeurs de départ communes à toutes les voitures
+    type[slot] = t;
+    active[slot] = 1;
+    stuckTimer[slot] = 0;
+    turnCooldown[slot] = 0;
+    actionTimer[slot] = 0;
+    isYielding[slot] = 0; // Par défaut, on ne se gare pas sur le côté
+    signalNode[slot] = -1; // Pas encore compté à un carrefour
+
+    // Vitesse : Les secours vont beaucoup plus vite que les civils
+    maxSpeed[slot] = (t == CIVIL) ? 1.4f : 4.0f;
+    speed[slot] = maxSpeed[slot];
+
+    hasTarget[slot] = 0;
+    emState[slot] = IDLE; // État "Au repos"
+    target[slot] = { 0, 0 };
+    homeCenter[slot] = { 0, 0 };
+    homeEntry[slot] = { 0, 0 };
+    dispatchTick[slot] = 0;
+    incident[slot] = -1; // Aucune mission
+    route[slot].clear(); // On garde la place déjà réservée par un ancien occupant
+    routeStep[slot] = 0;
+    routeGoal[slot] = { 0, 0 };
+    hasRoute[slot] = 0;
+    pos[slot] = { 0, 0 };
+    prevPos[slot] = { 0, 0 };
+    dir[slot] = NONE;
+
+    // Nouvelle poignée pour ce véhicule
+    uint32_t h = freeHandles.back();
+    freeHandles.pop_back();
+    handleOfSlot[slot] = h;
+    slotOfHandle[h] = (uint32_t)slot;
+    return slot;
+}
+
+void VehicleStore::MoveSlot(int from, int to) {
+    pos[to] = pos[from];
+    prevPos[to] = prevPos[from];
+    dir[to] = dir[from];
+    type[to] = type[from];
+    speed[to] = speed[from];
+    maxSpeed[to] = maxSpeed[from];
+    active[to] = active[from];
+    target[to] = target[from];
+    hasTarget[to] = hasTarget[from];
+    stuckTimer[to] = stuckTimer[from];
+    turnCooldown[to] = turnCooldown[from];
+    actionTimer[to] = actionTimer[from];
+    emState[to] = emState[from];
+    homeCenter[to] = homeCenter[from];
+    homeEntry[to] = homeEntry[from];
+    dispatchTick[to] = dispatchTick[from];
+    incident[to] = incident[from];
+    route[to].swap(route[from]); // Échange : la mémoire de l'ancienne liste sera réutilisée
+    routeStep[to] = routeStep[from];
+    routeGoal[to] = routeGoal[from];
+    hasRoute[to] = hasRoute[from];
+    isYielding[to] = isYielding[from];
+    signalNode[to] = signalNode[from];
+
+    // La poignée suit le véhicule dans sa nouvelle case
+    handleOfSlot[to] = handleOfSlot[from];
+    slotOfHandle[handleOfSlot[to]] = (uint32_t)to;
+}
+
+void VehicleStore::RemoveAt(int slot) {
+    if (slot < 0 || slot >= count) return;
+
+    // La poignée du véhicule supprimé devient invalide (nouvelle génération) et libre
+    uint32_t h = handleOfSlot[slot];
+    generations[h]++;
+    freeHandles.push_back(h);
+
+    // La dernière voiture vient boucher le trou
+    int last = count - 1;
+    if (slot != last) MoveSlot(last, slot);
+    count--;
+}
+
+// On parcourt à l'envers : la voiture qui vient boucher un trou a déjà été vérifiée
+int VehicleStore::RemoveInactive() {
+    int removed = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        if (!active[i]) { RemoveAt(i); removed++; }
+    }
+    return removed;
+}
+
+void VehicleStore::Clear() {
+    while (count > 0) RemoveAt(count - 1);
+}
+
+VehicleHandle VehicleStore::HandleAt(int slot) const {
+    if (slot < 0 || slot >= count) return INVALID_VEHICLE;
+    uint32_t h = handleOfSlot[slot];
+    return { h, generations[h] };
+}
+
+int VehicleStore::SlotOf(VehicleHandle handle) const {
+    if (handle.index >= generations.size()) return -1;
+    if (generations[handle.index] != handle.generation) return -1; // Véhicule déjà supprimé
+    int slot = (int)slotOfHandle[handle.index];
+    if (slot >= count || handleOfSlot[slot] != handle.index) return -1;
+    return slot;
+}
+
+// --- SAUVEGARDE ---
+// Chaque colonne est écrite d'un bloc (les Size() premières cases). Les itinéraires
+// (une liste par véhicule) sont mis bout à bout : longueurs, puis tous les carrefours.
+void VehicleStore::Save(StateWriter& out) const {
+    out.Section("VEHI");
+    out.Value(capacity);
+    out.Value(count);
+    size_t n = (size_t)count;
+    out.Column(pos, n);
+    out.Column(prevPos, n);
+    out.Column(dir, n);
+    out.Column(type, n);
+    out.Column(speed, n);
+    out.Column(maxSpeed, n);
+    out.Column(active, n);
+    out.Column(target, n);
+    out.Column(hasTarget, n);
+    out.Column(stuckTimer, n);
+    out.Column(turnCooldown, n);
+    out.Column(actionTimer, n);
+    out.Column(emState, n);
+    out.Column(homeCenter, n);
+    out.Column(homeEntry, n);
+    out.Column(dispatchTick, n);
+    out.Column(incident, n);
+    out.Column(routeStep, n);
+    out.Column(routeGoal, n);
+    out.Column(hasRoute, n);
+    out.Column(isYielding, n);
+    out.Column(signalNode, n);
+
+    std::vector<uint32_t> lengths(n);
+    std::vector<int> nodes;
+    for (size_t i = 0; i < n; i++) {
+        lengths[i] = (uint32_t)route[i].size();
+        nodes.insert(nodes.end(), route[i].begin(), route[i].end());
+    }
+    out.Vector(lengths);
+    out.Vector(nodes);
+
+    // Poignées : celles des véhicules, les générations et la pile des libres (même ordre de réutilisation)
+    out.Column(handleOfSlot, n);
+    out.Column(generations, (size_t)capacity);
+    out.Vector(freeHandles);
+}
+
+bool VehicleStore::Load(StateReader& in) {
+    int savedCapacity = 0, savedCount = 0;
+    in.Section("VEHI");
+    in.Value(savedCapacity);
+    in.Value(savedCount);
+    if (!in.Ok()) return false;
+    // La colonne des générations fait savedCapacity cases : une place plus grande que le fichier est impossible
+    if (savedCount < 0 || savedCount > savedCapacity || (uint64_t)savedCapacity * sizeof(uint32_t) > in.Remaining()) {
+        return in.Fail("nombre de vehicules impossible");
+    }
+    Reserve(savedCapacity); // Rien à faire si la place réservée suffit déjà
+
+    count = savedCount;
+    size_t n = (size_t)count;
+    in.Column(pos, n);
+    in.Column(prevPos, n);
+    in.Column(dir, n);
+    in.Column(type, n);
+    in.Column(speed, n);
+    in.Column(maxSpeed, n);
+    in.Column(active, n);
+    in.Column(target, n);
+    in.Column(hasTarget, n);
+    in.Column(stuckTimer, n);
+    in.Column(turnCooldown, n);
+    in.Column(actionTimer, n);
+    in.Column(emState, n);
+    in.Column(homeCenter, n);
+    in.Column(homeEntry, n);
+    in.Column(dispatchTick, n);
+    in.Column(incident, n);
+    in.Column(routeStep, n);
+    in.Column(routeGoal, n);
+    in.Column(hasRoute, n);
+    in.Column(isYielding, n);
+    in.Column(signalNode, n);
+
+    std::vector<uint32_t> lengths;
+    std::vector<int> nodes;
+    in.Vector(lengths);
+    in.Vector(nodes);
+    if (in.Ok() && lengths.size() != n) return in.Fail("itineraires incoherents");
+    size_t next = 0;
+    for (size_t i = 0; i < n && in.Ok(); i++) {
+        if (lengths[i] > nodes.size() - next) return in.Fail("itineraires incoherents");
+        route[i].assign(nodes.begin() + next, nodes.begin() + next + lengths[i]);
+        next += lengths[i];
+    }
+
+    // Poignées. Si la place réservée ici est plus grande que dans la sauvegarde, les poignées
+    // en plus restent au fond de la pile (comme Reserve) : elles ne servent qu'après les autres.
+    std::vector<uint32_t> savedFree;
+    in.Column(handleOfSlot, n);
+    in.Column(generations, (size_t)savedCapacity);
+    in.Vector(savedFree);
+    if (!in.Ok()) return false;
+    for (int h = savedCapacity; h < capacity; h++) generations[h] = 0;
+    freeHandles.clear();
+    for (int h = capacity - 1; h >= savedCapacity; h--) freeHandles.push_back((uint32_t)h);
+    for (uint32_t h : savedFree) {
+        if (h >= (uint32_t)savedCapacity) return in.Fail("poignee impossible");
+        freeHandles.push_back(h);
+    }
+    for (int slot = 0; slot < count; slot++) {
+        if (handleOfSlot[slot] >= (uint32_t)savedCapacity) return in.Fail("poignee impossible");
+        slotOfHandle[handleOfSlot[slot]] = (uint32_t)slot;
+    }
+    return true;
+}
+
+bool VehicleStore::Check(StateReader& in) const {
+    int savedCapacity = 0, savedCount = 0;
+    in.Section("VEHI");
+    in.Value(savedCapacity);
+    in.Value(savedCount);
+    if (!in.Ok()) return false;
+    if (savedCount < 0 || savedCount > savedCapacity || (uint64_t)savedCapacity * sizeof(uint32_t) > in.Remaining()) {
+        return in.Fail("nombre de vehicules impossible");
+    }
+
+    // Mêmes colonnes que Load, dans le même ordre : seules leurs tailles comptent ici
+    size_t n = (size_t)savedCount;
+    in.SkipColumn(pos, n);
+    in.SkipColumn(prevPos, n);
+    in.SkipColumn(dir, n);
+    in.SkipColumn(type, n);
+    in.SkipColumn(speed, n);
+    in.SkipColumn(maxSpeed, n);
+    in.SkipColumn(active, n);
+    in.SkipColumn(target, n);
+    in.SkipColumn(hasTarget, n);
+    in.SkipColumn(stuckTimer, n);
+    in.SkipColumn(turnCooldown, n);
+    in.SkipColumn(actionTimer, n);
+    in.SkipColumn(emState, n);
+    in.SkipColumn(homeCenter, n);
+    in.SkipColumn(homeEntry, n);
+    in.SkipColumn(dispatchTick, n);
+    in.SkipColumn(incident, n);
+    in.SkipColumn(routeStep, n);
+    in.SkipColumn(routeGoal, n);
+    in.SkipColumn(hasRoute, n);
+    in.SkipColumn(isYielding, n);
+    in.SkipColumn(signalNode, n);
+
+    std::vector<uint32_t> lengths;
+    std::vector<int> nodes;
+    in.Vector(lengths);
+    in.Vector(nodes);
+    if (in.Ok() && lengths.size() != n) return in.Fail("itineraires incoherents");
+    size_t next = 0;
+    for (size_t i = 0; i < n && in.Ok(); i++) {
+        if (lengths[i] > nodes.size() - next) return in.Fail("itineraires incoherents");
+        next += lengths[i];
+    }
+
+    std::vector<uint32_t> slotHandles, savedFree;
+    in.Vector(slotHandles);
+    in.SkipColumn(generations, (size_t)savedCapacity);
+    in.Vector(savedFree);
+    if (!in.Ok()) return false;
+    if (slotHandles.size() != n) return in.Fail("colonne de taille inattendue");
+    for (uint32_t h : savedFree) {
+        if (h >= (uint32_t)savedCapacity) return in.Fail("poignee impossible");
+    }
+    for (uint32_t h : slotHandles) {
+        if (h >= (uint32_t)savedCapacity) return in.Fail("poignee impossible");
+    }
+    return true;
+}
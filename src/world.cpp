@@ -7,12 +7,24 @@
  */
 
 #include "../include/world.h"
+#include "../include/road_graph.h"
+#include "../include/state_file.h"
+#include <algorithm>
 
 // --- VARIABLES GLOBALES ---
 // Ce sont les conteneurs qui stockent la structure de notre ville.
 std::vector<float> vRoads;       // Liste des positions X des routes verticales
 std::vector<float> hRoads;       // Liste des positions Y des routes horizontales
 std::vector<Building> buildings; // Liste des bâtiments
+std::vector<float> vRoadLimits;  // Limite de vitesse de chaque route verticale (0 = aucune)
+std::vector<float> hRoadLimits;  // Limite de vitesse de chaque route horizontale
+std::vector<uint8_t> closedSegments; // Tronçons fermés (vide = tout est ouvert)
+std::vector<Vector2> fireSites;      // Lieux d'incendie possibles (BuildFireSites)
+float worldWidth = INITIAL_SCREEN_WIDTH;   // Largeur du monde
+float worldHeight = INITIAL_SCREEN_HEIGHT; // Hauteur du monde
+int worldVersion = 0;                      // Version de la carte
+RoadAxisIndex vRoadIndex; // Index des routes verticales
+RoadAxisIndex hRoadIndex; // Index des routes horizontales
 
 // --- FONCTION "AIMANT" (SNAP) ---
 // Cette fonction prend une position (val) et cherche dans une liste (axes)
@@ -30,46 +42,179 @@ float GetSnapAxis(float val, const std::vector<float>& axes) {
     return best;
 }
 
-// --- DESSIN DE LIGNE POINTILLÉE ---
-// Raylib ne fait pas ça par défaut, donc on le fait à la main.
-// On dessine de petits segments les uns à la suite des autres avec des trous.
-void DrawDashedLine(Vector2 start, Vector2 end, float thick, Color color) {
-    Vector2 diff = Vector2Subtract(end, start);
-    float length = Vector2Length(diff);
-    Vector2 dir = Vector2Normalize(diff);
-    
-    // On avance de 30 pixels à chaque fois
-    for (float i = 0; i < length; i += 30) {
-        // Point de début du tiret
-        Vector2 p1 = Vector2Add(start, Vector2Scale(dir, i));
-        // Point de fin du tiret (longueur 15)
-        Vector2 p2 = Vector2Add(start, Vector2Scale(dir, fminf(i + 15, length)));
-        
-        DrawLineEx(p1, p2, thick, color);
+// --- INDEX DES ROUTES ---
+RoadAxisIndex::RoadAxisIndex() : uniform(false), first(0), invSpacing(0) {}
+
+void RoadAxisIndex::Build(const std::vector<float>& roads) {
+    axes = roads;
+    first = axes.empty() ? 0 : axes[0];
+    uniform = false;
+    invSpacing = 0;
+    if (axes.size() < 2) return;
+
+    // Les routes sont-elles également espacées ? (à un millième près, à cause des arrondis)
+    float spacing = (axes.back() - axes[0]) / (axes.size() - 1);
+    if (spacing <= 0) return;
+    uniform = true;
+    for (size_t k = 1; k < axes.size(); k++) {
+        if (fabs((axes[k] - axes[k-1]) - spacing) > spacing * 0.001f) { uniform = false; break; }
+    }
+    invSpacing = 1.0f / spacing;
+}
+
+int RoadAxisIndex::Estimate(float val) const {
+    int n = (int)axes.size();
+    if (uniform) {
+        // Calcul direct : (val - première route) / espacement
+        float f = (val - first) * invSpacing;
+        if (!(f >= 0)) return 0;           // Avant la première route (ou valeur invalide)
+        if (f >= (float)(n - 1)) return n - 1;
+        return (int)f;
+    }
+    // Espacement irrégulier : recherche dichotomique
+    int k = (int)(std::upper_bound(axes.begin(), axes.end(), val) - axes.begin()) - 1;
+    return (k < 0) ? 0 : k;
+}
+
+int RoadAxisIndex::Nearest(float val) const {
+    int n = (int)axes.size();
+    if (n == 0) return -1;
+    // L'estimation peut se tromper d'une route (arrondis) : on départage les voisines
+    // dans l'ordre de la liste, exactement comme le parcours complet de GetSnapAxis
+    int k = Estimate(val);
+    int from = std::max(k - 1, 0);
+    int to = std::min(k + 2, n - 1);
+    int best = from;
+    float minD = fabs(val - axes[from]);
+    for (int j = from + 1; j <= to; j++) {
+        float d = fabs(val - axes[j]);
+        if (d < minD) { minD = d; best = j; }
+    }
+    return best;
+}
+
+float RoadAxisIndex::Snap(float val) const {
+    int k = Nearest(val);
+    return (k < 0) ? val : axes[k];
+}
+
+int RoadAxisIndex::Segment(float val) const {
+    int n = (int)axes.size();
+    if (n == 0) return 0;
+    int k = Estimate(val);
+    // On corrige l'estimation pour avoir exactement "nombre de routes <= val"
+    while (k > 0 && axes[k] > val) k--;
+    while (k < n && axes[k] <= val) k++;
+    return k;
+}
+
+RoadLocation LocateOnRoads(Vector2 pos, float radius) {
+    RoadLocation loc;
+    loc.col = vRoadIndex.Nearest(pos.x);
+    loc.row = hRoadIndex.Nearest(pos.y);
+    loc.roads = { vRoadIndex.Snap(pos.x), hRoadIndex.Snap(pos.y) };
+    loc.atIntersection = (loc.col >= 0 && loc.row >= 0 &&
+                          fabs(pos.x - loc.roads.x) < radius && fabs(pos.y - loc.roads.y) < radius);
+    return loc;
+}
+
+float RoadSpeedLimit(const RoadLocation& here, Dir d) {
+    if (d == UP || d == DOWN) return (here.col >= 0 && here.col < (int)vRoadLimits.size()) ? vRoadLimits[here.col] : 0.0f;
+    if (d == LEFT || d == RIGHT) return (here.row >= 0 && here.row < (int)hRoadLimits.size()) ? hRoadLimits[here.row] : 0.0f;
+    return 0.0f;
+}
+
+bool OnClosedSegment(Vector2 pos, bool vertical) {
+    if (closedSegments.empty()) return false;
+    int V = (int)vRoads.size();
+    int H = (int)hRoads.size();
+    if (vertical) {
+        // Tronçon entre les routes horizontales k-1 et k
+        int col = vRoadIndex.Nearest(pos.x);
+        int k = hRoadIndex.Segment(pos.y);
+        return col >= 0 && k > 0 && k < H && (closedSegments[(size_t)(k - 1) * V + col] & CLOSED_DOWN);
     }
+    int row = hRoadIndex.Nearest(pos.y);
+    int k = vRoadIndex.Segment(pos.x);
+    return row >= 0 && k > 0 && k < V && (closedSegments[(size_t)row * V + k - 1] & CLOSED_RIGHT);
 }
 
 // --- GÉNÉRATEUR D'URGENCE ---
 // Choisit une intersection au hasard sur la carte.
 // C'est utilisé pour dire "Le feu a démarré ICI".
-Vector2 GetRandomRoadTarget() {
+Vector2 GetRandomRoadTarget(Random& rng) {
     if(vRoads.empty() || hRoads.empty()) return {0,0};
     
-    int rV = GetRandomValue(0, vRoads.size()-1); // Une route verticale au hasard
-    int rH = GetRandomValue(0, hRoads.size()-1); // Une route horizontale au hasard
+    int rV = rng.Range(0, vRoads.size()-1); // Une route verticale au hasard
+    int rH = rng.Range(0, hRoads.size()-1); // Une route horizontale au hasard
     
     return { vRoads[rV], hRoads[rH] }; // Le croisement des deux
 }
 
+Vector2 GetRandomRoadOrigin(Random& rng, Dir& dir) {
+    dir = NONE;
+    if(vRoads.size() < 2 || hRoads.size() < 2) return {0,0};
+
+    // 50% sur une route verticale, entre deux routes horizontales qui se suivent
+    if (rng.Range(0, 1) == 0) {
+        int r = rng.Range(0, vRoads.size()-1);
+        int b = rng.Range(0, hRoads.size()-2);
+        dir = (rng.Range(0, 1) == 0) ? DOWN : UP;
+        return { vRoads[r] + ((dir==DOWN)?LANE_NORMAL:-LANE_NORMAL), (hRoads[b] + hRoads[b+1]) / 2 };
+    }
+    // Sinon sur une route horizontale, entre deux routes verticales
+    int r = rng.Range(0, hRoads.size()-1);
+    int b = rng.Range(0, vRoads.size()-2);
+    dir = (rng.Range(0, 1) == 0) ? RIGHT : LEFT;
+    return { (vRoads[b] + vRoads[b+1]) / 2, hRoads[r] + ((dir==RIGHT)?LANE_NORMAL:-LANE_NORMAL) };
+}
+
+Rectangle CityBounds() {
+    return { (float)SIDEBAR_WIDTH, 0, worldWidth - SIDEBAR_WIDTH, worldHeight };
+}
+
+// Ville de taille fixe en pâtés de maisons : RecalculateGrid en retrouve exactement cols x rows
+void BuildCity(int cols, int rows) {
+    if (cols < 2) cols = 2;
+    if (rows < 2) rows = 2;
+    RecalculateGrid(SIDEBAR_WIDTH + (int)(cols * TARGET_BLOCK_SIZE), (int)(rows * TARGET_BLOCK_SIZE));
+}
+
+// --- BÂTIMENTS DE SECOURS ---
+Building MakeStation(Type type, Vector2 center, const char* label) {
+    float bSize = 50; // Taille d'un bâtiment
+    Color color = (type == AMBULANCE) ? WHITE : (type == FIRE) ? RED : BLUE;
+
+    // Sortie du garage (Entry Point) : le point de la route la plus proche du centre du bâtiment
+    float cx = vRoadIndex.Snap(center.x);
+    float cy = hRoadIndex.Snap(center.y);
+    // On choisit l'axe le plus proche (X ou Y)
+    Vector2 entry = (fabs(center.x - cx) < fabs(center.y - cy)) ? Vector2{ cx, center.y } : Vector2{ center.x, cy };
+
+    return { { center.x - bSize/2, center.y - bSize/2, bSize, bSize }, // Le rectangle physique
+             type, color, label, entry, center };
+}
+
+void RebuildRoadNetwork() {
+    worldVersion++;
+    // Index pour retrouver la route la plus proche en temps constant
+    vRoadIndex.Build(vRoads);
+    hRoadIndex.Build(hRoads);
+    // Graphe des carrefours pour le calcul d'itinéraire des secours (sans les tronçons fermés)
+    roadGraph.Build(vRoads, hRoads, closedSegments);
+}
+
 // --- L'ARCHITECTE (CONSTRUCTION DE LA VILLE) ---
-// Cette fonction vide la carte et recalcule tout selon la taille de la fenêtre.
-void RecalculateGrid() {
+// Cette fonction vide la carte et recalcule tout selon la taille du monde (w, h).
+void RecalculateGrid(int w, int h) {
     // 1. On efface tout
     vRoads.clear(); hRoads.clear();
     buildings.clear();
+    closedSegments.clear(); // Ville procédurale : pas d'impasse
+    fireSites.clear();
 
-    int w = GetScreenWidth();
-    int h = GetScreenHeight();
+    worldWidth = (float)w;
+    worldHeight = (float)h;
     
     // 2. On calcule combien de routes on peut mettre
     // On enlève la largeur du menu de gauche (SIDEBAR_WIDTH)
@@ -86,46 +231,146 @@ void RecalculateGrid() {
     for(int i=0; i<cols; i++) vRoads.push_back(SIDEBAR_WIDTH + spaceX * i + spaceX/2);
     for(int i=0; i<rows; i++) hRoads.push_back(spaceY * i + spaceY/2);
 
+    // Pas de limite de vitesse particulière
+    vRoadLimits.assign(vRoads.size(), 0.0f);
+    hRoadLimits.assign(hRoads.size(), 0.0f);
+
+    // Index des routes, graphe routier, version de la carte
+    RebuildRoadNetwork();
+
     if (vRoads.empty() || hRoads.empty()) return;
 
     // 4. On place les bâtiments (Hôpital, Police, Pompiers)
-    float bSize = 50; // Taille d'un bâtiment
     int lastV = vRoads.size() - 1;
     int lastH = hRoads.size() - 1;
 
-    // Petite fonction locale pour trouver où est la sortie du garage (Entry Point)
-    // Elle cherche le point de la route le plus proche du centre du bâtiment.
-    auto GetEntry = [](Vector2 center) -> Vector2 {
-        float cx = GetSnapAxis(center.x, vRoads);
-        float cy = GetSnapAxis(center.y, hRoads);
-        // On choisit l'axe le plus proche (X ou Y)
-        if (fabs(center.x - cx) < fabs(center.y - cy)) return {cx, center.y};
-        else return {center.x, cy};
-    };
-
     // -- HÔPITAL (Coin Haut-Gauche) --
     // On le place entre le bord gauche et la première route
     Vector2 posH = { (SIDEBAR_WIDTH + vRoads[0]) / 2.0f, (0 + hRoads[0]) / 2.0f };
-    buildings.push_back({ 
-        {posH.x - bSize/2, posH.y - bSize/2, bSize, bSize}, // Le rectangle physique
-        AMBULANCE, WHITE, "HOPITAL", 
-        GetEntry(posH), // Point de sortie sur la route
-        posH // Centre
-    });
+    buildings.push_back(MakeStation(AMBULANCE, posH, "HOPITAL"));
 
     // -- CASERNE POMPIERS (Coin Haut-Droit) --
     Vector2 posF = { (vRoads[lastV] + w) / 2.0f, (0 + hRoads[0]) / 2.0f };
-    buildings.push_back({ 
-        {posF.x - bSize/2, posF.y - bSize/2, bSize, bSize}, 
-        FIRE, RED, "CASERNE", 
-        GetEntry(posF), posF 
-    });
+    buildings.push_back(MakeStation(FIRE, posF, "CASERNE"));
 
     // -- POLICE (Coin Bas-Droit) --
     Vector2 posP = { (vRoads[lastV] + w) / 2.0f, (hRoads[lastH] + h) / 2.0f };
-    buildings.push_back({ 
-        {posP.x - bSize/2, posP.y - bSize/2, bSize, bSize}, 
-        POLICE, BLUE, "POLICE", 
-        GetEntry(posP), posP 
-    });
-}
\ No newline at end of file
+    buildings.push_back(MakeStation(POLICE, posP, "POLICE"));
+
+    // 5. Les lieux d'incendie possibles (à côté des bâtiments, jamais dessus)
+    BuildFireSites();
+}
+
+// --- LIEUX D'INCENDIE ---
+// L'ancienne recherche tirait un pâté de maisons et un coin au hasard, jusqu'à 10 fois, en
+// rejetant les coins trop petits ou posés sur un bâtiment. Ici, tous les coins valables
+// sont rangés une fois pour toutes : un tirage dans la table suffit, sans jamais échouer.
+void BuildFireSites() {
+    fireSites.clear();
+    int cols = (int)vRoads.size();
+    int rows = (int)hRoads.size();
+    if (cols == 0 || rows == 0) return;
+    fireSites.reserve((size_t)(cols + 1) * (rows + 1) * 4);
+
+    const float pad = 20.0f; // Distance du coin aux bords du pâté
+    for (int row = 0; row <= rows; row++) {
+        // Limites d'un bloc de maisons entre les routes (ou le bord de la ville)
+        float minY = (row == 0) ? 0 : hRoads[row-1] + ROAD_WIDTH/2;
+        float maxY = (row == rows) ? worldHeight : hRoads[row] - ROAD_WIDTH/2;
+        for (int col = 0; col <= cols; col++) {
+            float minX = (col == 0) ? SIDEBAR_WIDTH : vRoads[col-1] + ROAD_WIDTH/2;
+            float maxX = (col == cols) ? worldWidth : vRoads[col] - ROAD_WIDTH/2;
+            if (maxX - minX <= 20 || maxY - minY <= 20) continue; // Bloc trop petit
+
+            const Vector2 corners[4] = { { minX + pad, minY + pad }, { maxX - pad, minY + pad },
+                                         { minX + pad, maxY - pad }, { maxX - pad, maxY - pad } };
+            for (Vector2 c : corners) {
+                bool onBuilding = false;
+                for (const Building& b : buildings) {
+                    if (CheckCollisionPointRec(c, b.rect)) { onBuilding = true; break; }
+                }
+                if (!onBuilding) fireSites.push_back(c);
+            }
+        }
+    }
+}
+
+// --- SAUVEGARDE DE LA VILLE ---
+void SaveWorld(StateWriter& out) {
+    out.Section("WRLD");
+    out.Value(worldWidth);
+    out.Value(worldHeight);
+    out.Vector(vRoads);
+    out.Vector(hRoads);
+    out.Vector(vRoadLimits);
+    out.Vector(hRoadLimits);
+    out.Vector(closedSegments);
+    out.Value<uint64_t>(buildings.size());
+    for (const Building& b : buildings) {
+        out.Value(b.rect);
+        out.Value(b.type);
+        out.Value(b.color);
+        out.Text(b.label);
+        out.Value(b.entryPoint);
+        out.Value(b.center);
+    }
+}
+
+// La ville lue dans le fichier, avant de remplacer la ville actuelle
+struct SavedWorld {
+    float w = 0, h = 0;
+    std::vector<float> v, hr, vLimits, hLimits;
+    std::vector<uint8_t> closed;
+    std::vector<Building> b;
+};
+
+static bool ReadWorld(StateReader& in, SavedWorld& d) {
+    uint64_t count = 0;
+    in.Section("WRLD");
+    in.Value(d.w);
+    in.Value(d.h);
+    in.Vector(d.v);
+    in.Vector(d.hr);
+    in.Vector(d.vLimits);
+    in.Vector(d.hLimits);
+    in.Vector(d.closed);
+    in.Count(count, sizeof(Rectangle));
+    for (uint64_t k = 0; k < count && in.Ok(); k++) {
+        Building x;
+        in.Value(x.rect);
+        in.Value(x.type);
+        in.Value(x.color);
+        in.Text(x.label);
+        in.Value(x.entryPoint);
+        in.Value(x.center);
+        d.b.push_back(x);
+    }
+    if (!in.Ok()) return false;
+    if (!std::is_sorted(d.v.begin(), d.v.end()) || !std::is_sorted(d.hr.begin(), d.hr.end())) return in.Fail("routes dans le desordre");
+    if (d.vLimits.size() != d.v.size() || d.hLimits.size() != d.hr.size()) return in.Fail("limites de vitesse incompletes");
+    if (!d.closed.empty() && d.closed.size() != d.v.size() * d.hr.size()) return in.Fail("troncons fermes incomplets");
+    return true;
+}
+
+bool CheckWorld(StateReader& in) {
+    SavedWorld d;
+    return ReadWorld(in, d);
+}
+
+bool LoadWorld(StateReader& in) {
+    SavedWorld d;
+    if (!ReadWorld(in, d)) return false;
+
+    // Même fin que RecalculateGrid : la ville change d'un coup
+    worldWidth = d.w;
+    worldHeight = d.h;
+    vRoads.swap(d.v);
+    hRoads.swap(d.hr);
+    vRoadLimits.swap(d.vLimits);
+    hRoadLimits.swap(d.hLimits);
+    closedSegments.swap(d.closed);
+    buildings.swap(d.b);
+    RebuildRoadNetwork();
+    BuildFireSites();
+    return true;
+}
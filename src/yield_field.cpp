@@ -0,0 +1,58 @@
+/**
+ * CHAMP DE PROXIMITÉ DES SECOURS
+ * Calculé une fois par pas pour que les civils sachent en O(1) s'ils doivent
+ * se ranger sur le côté (au lieu de chercher les secours parmi toutes les voitures).
+ */
+
+#include "../include/yield_field.h"
+#include "../include/vehicle_store.h"
+#include <algorithm>
+
+YieldField::YieldField() {
+    reach = { 0, 0, 0, 0 };
+}
+
+// On colle les numéros de colonne et de ligne (32 bits chacun) dans une seule clé 64 bits
+uint64_t YieldField::Key(int cx, int cy) {
+    return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+}
+
+void YieldField::Build(const VehicleStore& v) {
+    units.clear(); // Garde la place : pas d'allocation une fois le nombre de secours atteint
+
+    // 1. Les secours en mission (en général très peu) et leur case
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (int i = 0; i < v.Size(); i++) {
+        if (!v.active[i] || v.type[i] == CIVIL || v.emState[i] != ON_MISSION) continue;
+        Vector2 p = v.pos[i];
+        units.push_back({ Key((int)floorf(p.x / CELL_SIZE), (int)floorf(p.y / CELL_SIZE)), p });
+        if (units.size() == 1) { minX = maxX = p.x; minY = maxY = p.y; }
+        minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+    }
+    if (units.empty()) return; // Contains() répondra "non" tout de suite
+
+    // 2. Triés par case : les secours d'une même case se suivent (à case égale, ordre du stockage)
+    std::stable_sort(units.begin(), units.end(), [](const Unit& a, const Unit& b) { return a.cell < b.cell; });
+    reach = { minX - YIELD_RADIUS, minY - YIELD_RADIUS, maxX - minX + 2 * YIELD_RADIUS, maxY - minY + 2 * YIELD_RADIUS };
+}
+
+bool YieldField::Contains(Vector2 p) const {
+    if (units.empty()) return false;
+    if (p.x < reach.x || p.x > reach.x + reach.width || p.y < reach.y || p.y > reach.y + reach.height) return false;
+
+    // Un secours à moins de YIELD_RADIUS est forcément dans une des 3 x 3 cases autour de p
+    int cx = (int)floorf(p.x / CELL_SIZE);
+    int cy = (int)floorf(p.y / CELL_SIZE);
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            uint64_t key = Key(cx + dx, cy + dy);
+            auto it = std::lower_bound(units.begin(), units.end(), key,
+                                       [](const Unit& u, uint64_t k) { return u.cell < k; });
+            for (; it != units.end() && it->cell == key; ++it) {
+                if (Vector2Distance(p, it->pos) < YIELD_RADIUS) return true;
+            }
+        }
+    }
+    return false;
+}